@@ -0,0 +1,61 @@
+#include "bench.hpp"
+#include <vector>
+#include "../includes/map.hpp"
+#include "../includes/aggregate_map.hpp"
+
+/*
+** Sums of the values over random key ranges of a given width, by iterating
+** a map and with aggregate_map::aggregate. Keys are dense, so the walk starts
+** from find() rather than from the linear ft::map::lower_bound.
+*/
+static void range_sums(const ft::map<long, long> &m, const ft::aggregate_map<long, long> &a, size_t keys, size_t queries, size_t width)
+{
+	std::vector<long> starts;
+	bench_rng rng(9);
+	long iterated = 0;
+	long aggregated = 0;
+	double start;
+	std::ostringstream label;
+
+	for (size_t i = 0; i < queries; i++)
+		starts.push_back(static_cast<long>(rng.next() % keys));
+	label << "width " << width;
+	start = now();
+	for (size_t i = 0; i < queries; i++)
+	{
+		long last = starts[i] + static_cast<long>(width) - 1;
+		for (ft::map<long, long>::const_iterator it = m.find(starts[i]); it != m.end() && it->first <= last; ++it)
+			iterated += it->second;
+	}
+	report("ft::map iteration, " + label.str(), queries, now() - start);
+	start = now();
+	for (size_t i = 0; i < queries; i++)
+		aggregated += a.aggregate(starts[i], starts[i] + static_cast<long>(width) - 1);
+	report("aggregate_map, " + label.str(), queries, now() - start);
+	if (iterated != aggregated)
+		std::cout << "aggregate_map: wrong sums" << std::endl;
+}
+
+/*
+** usage: aggregate_map [keys = 1e7] [queries = 1e5]
+*/
+void bench_aggregate_map(int argc, char **argv)
+{
+	size_t keys = arg_size(argc, argv, 0, 10000000);
+	size_t queries = arg_size(argc, argv, 1, 100000);
+	ft::map<long, long> m;
+	ft::aggregate_map<long, long> a;
+	bench_rng rng(4);
+	double start;
+
+	print_header("aggregate_map range sums");
+	for (size_t i = 0; i < keys; i++)
+		m.insert(ft::make_pair(static_cast<long>(i), static_cast<long>(rng.next() % 1000)));
+	start = now();
+	for (ft::map<long, long>::iterator it = m.begin(); it != m.end(); ++it)
+		a.insert(*it);
+	report("aggregate_map insert", keys, now() - start);
+	range_sums(m, a, keys, queries, 16);
+	range_sums(m, a, keys, queries, 256);
+	range_sums(m, a, keys, queries / 10, 4096);
+}
@@ -0,0 +1,47 @@
+#include "bench.hpp"
+#include "../includes/vector.hpp"
+#include "../includes/algorithm.hpp"
+
+/*
+** Equality and ordering of two vectors of bytes bytes, different on their
+** last element: the element loops, through vector iterators, against the
+** comparison operators, which hand pointers to the memcmp kernels.
+*/
+template <typename T>
+static void comparisons(std::string name, size_t bytes)
+{
+	size_t size = bytes / sizeof(T);
+	ft::vector<T> lhs(size, T(7));
+	ft::vector<T> rhs(size, T(7));
+	bool wrong = false;
+	double start;
+
+	lhs[size - 1] = T(8);
+	rhs[size - 1] = T(9);
+	start = now();
+	wrong = wrong || ft::equal(lhs.begin(), lhs.end(), rhs.begin());
+	report(name + ", equal() loop", size, now() - start);
+	start = now();
+	wrong = wrong || lhs == rhs;
+	report(name + ", operator==", size, now() - start);
+	start = now();
+	wrong = wrong || !ft::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+	report(name + ", lexicographical_compare() loop", size, now() - start);
+	start = now();
+	wrong = wrong || !(lhs < rhs);
+	report(name + ", operator<", size, now() - start);
+	if (wrong)
+		std::cout << name << ": wrong results" << std::endl;
+}
+
+/*
+** usage: algorithm [bytes = 1e9]
+*/
+void bench_algorithm(int argc, char **argv)
+{
+	size_t bytes = arg_size(argc, argv, 0, 1000000000);
+
+	print_header("vector comparisons");
+	comparisons<unsigned char>("bytes", bytes);
+	comparisons<int>("ints", bytes);
+}
@@ -0,0 +1,132 @@
+#ifndef BENCH_HPP
+# define BENCH_HPP
+
+# include <iostream>
+# include <iomanip>
+# include <string>
+# include <sstream>
+# include <cstdlib>
+# include <fstream>
+# include <sys/time.h>
+# include <unistd.h>
+# include <pthread.h>
+# include <sys/wait.h>
+
+# ifdef __linux__
+#  define RESET "\e[0m"
+#  define BLUE "\e[94m"
+# endif
+
+# ifdef __APPLE__
+#  define RESET "\e[0m"
+#  define BLUE "\e[94m"
+# endif
+
+void	bench_map(int argc, char **argv);
+void	bench_concurrent_map(int argc, char **argv);
+void	bench_skiplist_map(int argc, char **argv);
+void	bench_unordered_map(int argc, char **argv);
+void	bench_frozen_map(int argc, char **argv);
+void	bench_map_rebuild(int argc, char **argv);
+void	bench_aggregate_map(int argc, char **argv);
+void	bench_interval_map(int argc, char **argv);
+void	bench_small_map(int argc, char **argv);
+void	bench_int_map(int argc, char **argv);
+void	bench_radix_map(int argc, char **argv);
+void	bench_map_filter(int argc, char **argv);
+void	bench_map_diff(int argc, char **argv);
+void	bench_algorithm(int argc, char **argv);
+void	bench_map_snapshot(int argc, char **argv);
+void	bench_mmap_map(int argc, char **argv);
+
+inline void print_header(std::string str)
+{
+	int margin = (40 - str.length()) / 2;
+	int width = (margin * 2 + str.length()) + 2;
+	std::cout << BLUE << std::endl;
+	std::cout << std::string(width, '*') << std::endl;
+	std::cout << "*" << std::string(margin, ' ') << str << std::string(margin, ' ') << "*" << std::endl;
+	std::cout << std::string(width, '*') << std::endl;
+	std::cout << RESET;
+};
+
+/*
+** Wall clock in seconds.
+*/
+inline double now(void)
+{
+	struct timeval tv;
+	gettimeofday(&tv, NULL);
+	return tv.tv_sec + tv.tv_usec / 1e6;
+};
+
+/*
+** Returns argv[index] as a size, or fallback when it is missing.
+*/
+inline size_t arg_size(int argc, char **argv, int index, size_t fallback)
+{
+	if (index >= argc)
+		return (fallback);
+	return (static_cast<size_t>(std::strtod(argv[index], NULL)));
+};
+
+/*
+** Prints one result line: operations per second, in millions.
+*/
+inline void report(std::string name, double ops, double seconds)
+{
+	std::string margin(name.length() < 38 ? 38 - name.length() : 1, ' ');
+	std::cout << name << ": " << margin << std::fixed << std::setprecision(2) << ops / seconds / 1e6 << " Mops/s" << std::endl;
+};
+
+/*
+** Resident memory in bytes, from /proc on Linux, 0 elsewhere.
+*/
+inline size_t resident(void)
+{
+	size_t pages = 0;
+#ifdef __linux__
+	std::ifstream statm("/proc/self/statm");
+	statm >> pages >> pages;
+#endif
+	return (pages * sysconf(_SC_PAGESIZE));
+};
+
+/*
+** Forks and returns true in the child, which must end with _exit(0), while
+** the parent waits for it and gets false. The child starts from a fresh
+** heap, so its memory layout and growth do not depend on earlier runs.
+*/
+inline bool isolated(void)
+{
+	pid_t pid;
+
+	std::cout.flush();
+	pid = fork();
+	if (pid == 0)
+		return (true);
+	waitpid(pid, NULL, 0);
+	return (false);
+};
+
+/*
+** xorshift64* generator, deterministic and cheap enough not to show in the measures.
+*/
+class bench_rng
+{
+public:
+	bench_rng(unsigned long seed = 88172645463325252UL) : _state(seed ? seed : 1) {}
+
+	unsigned long next(void)
+	{
+		_state ^= _state >> 12;
+		_state ^= _state << 25;
+		_state ^= _state >> 27;
+		return (_state * 2685821657736338717UL);
+	}
+
+private:
+	unsigned long _state;
+};
+
+#endif
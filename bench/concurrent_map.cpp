@@ -0,0 +1,145 @@
+#include "bench.hpp"
+#include "../includes/map.hpp"
+#include "../includes/concurrent_map.hpp"
+
+/*
+** Every thread runs the same mix until told to stop: 95% lookups, 5% writes
+** split between inserts and erases, on keys drawn from twice the prefilled
+** range so that half of the lookups miss.
+*/
+
+struct workload
+{
+	ft::concurrent_map<int, int> *concurrent;
+	ft::map<int, int> *locked;
+	pthread_mutex_t *lock;
+	size_t range;
+	unsigned long seed;
+	int stop;
+	size_t reads;
+	size_t writes;
+	char padding[64];
+};
+
+static void *run_concurrent(void *arg)
+{
+	workload *w = static_cast<workload *>(arg);
+	bench_rng rng(w->seed);
+	int value;
+
+	while (!__atomic_load_n(&w->stop, __ATOMIC_RELAXED))
+	{
+		unsigned long r = rng.next();
+		int key = static_cast<int>((r >> 16) % w->range);
+
+		if (r % 100 < 5)
+		{
+			if ((r >> 8) & 1)
+				w->concurrent->insert_or_assign(ft::make_pair(key, key));
+			else
+				w->concurrent->erase(key);
+			w->writes++;
+		}
+		else
+		{
+			w->concurrent->find(key, value);
+			w->reads++;
+		}
+	}
+	return (NULL);
+}
+
+static void *run_locked(void *arg)
+{
+	workload *w = static_cast<workload *>(arg);
+	bench_rng rng(w->seed);
+
+	while (!__atomic_load_n(&w->stop, __ATOMIC_RELAXED))
+	{
+		unsigned long r = rng.next();
+		int key = static_cast<int>((r >> 16) % w->range);
+
+		pthread_mutex_lock(w->lock);
+		if (r % 100 < 5)
+		{
+			if ((r >> 8) & 1)
+				(*w->locked)[key] = key;
+			else
+				w->locked->erase(key);
+			w->writes++;
+		}
+		else
+		{
+			w->locked->count(key);
+			w->reads++;
+		}
+		pthread_mutex_unlock(w->lock);
+	}
+	return (NULL);
+}
+
+static void run(std::string name, void *(*routine)(void *), workload &base, size_t threads, double seconds)
+{
+	pthread_t ids[32];
+	workload w[32];
+	size_t reads = 0;
+	double start;
+	double elapsed;
+
+	for (size_t i = 0; i < threads; i++)
+	{
+		w[i] = base;
+		w[i].seed = base.seed + i * 7919;
+		w[i].reads = 0;
+		w[i].writes = 0;
+		w[i].stop = 0;
+	}
+	start = now();
+	for (size_t i = 0; i < threads; i++)
+		pthread_create(&ids[i], NULL, routine, &w[i]);
+	usleep(static_cast<useconds_t>(seconds * 1e6));
+	for (size_t i = 0; i < threads; i++)
+		__atomic_store_n(&w[i].stop, 1, __ATOMIC_RELAXED);
+	for (size_t i = 0; i < threads; i++)
+	{
+		pthread_join(ids[i], NULL);
+		reads += w[i].reads;
+	}
+	elapsed = now() - start;
+	report(name, reads, elapsed);
+}
+
+/*
+** usage: concurrent_map [keys = 1e6] [seconds per run = 0.5]
+*/
+void bench_concurrent_map(int argc, char **argv)
+{
+	size_t keys = arg_size(argc, argv, 0, 1000000);
+	double seconds = argc > 1 ? std::strtod(argv[1], NULL) : 0.5;
+	ft::concurrent_map<int, int> concurrent;
+	ft::map<int, int> locked;
+	pthread_mutex_t lock;
+	workload base;
+
+	pthread_mutex_init(&lock, NULL);
+	for (size_t i = 0; i < keys; i++)
+	{
+		int key = static_cast<int>(i * 2);
+		concurrent.insert(ft::make_pair(key, key));
+		locked.insert(ft::make_pair(key, key));
+	}
+	base.concurrent = &concurrent;
+	base.locked = &locked;
+	base.lock = &lock;
+	base.range = keys * 2;
+	base.seed = 42;
+	print_header("concurrent_map reads, 5% writes");
+	for (size_t threads = 1; threads <= 32; threads *= 2)
+	{
+		std::ostringstream label;
+		label << threads << " threads";
+		run("concurrent_map " + label.str(), &run_concurrent, base, threads, seconds);
+		run("mutex + map " + label.str(), &run_locked, base, threads, seconds);
+	}
+	pthread_mutex_destroy(&lock);
+}
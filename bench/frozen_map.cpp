@@ -0,0 +1,56 @@
+#include "bench.hpp"
+#include <vector>
+#include "../includes/map.hpp"
+#include "../includes/frozen_map.hpp"
+
+/*
+** Looks up random keys, half of them missing, in a map and in its frozen
+** copy.
+*/
+
+template <typename Map>
+static void run(std::string name, const Map &m, const std::vector<long> &probes, size_t expected)
+{
+	size_t hits = 0;
+	double start = now();
+
+	for (size_t i = 0; i < probes.size(); i++)
+		hits += m.find(probes[i]) != m.end();
+	report(name, probes.size(), now() - start);
+	if (hits != expected)
+		std::cout << name << ": wrong lookups" << std::endl;
+}
+
+/*
+** usage: frozen_map [keys = 1e6] [more keys = 1e7] [lookups = 4e6]
+** 1e8 keys needs about 10GB for the live map.
+*/
+void bench_frozen_map(int argc, char **argv)
+{
+	size_t sizes[2] = {arg_size(argc, argv, 0, 1000000), arg_size(argc, argv, 1, 10000000)};
+	size_t lookups = arg_size(argc, argv, 2, 4000000);
+
+	for (size_t s = 0; s < 2; s++)
+	{
+		ft::map<long, long> m;
+		std::vector<long> probes;
+		bench_rng rng(42);
+		size_t hits = 0;
+		std::ostringstream label;
+
+		for (size_t i = 0; i < sizes[s]; i++)
+			m.insert(ft::make_pair(static_cast<long>(i * 2), static_cast<long>(i)));
+		for (size_t i = 0; i < lookups; i++)
+		{
+			probes.push_back(static_cast<long>(rng.next() % (sizes[s] * 2)));
+			hits += (probes.back() & 1) == 0;
+		}
+		label << "frozen_map " << sizes[s] << " keys";
+		print_header(label.str());
+		double start = now();
+		ft::frozen_map<long, long> f = ft::freeze(m);
+		report("freeze", sizes[s], now() - start);
+		run("ft::map find", m, probes, hits);
+		run("ft::frozen_map find", f, probes, hits);
+	}
+}
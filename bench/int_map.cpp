@@ -0,0 +1,117 @@
+#include "bench.hpp"
+#include <vector>
+#include "../includes/map.hpp"
+#include "../includes/int_map.hpp"
+
+/*
+** Key sets of 64 bit keys: sequential, uniformly random, and clustered in
+** runs of 64 consecutive keys starting at random places.
+*/
+static std::vector<long> make_keys(std::string kind, size_t keys)
+{
+	std::vector<long> result;
+	bench_rng rng(5);
+	long base = 0;
+
+	result.reserve(keys);
+	for (size_t i = 0; i < keys; i++)
+	{
+		if (i % 64 == 0)
+			base = static_cast<long>(rng.next() & ~0xffffUL);
+		if (kind == "sequential")
+			result.push_back(static_cast<long>(i));
+		else if (kind == "random")
+			result.push_back(static_cast<long>(rng.next()));
+		else
+			result.push_back(base + static_cast<long>(i % 64));
+	}
+	return (result);
+}
+
+/*
+** Inserts the keys in a shuffled order, then measures resident bytes per
+** entry, random lookups of present keys and a full in-order scan.
+*/
+template <typename Map>
+static void run(std::string name, const std::vector<long> &keys, size_t lookups)
+{
+	std::vector<long> order(keys);
+	bench_rng rng(11);
+	size_t before = resident();
+	long sum = 0;
+	double start;
+
+	for (size_t i = order.size(); i > 1; i--)
+		std::swap(order[i - 1], order[rng.next() % i]);
+	Map *m = new Map;
+	start = now();
+	for (size_t i = 0; i < order.size(); i++)
+		m->insert(ft::make_pair(order[i], static_cast<long>(i)));
+	report(name + " insert", order.size(), now() - start);
+	std::cout << name << " memory: " << std::string(name.length() < 31 ? 31 - name.length() : 1, ' ')
+		<< (resident() - before) / order.size() << " bytes per entry" << std::endl;
+	start = now();
+	for (size_t i = 0; i < lookups; i++)
+		sum += m->find(order[rng.next() % order.size()])->second;
+	report(name + " lookup", lookups, now() - start);
+	start = now();
+	for (typename Map::iterator it = m->begin(); it != m->end(); ++it)
+		sum += it->second;
+	report(name + " scan", order.size(), now() - start);
+	delete m;
+	if (sum == 42)
+		std::cout << std::endl;
+}
+
+/*
+** Range scans of 16 elements from random keys, present or not. Only for
+** ft::int_map: ft::map::lower_bound() walks the elements in order.
+*/
+static void ranges(std::string name, const std::vector<long> &keys, size_t count)
+{
+	ft::int_map<long, long> m;
+	bench_rng rng(17);
+	long sum = 0;
+	double start;
+
+	for (size_t i = 0; i < keys.size(); i++)
+		m.insert(ft::make_pair(keys[i], static_cast<long>(i)));
+	start = now();
+	for (size_t i = 0; i < count; i++)
+	{
+		ft::int_map<long, long>::iterator it = m.lower_bound(keys[rng.next() % keys.size()] + static_cast<long>(i & 1));
+		for (int j = 0; j < 16 && it != m.end(); j++, ++it)
+			sum += it->second;
+	}
+	report(name + " lower_bound + 16", count, now() - start);
+	if (sum == 42)
+		std::cout << std::endl;
+}
+
+/*
+** usage: int_map [keys = 2e6] [lookups = 4e6]
+*/
+void bench_int_map(int argc, char **argv)
+{
+	size_t keys = arg_size(argc, argv, 0, 2000000);
+	size_t lookups = arg_size(argc, argv, 1, 4000000);
+	std::string kinds[3] = {"sequential", "random", "clustered"};
+
+	for (int k = 0; k < 3; k++)
+	{
+		std::vector<long> set = make_keys(kinds[k], keys);
+
+		print_header(kinds[k] + " keys");
+		if (isolated())
+		{
+			run<ft::map<long, long> >("ft::map", set, lookups);
+			_exit(0);
+		}
+		if (isolated())
+		{
+			run<ft::int_map<long, long> >("ft::int_map", set, lookups);
+			ranges("ft::int_map", set, lookups);
+			_exit(0);
+		}
+	}
+}
@@ -0,0 +1,88 @@
+#include "bench.hpp"
+#include <vector>
+#include "../includes/map.hpp"
+#include "../includes/interval_map.hpp"
+
+/*
+** Counts the intervals containing point by scanning a map keyed by start up
+** to the first start past point, the way overlaps are found without the
+** augmented tree.
+*/
+static size_t scan(const ft::map<long, long> &m, long point)
+{
+	size_t found = 0;
+
+	for (ft::map<long, long>::const_iterator it = m.begin(); it != m.end() && it->first <= point; ++it)
+		found += point < it->second;
+	return (found);
+}
+
+/*
+** Counts output iterator, the stabbing queries only need the number of hits.
+*/
+struct counter
+{
+	size_t *count;
+
+	counter &operator*(void)
+	{
+		return (*this);
+	}
+
+	counter &operator++(int)
+	{
+		return (*this);
+	}
+
+	template <typename T>
+	counter &operator=(const T &)
+	{
+		(*count)++;
+		return (*this);
+	}
+};
+
+/*
+** usage: interval_map [intervals = 1e7] [queries = 1e6] [scans = 100]
+*/
+void bench_interval_map(int argc, char **argv)
+{
+	size_t size = arg_size(argc, argv, 0, 10000000);
+	size_t queries = arg_size(argc, argv, 1, 1000000);
+	size_t scans = arg_size(argc, argv, 2, 100);
+	ft::interval_map<long, long> intervals;
+	ft::map<long, long> starts;
+	std::vector<long> points;
+	bench_rng rng(21);
+	size_t hits = 0;
+	size_t scanned = 0;
+	double start;
+
+	print_header("interval_map stabbing");
+	start = now();
+	for (size_t i = 0; i < size; i++)
+	{
+		long lo = static_cast<long>(rng.next() % (size * 10));
+		long hi = lo + 1 + static_cast<long>(rng.next() % 1000);
+
+		if (intervals.insert(lo, hi, i))
+			starts.insert(ft::make_pair(lo, hi));
+	}
+	report("insert into both maps", size, now() - start);
+	for (size_t i = 0; i < queries; i++)
+		points.push_back(static_cast<long>(rng.next() % (size * 10)));
+	start = now();
+	for (size_t i = 0; i < queries; i++)
+	{
+		counter out = {&hits};
+		intervals.containing(points[i], out);
+	}
+	report("interval_map containing", queries, now() - start);
+	start = now();
+	for (size_t i = 0; i < scans; i++)
+		scanned += scan(starts, points[i]);
+	std::cout << "ft::map scan by start, ms: " << std::string(11, ' ') << (now() - start) * 1e3 / scans << std::endl;
+	std::cout << "hits per query: " << std::string(22, ' ') << static_cast<double>(hits) / queries << std::endl;
+	if (scanned == 42)
+		std::cout << std::endl;
+}
@@ -0,0 +1,48 @@
+#include "bench.hpp"
+
+int main(int argc, char **argv)
+{
+	std::string choice;
+	if (argc < 2)
+	{
+		std::cout << "usage: " << argv[0] << " <benchmark> [arguments...]" << std::endl;
+		return (1);
+	}
+	choice = std::string(argv[1]);
+	if (choice == "map")
+		bench_map(argc - 2, argv + 2);
+	else if (choice == "concurrent_map")
+		bench_concurrent_map(argc - 2, argv + 2);
+	else if (choice == "skiplist_map")
+		bench_skiplist_map(argc - 2, argv + 2);
+	else if (choice == "unordered_map")
+		bench_unordered_map(argc - 2, argv + 2);
+	else if (choice == "frozen_map")
+		bench_frozen_map(argc - 2, argv + 2);
+	else if (choice == "map_rebuild")
+		bench_map_rebuild(argc - 2, argv + 2);
+	else if (choice == "aggregate_map")
+		bench_aggregate_map(argc - 2, argv + 2);
+	else if (choice == "interval_map")
+		bench_interval_map(argc - 2, argv + 2);
+	else if (choice == "small_map")
+		bench_small_map(argc - 2, argv + 2);
+	else if (choice == "int_map")
+		bench_int_map(argc - 2, argv + 2);
+	else if (choice == "radix_map")
+		bench_radix_map(argc - 2, argv + 2);
+	else if (choice == "map_filter")
+		bench_map_filter(argc - 2, argv + 2);
+	else if (choice == "map_diff")
+		bench_map_diff(argc - 2, argv + 2);
+	else if (choice == "algorithm")
+		bench_algorithm(argc - 2, argv + 2);
+	else if (choice == "map_snapshot")
+		bench_map_snapshot(argc - 2, argv + 2);
+	else if (choice == "mmap_map")
+		bench_mmap_map(argc - 2, argv + 2);
+	else
+		std::cout << "No benchmark for " << choice << std::endl;
+
+	return (0);
+}
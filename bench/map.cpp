@@ -0,0 +1,468 @@
+#include "bench.hpp"
+#include <vector>
+#include <algorithm>
+#include <iterator>
+#include "../includes/map.hpp"
+#include "../includes/algorithm.hpp"
+
+/*
+** Probes a map larger than the last level cache with batches of random
+** keys, half of them missing, as a join would.
+*/
+
+typedef ft::map<long, long, std::less<long>, std::allocator<ft::pair<const long, long> >, ft::threaded_avl_tree<long, long> > threaded_map;
+typedef ft::map<long, long, std::less<long>, std::allocator<ft::pair<const long, long> >, ft::parentless_avl_tree<long, long> > parentless_map;
+typedef ft::map<long, long, std::less<long>, std::allocator<ft::pair<const long, long> >, ft::arena_avl_tree<long, long> > arena_map;
+typedef ft::map<std::string, long> string_map;
+typedef ft::map<std::string, long, std::less<std::string>, std::allocator<ft::pair<const std::string, long> >, ft::avl_tree<std::string, long, ft::PrefixNode<std::string, long> > > prefix_string_map;
+
+/*
+** Node size and resident bytes per entry of a map of keys entries.
+*/
+template <typename Map>
+static void footprint(std::string name, size_t keys)
+{
+	size_t before = resident();
+
+	Map *m = new Map;
+
+	for (size_t i = 0; i < keys; i++)
+		m->insert(ft::make_pair(static_cast<long>(i), static_cast<long>(i)));
+	std::cout << name << ": " << std::string(name.length() < 38 ? 38 - name.length() : 1, ' ')
+		<< sizeof(typename Map::tree_type::node_type) << " bytes per node, "
+		<< (resident() - before) / keys << " resident bytes per entry" << std::endl;
+	delete m;
+}
+
+/*
+** Full scans, random lookups, then short scans of 16 elements from random
+** keys. Keys are inserted in random order so that neighbours are not
+** neighbours in memory.
+*/
+template <typename Map>
+static void scans(std::string name, size_t keys, size_t ranges)
+{
+	Map m;
+	bench_rng rng(7);
+	long sum = 0;
+	double start;
+
+	for (size_t i = 0; i < keys; i++)
+		m.insert(ft::make_pair(static_cast<long>((i * 2654435761UL) % keys), static_cast<long>(i)));
+	start = now();
+	for (int round = 0; round < 4; round++)
+		for (typename Map::iterator it = m.begin(); it != m.end(); ++it)
+			sum += it->second;
+	report(name + " full scan", keys * 4, now() - start);
+	start = now();
+	for (size_t i = 0; i < ranges * 4; i++)
+		sum += m.find(static_cast<long>(rng.next() % keys))->second;
+	report(name + " random lookups", ranges * 4, now() - start);
+	start = now();
+	for (size_t i = 0; i < ranges; i++)
+	{
+		typename Map::iterator it = m.find(static_cast<long>(rng.next() % keys));
+		for (int step = 0; step < 16 && it != m.end(); step++, ++it)
+			sum += it->second;
+	}
+	report(name + " 16-element scans", ranges * 16, now() - start);
+	if (sum == 42)
+		std::cout << std::endl;
+}
+
+/*
+** Iterator-heavy algorithms over two equal maps: copy out, equal and
+** lexicographical_compare, plus an iterator kept per element.
+*/
+template <typename Map>
+static void algorithms(std::string name, size_t keys)
+{
+	Map a;
+	Map b;
+	std::vector<typename Map::iterator> index;
+	std::vector<ft::pair<long, long> > out;
+	size_t matches = 0;
+	double start;
+
+	for (size_t i = 0; i < keys; i++)
+	{
+		a.insert(ft::make_pair(static_cast<long>(i), static_cast<long>(i)));
+		b.insert(ft::make_pair(static_cast<long>(i), static_cast<long>(i)));
+	}
+	out.reserve(keys);
+	start = now();
+	std::copy(a.begin(), a.end(), std::back_inserter(out));
+	report(name + " copy", keys, now() - start);
+	start = now();
+	matches += ft::equal(a.begin(), a.end(), b.begin());
+	report(name + " equal", keys, now() - start);
+	start = now();
+	matches += !ft::lexicographical_compare(a.begin(), a.end(), b.begin(), b.end());
+	report(name + " lexicographical_compare", keys, now() - start);
+	start = now();
+	for (typename Map::iterator it = a.begin(); it != a.end(); ++it)
+		index.push_back(it);
+	report(name + " iterator index", keys, now() - start);
+	std::cout << name << " sizeof(iterator): " << sizeof(typename Map::iterator) << std::endl;
+	if (matches != 2 || out.size() != keys)
+		std::cout << name << ": wrong results" << std::endl;
+}
+
+/*
+** Everything measured per tree layout, each measure running in its own
+** process so that none inherits the heap freed by another.
+*/
+template <typename Map>
+static void layout(std::string name, size_t keys, size_t ranges)
+{
+	if (isolated())
+	{
+		footprint<Map>(name, keys);
+		_exit(0);
+	}
+	if (isolated())
+	{
+		algorithms<Map>(name, keys);
+		_exit(0);
+	}
+	if (isolated())
+	{
+		scans<Map>(name, keys, ranges);
+		_exit(0);
+	}
+}
+
+static void batched_lookups(size_t keys, size_t lookups)
+{
+	ft::map<long, long> m;
+	std::vector<long> probes;
+	std::vector<ft::map<long, long>::iterator> found;
+	bench_rng rng(42);
+	size_t hits;
+	double start;
+
+	for (size_t i = 0; i < keys; i++)
+		m.insert(ft::make_pair(static_cast<long>(i * 2), static_cast<long>(i)));
+	for (size_t i = 0; i < lookups; i++)
+		probes.push_back(static_cast<long>(rng.next() % (keys * 2)));
+	found.resize(lookups);
+	print_header("map batched lookups");
+	hits = 0;
+	start = now();
+	for (size_t i = 0; i < lookups; i++)
+		hits += m.find(probes[i]) != m.end();
+	report("find loop", lookups, now() - start);
+	for (size_t batch = 1024; batch <= 65536; batch *= 4)
+	{
+		std::ostringstream label;
+		size_t batch_hits = 0;
+		label << "find_many, batches of " << batch;
+		start = now();
+		for (size_t i = 0; i < lookups; i += batch)
+		{
+			size_t last = std::min(i + batch, lookups);
+			m.find_many(probes.begin() + i, probes.begin() + last, found.begin() + i);
+		}
+		report(label.str(), lookups, now() - start);
+		for (size_t i = 0; i < lookups; i++)
+			batch_hits += found[i] != m.end();
+		if (batch_hits != hits)
+			std::cout << "find_many: wrong lookups" << std::endl;
+	}
+}
+
+/*
+** Scans and lookups over a map churned by erasing and reinserting random
+** keys, before and after compact().
+*/
+template <typename Map>
+static void churned_scans(Map &m, std::string name, size_t keys, size_t lookups)
+{
+	bench_rng rng(11);
+	long sum = 0;
+	double start = now();
+
+	for (typename Map::iterator it = m.begin(); it != m.end(); ++it)
+		sum += it->second;
+	report(name + " full scan", m.size(), now() - start);
+	start = now();
+	for (size_t i = 0; i < lookups; i++)
+		sum += m.count(static_cast<long>(rng.next() % keys));
+	report(name + " random lookups", lookups, now() - start);
+	if (sum == 42)
+		std::cout << std::endl;
+}
+
+template <typename Map>
+static void compaction(std::string name, size_t keys, size_t lookups)
+{
+	Map m;
+	bench_rng rng(5);
+	double start;
+
+	print_header("map compact, " + name);
+	for (size_t i = 0; i < keys; i++)
+		m.insert(ft::make_pair(static_cast<long>((i * 2654435761UL) % keys), static_cast<long>(i)));
+	for (size_t i = 0; i < keys; i++)
+	{
+		long key = static_cast<long>(rng.next() % keys);
+		m.erase(key);
+		m.insert(ft::make_pair(key, key));
+	}
+	churned_scans(m, "churned", keys, lookups);
+	start = now();
+	m.compact();
+	report("compact", m.size(), now() - start);
+	churned_scans(m, "compacted", keys, lookups);
+}
+
+/*
+** Probes walking forward by random steps below stride, as a merge with
+** another sorted input does: plain find() against find() from the last
+** element found. Each find(hint) waits for the previous one, when plain
+** finds overlap their cache misses.
+*/
+static void finger_probes(size_t keys, size_t lookups)
+{
+	ft::map<long, long> m;
+
+	for (size_t i = 0; i < keys; i++)
+		m.insert(ft::make_pair(static_cast<long>((i * 2654435761UL) % keys), static_cast<long>(i)));
+	for (size_t stride = 2; stride <= 8192; stride *= 16)
+	{
+		std::vector<long> probes;
+		bench_rng rng(41);
+		std::ostringstream label;
+		ft::map<long, long>::iterator hint = m.end();
+		long key = 0;
+		long sum = 0;
+		double start;
+
+		for (size_t i = 0; i < lookups; i++)
+		{
+			key = (key + static_cast<long>(rng.next() % stride)) % static_cast<long>(keys);
+			probes.push_back(key);
+		}
+		label << "steps below " << stride;
+		start = now();
+		for (size_t i = 0; i < lookups; i++)
+			sum += m.find(probes[i])->second;
+		report("find(), " + label.str(), lookups, now() - start);
+		start = now();
+		for (size_t i = 0; i < lookups; i++)
+		{
+			hint = m.find(hint, probes[i]);
+			sum -= hint->second;
+		}
+		report("find(hint), " + label.str(), lookups, now() - start);
+		if (sum != 0)
+			std::cout << "find(hint) disagrees with find()" << std::endl;
+	}
+}
+
+/*
+** Random lookups of string keys of length bytes, random letters after a
+** shared head of shared bytes, inserted in random order.
+*/
+template <typename Map>
+static void string_lookups(std::string name, size_t length, size_t shared, size_t keys, size_t lookups)
+{
+	Map m;
+	std::vector<std::string> strings;
+	bench_rng rng(19);
+	std::ostringstream label;
+	long sum = 0;
+	double start;
+
+	strings.reserve(keys);
+	for (size_t i = 0; i < keys; i++)
+	{
+		std::string key(shared, '/');
+
+		while (key.size() < length)
+			key += static_cast<char>('a' + rng.next() % 26);
+		strings.push_back(key);
+		m.insert(ft::make_pair(key, static_cast<long>(i)));
+	}
+	start = now();
+	for (size_t i = 0; i < lookups; i++)
+		sum += m.find(strings[rng.next() % keys])->second;
+	label << name << ", " << length << " bytes, " << shared << " shared";
+	report(label.str(), lookups, now() - start);
+	if (sum == 42)
+		std::cout << std::endl;
+}
+
+/*
+** Inserts a batch of batch random keys, half of them already present, into
+** a map of keys entries: one insert() per element, the batch sorted through
+** insert_sorted_batch(), and unsorted through insert_batch(). how picks the
+** variant, each run in its own process on a fresh map.
+*/
+static void batch_inserts(size_t keys, size_t batch, int how)
+{
+	static const char *names[3] = {"insert()", "insert_sorted_batch()", "insert_batch()"};
+	ft::map<long, long> m;
+	std::vector<ft::pair<long, long> > values;
+	bench_rng rng(43);
+	std::ostringstream label;
+	size_t inserted = 0;
+	double start;
+
+	for (size_t i = 0; i < keys; i++)
+		m.insert(ft::make_pair(static_cast<long>(((i * 2654435761UL) % keys) * 2), static_cast<long>(i)));
+	for (size_t i = 0; i < batch; i++)
+		values.push_back(ft::make_pair(static_cast<long>(rng.next() % (keys * 2)), static_cast<long>(i)));
+	if (how == 1)
+	{
+		std::vector<long> sorted;
+
+		for (size_t i = 0; i < batch; i++)
+			sorted.push_back(values[i].first);
+		std::sort(sorted.begin(), sorted.end());
+		for (size_t i = 0; i < batch; i++)
+			values[i].first = sorted[i];
+	}
+	start = now();
+	if (how == 0)
+	{
+		for (size_t i = 0; i < batch; i++)
+			inserted += m.insert(values[i]).second;
+	}
+	else if (how == 1)
+		inserted = m.insert_sorted_batch(values.begin(), values.end());
+	else
+		inserted = m.insert_batch(values.begin(), values.end());
+	label << names[how] << ", batch of " << batch;
+	report(label.str(), batch, now() - start);
+	if (inserted + keys != m.size())
+		std::cout << names[how] << ": wrong count" << std::endl;
+}
+
+/*
+** Expires percent of a map of keys entries, spread over the whole key
+** range: erase() on every match while iterating, then ft::erase_if(). Each
+** runs in its own process on a fresh map.
+*/
+struct expired
+{
+	long percent;
+
+	bool operator()(const ft::pair<long, long> &value) const
+	{
+		return value.second % 100 < percent;
+	}
+};
+
+static void expiry(size_t keys, long percent, bool bulk)
+{
+	ft::map<long, long> m;
+	expired pred;
+	std::ostringstream label;
+	size_t erased = 0;
+	double start;
+
+	pred.percent = percent;
+	for (size_t i = 0; i < keys; i++)
+		m.insert(ft::make_pair(static_cast<long>((i * 2654435761UL) % keys), static_cast<long>(i)));
+	start = now();
+	if (bulk)
+		erased = ft::erase_if(m, pred);
+	else
+	{
+		for (ft::map<long, long>::iterator it = m.begin(); it != m.end();)
+		{
+			if (pred(*it))
+			{
+				m.erase(it++);
+				erased++;
+			}
+			else
+				++it;
+		}
+	}
+	label << (bulk ? "ft::erase_if(), " : "erase() loop, ") << percent << "% expired";
+	report(label.str(), keys, now() - start);
+	if (erased + m.size() != keys || erased != keys * percent / 100)
+		std::cout << label.str() << ": wrong count" << std::endl;
+}
+
+/*
+** usage: map [keys = 4e6] [lookups = 4e6] [largest batch = 1e7]
+*/
+void bench_map(int argc, char **argv)
+{
+	size_t keys = arg_size(argc, argv, 0, 4000000);
+	size_t lookups = arg_size(argc, argv, 1, 4000000);
+	size_t batches = arg_size(argc, argv, 2, 10000000);
+
+	print_header("map tree layouts");
+	layout<ft::map<long, long> >("avl_tree", keys, lookups / 4);
+	layout<threaded_map>("threaded_avl_tree", keys, lookups / 4);
+	layout<parentless_map>("parentless_avl_tree", keys, lookups / 4);
+	layout<arena_map>("arena_avl_tree", keys, lookups / 4);
+	if (isolated())
+	{
+		batched_lookups(keys, lookups);
+		_exit(0);
+	}
+	if (isolated())
+	{
+		compaction<ft::map<long, long> >("avl_tree", keys, lookups);
+		_exit(0);
+	}
+	if (isolated())
+	{
+		compaction<arena_map>("arena_avl_tree", keys, lookups);
+		_exit(0);
+	}
+	print_header("map finger search");
+	if (isolated())
+	{
+		finger_probes(keys, lookups);
+		_exit(0);
+	}
+	print_header("map string lookups");
+	for (size_t length = 32; length <= 128; length *= 2)
+	{
+		for (size_t shared = 0; shared <= 8; shared += 8)
+		{
+			if (isolated())
+			{
+				string_lookups<string_map>("Node", length, shared, keys / 4, lookups);
+				_exit(0);
+			}
+			if (isolated())
+			{
+				string_lookups<prefix_string_map>("PrefixNode", length, shared, keys / 4, lookups);
+				_exit(0);
+			}
+		}
+	}
+	print_header("map batch insert");
+	for (size_t batch = 1000; batch <= batches; batch *= 10)
+	{
+		for (int how = 0; how < 3; how++)
+		{
+			if (isolated())
+			{
+				batch_inserts(keys, batch, how);
+				_exit(0);
+			}
+		}
+	}
+	print_header("map bulk erase");
+	for (int i = 0; i < 3; i++)
+	{
+		static const long percents[3] = {1, 10, 60};
+
+		for (int bulk = 0; bulk < 2; bulk++)
+		{
+			if (isolated())
+			{
+				expiry(keys, percents[i], bulk);
+				_exit(0);
+			}
+		}
+	}
+}
@@ -0,0 +1,97 @@
+#include "bench.hpp"
+#include "../includes/map.hpp"
+#include "../includes/map_diff.hpp"
+
+typedef ft::map<long, long> long_map;
+
+/*
+** Counts the differences reported by map_diff.
+*/
+struct diff_counter
+{
+	size_t count;
+
+	diff_counter() : count(0) {}
+
+	void added(const ft::pair<long, long> &)
+	{
+		count++;
+	}
+
+	void removed(const ft::pair<long, long> &)
+	{
+		count++;
+	}
+
+	void changed(const ft::pair<long, long> &, const ft::pair<long, long> &)
+	{
+		count++;
+	}
+};
+
+/*
+** Diffs by looking up every key of each snapshot in the other, as done
+** before map_diff.
+*/
+static size_t lookup_diff(const long_map &before, const long_map &after)
+{
+	size_t count = 0;
+
+	for (long_map::const_iterator it = after.begin(); it != after.end(); ++it)
+	{
+		long_map::const_iterator old = before.find(it->first);
+
+		count += old == before.end() || old->second != it->second;
+	}
+	for (long_map::const_iterator it = before.begin(); it != before.end(); ++it)
+		count += after.find(it->first) == after.end();
+	return (count);
+}
+
+/*
+** Two snapshots of keys entries, the second with per_million of them
+** changed: a third erased, a third added, a third assigned.
+*/
+static void snapshots(size_t keys, size_t per_million)
+{
+	long_map before;
+	bench_rng rng(47);
+	size_t changes = keys * per_million / 1000000;
+	size_t count;
+	double start;
+
+	for (size_t i = 0; i < keys; i++)
+		before.insert(ft::make_pair(static_cast<long>((i * 2654435761UL) % keys) * 2, static_cast<long>(i)));
+	long_map after(before);
+	for (size_t i = 0; i < changes; i++)
+	{
+		long key = static_cast<long>(rng.next() % keys) * 2;
+
+		if (i % 3 == 0)
+			after.erase(key);
+		else if (i % 3 == 1)
+			after.insert(ft::make_pair(key + 1, 0L));
+		else if (after.count(key))
+			after[key] = -1;
+	}
+	start = now();
+	count = lookup_diff(before, after);
+	report("find() on every key", keys * 2, now() - start);
+	std::cout << count << " differences" << std::endl;
+	start = now();
+	if (ft::map_diff(before, after, diff_counter()).count != count)
+		std::cout << "map_diff disagrees with find()" << std::endl;
+	report("ft::map_diff()", keys * 2, now() - start);
+}
+
+/*
+** usage: map_diff [keys = 1e7] [changes per million = 1000]
+*/
+void bench_map_diff(int argc, char **argv)
+{
+	size_t keys = arg_size(argc, argv, 0, 10000000);
+	size_t per_million = arg_size(argc, argv, 1, 1000);
+
+	print_header("map_diff snapshots");
+	snapshots(keys, per_million);
+}
@@ -0,0 +1,89 @@
+#include "bench.hpp"
+#include <vector>
+#include "../includes/map.hpp"
+#include "../includes/map_filter.hpp"
+
+typedef ft::map<long, long> long_map;
+
+/*
+** Probes of which hits percent are present keys, the others missing keys
+** drawn from the same range.
+*/
+static std::vector<long> make_probes(size_t keys, size_t count, size_t hits)
+{
+	std::vector<long> probes;
+	bench_rng rng(37);
+
+	probes.reserve(count);
+	for (size_t i = 0; i < count; i++)
+	{
+		long key = static_cast<long>(rng.next() % keys) * 2;
+		probes.push_back(rng.next() % 100 < hits ? key : key + 1);
+	}
+	return (probes);
+}
+
+/*
+** find() on the map alone, then through the filter, at several hit ratios.
+*/
+static void hit_ratios(size_t keys, size_t lookups)
+{
+	long_map m;
+	size_t ratios[4] = {0, 5, 50, 100};
+
+	for (size_t i = 0; i < keys; i++)
+		m.insert(ft::make_pair(static_cast<long>((i * 2654435761UL) % keys) * 2, static_cast<long>(i)));
+	ft::map_filter<long_map> f(m);
+	for (int r = 0; r < 4; r++)
+	{
+		std::vector<long> probes = make_probes(keys, lookups, ratios[r]);
+		std::ostringstream label;
+		size_t found = 0;
+		double start;
+
+		label << ratios[r] << "% hits";
+		start = now();
+		for (size_t i = 0; i < probes.size(); i++)
+			found += m.find(probes[i]) != m.end();
+		report("ft::map, " + label.str(), lookups, now() - start);
+		start = now();
+		for (size_t i = 0; i < probes.size(); i++)
+			found -= f.find(probes[i]) != m.end();
+		report("ft::map_filter, " + label.str(), lookups, now() - start);
+		if (found != 0)
+			std::cout << "filter disagrees with the map" << std::endl;
+	}
+}
+
+/*
+** False positive rate of a filter loaded to its capacity, by size per key.
+*/
+static void false_positives(size_t keys)
+{
+	for (size_t bits = 8; bits <= 16; bits += 4)
+	{
+		ft::bloom_filter<long> filter(keys, bits);
+		size_t positives = 0;
+
+		for (size_t i = 0; i < keys; i++)
+			filter.insert(static_cast<long>(i) * 2);
+		for (size_t i = 0; i < keys; i++)
+			positives += filter.may_contain(static_cast<long>(i) * 2 + 1);
+		std::cout << bits << " bits per key: " << std::string(24, ' ') << std::fixed << std::setprecision(3)
+			<< 100.0 * positives / keys << "% false positives" << std::endl;
+	}
+}
+
+/*
+** usage: map_filter [keys = 4e6] [lookups = 4e6]
+*/
+void bench_map_filter(int argc, char **argv)
+{
+	size_t keys = arg_size(argc, argv, 0, 4000000);
+	size_t lookups = arg_size(argc, argv, 1, 4000000);
+
+	print_header("map_filter lookups");
+	hit_ratios(keys, lookups);
+	print_header("bloom_filter at capacity");
+	false_positives(keys);
+}
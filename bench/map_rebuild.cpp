@@ -0,0 +1,123 @@
+#include "bench.hpp"
+#include <vector>
+#include <algorithm>
+#include <time.h>
+#include "../includes/map_rebuild.hpp"
+
+typedef ft::map<long, long> long_map;
+
+/*
+** Monotonic clock in nanoseconds, fine enough to time one operation.
+*/
+static long nanoseconds(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (ts.tv_sec * 1000000000L + ts.tv_nsec);
+}
+
+/*
+** Prints the median, 99th percentile and worst latency, in microseconds.
+*/
+static void latencies(std::string name, std::vector<long> &samples)
+{
+	std::string margin(name.length() < 38 ? 38 - name.length() : 1, ' ');
+
+	std::sort(samples.begin(), samples.end());
+	std::cout << name << ": " << margin << std::fixed << std::setprecision(2)
+		<< "p50 " << samples[samples.size() / 2] / 1e3 << " us, p99 "
+		<< samples[samples.size() * 99 / 100] / 1e3 << " us, max "
+		<< samples.back() / 1e3 << " us (" << samples.size() << " ops)" << std::endl;
+}
+
+/*
+** One foreground operation: 95% lookups, 5% writes split between inserts
+** and erases.
+*/
+static void operation(ft::map_rebuild<long_map> &r, bench_rng &rng, size_t keys, long &sum)
+{
+	unsigned long x = rng.next();
+	long key = static_cast<long>((x >> 16) % keys);
+	long value;
+
+	if (x % 100 < 5)
+	{
+		if ((x >> 8) & 1)
+			r.insert_or_assign(ft::make_pair(key, key));
+		else
+			r.erase(key);
+	}
+	else if (r.find(key, value))
+		sum += value;
+}
+
+/*
+** Foreground latency on a churned map: idle, while a background rebuild
+** runs until it is swapped in, and the stall of a blocking compact().
+*/
+static void foreground(size_t keys, size_t ops)
+{
+	long_map m;
+	ft::map_rebuild<long_map> r(m);
+	bench_rng rng(3);
+	std::vector<long> samples;
+	long sum = 0;
+	long start;
+
+	for (size_t i = 0; i < keys; i++)
+		m.insert(ft::make_pair(static_cast<long>((i * 2654435761UL) % keys), static_cast<long>(i)));
+	for (size_t i = 0; i < keys; i++)
+	{
+		long key = static_cast<long>(rng.next() % keys);
+		m.erase(key);
+		m.insert(ft::make_pair(key, key));
+	}
+	samples.reserve(ops);
+	for (size_t i = 0; i < ops; i++)
+	{
+		start = nanoseconds();
+		operation(r, rng, keys, sum);
+		samples.push_back(nanoseconds() - start);
+	}
+	latencies("idle", samples);
+	samples.clear();
+	start = nanoseconds();
+	r.start();
+	samples.push_back(nanoseconds() - start);
+	for (bool swapped = false; !swapped; )
+	{
+		start = nanoseconds();
+		operation(r, rng, keys, sum);
+		swapped = r.poll();
+		samples.push_back(nanoseconds() - start);
+	}
+	latencies("during background rebuild", samples);
+	r.finish();
+	samples.clear();
+	for (size_t i = 0; i < ops; i++)
+	{
+		start = nanoseconds();
+		operation(r, rng, keys, sum);
+		samples.push_back(nanoseconds() - start);
+	}
+	latencies("after rebuild", samples);
+	start = nanoseconds();
+	m.compact();
+	std::cout << "blocking compact() stall: " << std::string(14, ' ')
+		<< (nanoseconds() - start) / 1e6 << " ms" << std::endl;
+	if (sum == 42)
+		std::cout << std::endl;
+}
+
+/*
+** usage: map_rebuild [keys = 4e6] [ops = 1e6]
+*/
+void bench_map_rebuild(int argc, char **argv)
+{
+	size_t keys = arg_size(argc, argv, 0, 4000000);
+	size_t ops = arg_size(argc, argv, 1, 1000000);
+
+	print_header("map background rebuild");
+	foreground(keys, ops);
+}
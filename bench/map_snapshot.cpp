@@ -0,0 +1,115 @@
+#include "bench.hpp"
+#include <cstdio>
+#include <fcntl.h>
+#include "../includes/map.hpp"
+#include "../includes/map_snapshot.hpp"
+
+typedef ft::map<long, long> long_map;
+
+#define TEXT_PATH "map_snapshot.txt"
+#define SNAPSHOT_PATH "map_snapshot.bin"
+
+/*
+** Drops the pages of path from the page cache, so that the next load reads
+** the disk as after a restart. Linux only, elsewhere the loads are warm.
+*/
+static void evict(const char *path)
+{
+#ifdef __linux__
+	int fd = open(path, O_RDONLY);
+
+	if (fd >= 0)
+	{
+		fdatasync(fd);
+		posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+		close(fd);
+	}
+#else
+	(void) path;
+#endif
+}
+
+/*
+** Writes a map of keys entries as text lines and as a snapshot.
+*/
+static void save(size_t keys)
+{
+	long_map m;
+	std::ofstream text(TEXT_PATH);
+	double start;
+
+	for (size_t i = 0; i < keys; i++)
+		m.insert(ft::make_pair(static_cast<long>((i * 2654435761UL) % keys) * 3, static_cast<long>(i)));
+	start = now();
+	for (long_map::const_iterator it = m.begin(); it != m.end(); ++it)
+		text << it->first << ' ' << it->second << '\n';
+	text.close();
+	report("save as text", keys, now() - start);
+	start = now();
+	if (!ft::save_snapshot(m, SNAPSHOT_PATH))
+		std::cout << "save_snapshot failed" << std::endl;
+	report("save_snapshot()", keys, now() - start);
+}
+
+/*
+** Cold start from the text file, one insert() per line, as done before
+** snapshots.
+*/
+static void load_text(size_t keys)
+{
+	long_map m;
+	std::ifstream text(TEXT_PATH);
+	long key;
+	long value;
+	double start;
+
+	evict(TEXT_PATH);
+	start = now();
+	while (text >> key >> value)
+		m.insert(ft::make_pair(key, value));
+	report("text and insert()", keys, now() - start);
+	if (m.size() != keys)
+		std::cout << "text load: " << m.size() << " entries" << std::endl;
+}
+
+static void load_snapshot(size_t keys)
+{
+	long_map m;
+	double start;
+
+	evict(SNAPSHOT_PATH);
+	start = now();
+	if (!ft::load_snapshot(m, SNAPSHOT_PATH))
+		std::cout << "load_snapshot failed" << std::endl;
+	report("load_snapshot()", keys, now() - start);
+	if (m.size() != keys)
+		std::cout << "snapshot load: " << m.size() << " entries" << std::endl;
+}
+
+/*
+** usage: map_snapshot [keys = 1e8]
+** Writes its files in the current directory.
+*/
+void bench_map_snapshot(int argc, char **argv)
+{
+	size_t keys = arg_size(argc, argv, 0, 100000000);
+
+	print_header("map_snapshot cold start");
+	if (isolated())
+	{
+		save(keys);
+		_exit(0);
+	}
+	if (isolated())
+	{
+		load_text(keys);
+		_exit(0);
+	}
+	if (isolated())
+	{
+		load_snapshot(keys);
+		_exit(0);
+	}
+	std::remove(TEXT_PATH);
+	std::remove(SNAPSHOT_PATH);
+}
@@ -0,0 +1,153 @@
+#include "bench.hpp"
+#include <cstdio>
+#include <fcntl.h>
+#include "../includes/map.hpp"
+#include "../includes/map_snapshot.hpp"
+#include "../includes/mmap_map.hpp"
+
+typedef ft::map<long, long> long_map;
+typedef ft::mmap_map<long, long> long_mmap;
+
+#define MMAP_PATH "mmap_map.bin"
+#define SNAPSHOT_PATH "mmap_map.snapshot"
+
+/*
+** Drops the pages of path from the page cache, as after a restart. Linux
+** only, elsewhere the reopens are warm.
+*/
+static void evict(const char *path)
+{
+#ifdef __linux__
+	int fd = open(path, O_RDONLY);
+
+	if (fd >= 0)
+	{
+		fdatasync(fd);
+		posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+		close(fd);
+	}
+#else
+	(void) path;
+#endif
+}
+
+/*
+** Prints one result line in milliseconds, for the steps done once.
+*/
+static void report_time(std::string name, double seconds)
+{
+	std::string margin(name.length() < 38 ? 38 - name.length() : 1, ' ');
+	std::cout << name << ": " << margin << std::fixed << std::setprecision(3) << seconds * 1e3 << " ms" << std::endl;
+}
+
+static long key_of(size_t i, size_t keys)
+{
+	return (static_cast<long>((i * 2654435761UL) % keys) * 3);
+}
+
+/*
+** Inserts keys entries in random order into ft::map, saved as a snapshot,
+** and into a new mmap_map, checkpointed.
+*/
+static void build(size_t keys)
+{
+	long_map m;
+	double start;
+
+	start = now();
+	for (size_t i = 0; i < keys; i++)
+		m.insert(ft::make_pair(key_of(i, keys), static_cast<long>(i)));
+	report("ft::map insert()", keys, now() - start);
+	ft::save_snapshot(m, SNAPSHOT_PATH);
+	m.clear();
+	std::remove(MMAP_PATH);
+	long_mmap mm(MMAP_PATH);
+	start = now();
+	for (size_t i = 0; i < keys; i++)
+		mm.insert(ft::make_pair(key_of(i, keys), static_cast<long>(i)));
+	report("ft::mmap_map insert()", keys, now() - start);
+	start = now();
+	if (!mm.checkpoint())
+		std::cout << "checkpoint failed" << std::endl;
+	report_time("checkpoint()", now() - start);
+}
+
+/*
+** Random lookups of existing keys, summed so that none is optimized out.
+*/
+template <typename Map>
+static void lookups(std::string name, const Map &m, size_t keys, size_t count)
+{
+	bench_rng rng(50);
+	long sum = 0;
+	double start = now();
+
+	for (size_t i = 0; i < count; i++)
+		sum += m.find(key_of(rng.next() % keys, keys))->second;
+	report(name, count, now() - start);
+	if (sum == -1)
+		std::cout << sum << std::endl;
+}
+
+/*
+** Restart of ft::map from its snapshot, the fastest way it had to survive
+** one, then lookups.
+*/
+static void restart_map(size_t keys, size_t count)
+{
+	long_map m;
+	double start;
+
+	evict(SNAPSHOT_PATH);
+	start = now();
+	ft::load_snapshot(m, SNAPSHOT_PATH);
+	report_time("ft::map load_snapshot()", now() - start);
+	lookups("ft::map find()", m, keys, count);
+}
+
+/*
+** Restart of mmap_map from its file, then lookups faulting the pages in,
+** then the same lookups on warm pages.
+*/
+static void restart_mmap(size_t keys, size_t count)
+{
+	long_mmap mm;
+	double start;
+
+	evict(MMAP_PATH);
+	start = now();
+	if (!mm.open(MMAP_PATH) || mm.size() != keys)
+		std::cout << "reopen failed" << std::endl;
+	report_time("ft::mmap_map open()", now() - start);
+	lookups("ft::mmap_map find(), cold", mm, keys, count);
+	lookups("ft::mmap_map find(), warm", mm, keys, count);
+}
+
+/*
+** usage: mmap_map [keys = 1e8] [lookups = 1e7]
+** Writes its files in the current directory.
+*/
+void bench_mmap_map(int argc, char **argv)
+{
+	size_t keys = arg_size(argc, argv, 0, 100000000);
+	size_t count = arg_size(argc, argv, 1, 10000000);
+
+	print_header("mmap_map restarts");
+	if (isolated())
+	{
+		build(keys);
+		_exit(0);
+	}
+	if (isolated())
+	{
+		restart_map(keys, count);
+		_exit(0);
+	}
+	if (isolated())
+	{
+		restart_mmap(keys, count);
+		_exit(0);
+	}
+	std::remove(MMAP_PATH);
+	std::remove(SNAPSHOT_PATH);
+}
@@ -0,0 +1,109 @@
+#include "bench.hpp"
+#include <vector>
+#include "../includes/map.hpp"
+#include "../includes/radix_map.hpp"
+
+/*
+** URLs over a few hosts and API routes, so that they share long prefixes,
+** with ids spread enough for most of them to be distinct.
+*/
+static std::vector<std::string> make_urls(size_t count)
+{
+	static const char *hosts[8] = {"https://www.example.com", "https://api.example.com", "https://cdn.example.net",
+		"https://shop.example.org", "https://metrics.internal", "https://auth.example.com", "https://m.example.com", "http://legacy.example.com"};
+	static const char *resources[8] = {"users", "orders", "items", "sessions", "invoices", "products", "carts", "reviews"};
+	static const char *actions[4] = {"", "/edit", "/history", "/comments"};
+	std::vector<std::string> urls;
+	bench_rng rng(23);
+
+	urls.reserve(count);
+	for (size_t i = 0; i < count; i++)
+	{
+		unsigned long x = rng.next();
+		std::ostringstream url;
+
+		url << hosts[x % 8] << "/api/v" << (x >> 3) % 3 + 1 << "/" << resources[(x >> 5) % 8]
+			<< "/" << (x >> 8) % (count * 4) << actions[(x >> 40) % 4];
+		urls.push_back(url.str());
+	}
+	return (urls);
+}
+
+/*
+** Inserts the URLs, then measures resident bytes per entry, including the
+** copies of the keys, and random lookups of present URLs.
+*/
+template <typename Map>
+static void run(std::string name, const std::vector<std::string> &urls, size_t lookups)
+{
+	bench_rng rng(29);
+	size_t before = resident();
+	long sum = 0;
+	double start;
+
+	Map *m = new Map;
+	start = now();
+	for (size_t i = 0; i < urls.size(); i++)
+		m->insert(ft::make_pair(urls[i], static_cast<long>(i)));
+	report(name + " insert", urls.size(), now() - start);
+	std::cout << name << " memory: " << std::string(name.length() < 31 ? 31 - name.length() : 1, ' ')
+		<< (resident() - before) / m->size() << " bytes per entry (" << m->size() << " URLs)" << std::endl;
+	start = now();
+	for (size_t i = 0; i < lookups; i++)
+		sum += m->find(urls[rng.next() % urls.size()])->second;
+	report(name + " lookup", lookups, now() - start);
+	delete m;
+	if (sum == 42)
+		std::cout << std::endl;
+}
+
+/*
+** Counts the URLs under a few prefixes, from one host down to one resource.
+** Only for ft::radix_map: ft::map::lower_bound() walks the elements in order.
+*/
+static void prefixes(const std::vector<std::string> &urls)
+{
+	static const char *queries[3] = {"https://api.example.com/", "https://api.example.com/api/v2/", "https://api.example.com/api/v2/orders/1"};
+	ft::radix_map<std::string, long> m;
+
+	for (size_t i = 0; i < urls.size(); i++)
+		m.insert(ft::make_pair(urls[i], static_cast<long>(i)));
+	for (int q = 0; q < 3; q++)
+	{
+		double start = now();
+		size_t found = 0;
+
+		for (ft::pair<ft::radix_map<std::string, long>::iterator, ft::radix_map<std::string, long>::iterator> range = m.prefix_range(queries[q]);
+			range.first != range.second; ++range.first)
+			found++;
+		std::cout << "prefix_range(\"" << queries[q] << "\"): " << found << " URLs in "
+			<< std::fixed << std::setprecision(2) << (now() - start) * 1e3 << " ms" << std::endl;
+	}
+}
+
+/*
+** usage: radix_map [urls = 10e6] [lookups = 4e6]
+*/
+void bench_radix_map(int argc, char **argv)
+{
+	size_t count = arg_size(argc, argv, 0, 10000000);
+	size_t lookups = arg_size(argc, argv, 1, 4000000);
+	std::vector<std::string> urls = make_urls(count);
+
+	print_header("radix_map on URLs");
+	if (isolated())
+	{
+		run<ft::map<std::string, long> >("ft::map", urls, lookups);
+		_exit(0);
+	}
+	if (isolated())
+	{
+		run<ft::radix_map<std::string, long> >("ft::radix_map", urls, lookups);
+		_exit(0);
+	}
+	if (isolated())
+	{
+		prefixes(urls);
+		_exit(0);
+	}
+}
@@ -0,0 +1,121 @@
+#include "bench.hpp"
+#include "../includes/map.hpp"
+#include "../includes/skiplist_map.hpp"
+
+/*
+** Each thread inserts its share of keys spread over the whole range, then
+** every thread looks up random keys, half of them missing.
+*/
+
+struct workload
+{
+	ft::skiplist_map<int, int> *skiplist;
+	ft::map<int, int> *locked;
+	pthread_mutex_t *lock;
+	size_t first;
+	size_t last;
+	size_t range;
+	size_t lookups;
+	unsigned long seed;
+	char padding[64];
+};
+
+static int key_of(size_t i)
+{
+	return (static_cast<int>((i * 2654435761UL) % 2147483647UL));
+}
+
+static void *insert_skiplist(void *arg)
+{
+	workload *w = static_cast<workload *>(arg);
+	for (size_t i = w->first; i < w->last; i++)
+		w->skiplist->insert(ft::make_pair(key_of(i * 2), 0));
+	return (NULL);
+}
+
+static void *insert_locked(void *arg)
+{
+	workload *w = static_cast<workload *>(arg);
+	for (size_t i = w->first; i < w->last; i++)
+	{
+		pthread_mutex_lock(w->lock);
+		w->locked->insert(ft::make_pair(key_of(i * 2), 0));
+		pthread_mutex_unlock(w->lock);
+	}
+	return (NULL);
+}
+
+static void *find_skiplist(void *arg)
+{
+	workload *w = static_cast<workload *>(arg);
+	bench_rng rng(w->seed);
+	for (size_t i = 0; i < w->lookups; i++)
+		w->skiplist->count(key_of(rng.next() % w->range));
+	return (NULL);
+}
+
+static void *find_locked(void *arg)
+{
+	workload *w = static_cast<workload *>(arg);
+	bench_rng rng(w->seed);
+	for (size_t i = 0; i < w->lookups; i++)
+	{
+		pthread_mutex_lock(w->lock);
+		w->locked->count(key_of(rng.next() % w->range));
+		pthread_mutex_unlock(w->lock);
+	}
+	return (NULL);
+}
+
+static void run(std::string name, void *(*routine)(void *), workload &base, size_t threads, size_t keys, size_t ops)
+{
+	pthread_t ids[32];
+	workload w[32];
+	double start;
+
+	for (size_t i = 0; i < threads; i++)
+	{
+		w[i] = base;
+		w[i].first = keys * i / threads;
+		w[i].last = keys * (i + 1) / threads;
+		w[i].lookups = keys / threads;
+		w[i].seed = base.seed + i * 7919;
+	}
+	start = now();
+	for (size_t i = 0; i < threads; i++)
+		pthread_create(&ids[i], NULL, routine, &w[i]);
+	for (size_t i = 0; i < threads; i++)
+		pthread_join(ids[i], NULL);
+	report(name, ops, now() - start);
+}
+
+/*
+** usage: skiplist_map [keys = 1e6]
+*/
+void bench_skiplist_map(int argc, char **argv)
+{
+	size_t keys = arg_size(argc, argv, 0, 1000000);
+	pthread_mutex_t lock;
+	workload base;
+
+	pthread_mutex_init(&lock, NULL);
+	base.lock = &lock;
+	base.range = keys * 2;
+	base.seed = 42;
+	print_header("skiplist_map insert / lookup");
+	for (size_t threads = 1; threads <= 32; threads *= 2)
+	{
+		ft::skiplist_map<int, int> skiplist;
+		ft::map<int, int> locked;
+		std::ostringstream label;
+
+		base.skiplist = &skiplist;
+		base.locked = &locked;
+		label << " " << threads << " threads";
+		run("skiplist insert" + label.str(), &insert_skiplist, base, threads, keys, keys);
+		run("mutex + map insert" + label.str(), &insert_locked, base, threads, keys, keys);
+		run("skiplist find" + label.str(), &find_skiplist, base, threads, keys, keys / threads * threads);
+		run("mutex + map find" + label.str(), &find_locked, base, threads, keys, keys / threads * threads);
+	}
+	pthread_mutex_destroy(&lock);
+}
@@ -0,0 +1,55 @@
+#include "bench.hpp"
+#include "../includes/map.hpp"
+#include "../includes/small_map.hpp"
+
+/*
+** Creates a map, fills it with size entries, looks each of them up and
+** destroys it, the life of a per-request map of headers or tags.
+*/
+template <typename Map>
+static void cycles(std::string name, size_t size, size_t rounds)
+{
+	bench_rng rng(13);
+	long sum = 0;
+	double start = now();
+
+	for (size_t round = 0; round < rounds; round++)
+	{
+		Map m;
+		long base = static_cast<long>(rng.next() % 1000);
+
+		for (size_t i = 0; i < size; i++)
+			m.insert(ft::make_pair(base + static_cast<long>((i * 7) % size), static_cast<long>(i)));
+		for (size_t i = 0; i < size; i++)
+			sum += m.find(base + static_cast<long>(i))->second;
+	}
+	report(name, rounds, now() - start);
+	if (sum == 42)
+		std::cout << std::endl;
+}
+
+template <size_t N>
+static void sizes(size_t rounds)
+{
+	std::ostringstream label;
+
+	label << N << " entries";
+	cycles<ft::map<long, long> >("ft::map, " + label.str(), N, rounds);
+	cycles<ft::small_map<long, long, N> >("ft::small_map, " + label.str(), N, rounds);
+	cycles<ft::small_map<long, long, 16> >("ft::small_map<16>, " + label.str(), N, rounds);
+}
+
+/*
+** usage: small_map [cycles = 2e6]
+*/
+void bench_small_map(int argc, char **argv)
+{
+	size_t rounds = arg_size(argc, argv, 0, 2000000);
+
+	print_header("small_map life cycles");
+	sizes<4>(rounds);
+	sizes<8>(rounds);
+	sizes<16>(rounds);
+	cycles<ft::map<long, long> >("ft::map, 32 entries", 32, rounds / 4);
+	cycles<ft::small_map<long, long, 16> >("ft::small_map<16>, 32 entries", 32, rounds / 4);
+}
@@ -0,0 +1,62 @@
+#include "bench.hpp"
+#include "../includes/map.hpp"
+#include "../includes/unordered_map.hpp"
+
+#if defined(_LIBCPP_VERSION) || __cplusplus >= 201103L
+# include <unordered_map>
+typedef std::unordered_map<long, long> std_unordered_map;
+#else
+# include <tr1/unordered_map>
+typedef std::tr1::unordered_map<long, long> std_unordered_map;
+#endif
+
+/*
+** Inserts n pseudo-random keys, then looks up n keys that are all present
+** and n keys that are all missing.
+*/
+
+static long key_of(size_t i)
+{
+	return (static_cast<long>(i * 0x9E3779B97F4A7C15UL >> 1));
+}
+
+template <typename Map>
+static void run(std::string name, size_t n)
+{
+	Map m;
+	size_t found = 0;
+	double start;
+
+	start = now();
+	for (size_t i = 0; i < n; i++)
+		m[key_of(i * 2)] = static_cast<long>(i);
+	report(name + " insert", n, now() - start);
+	start = now();
+	for (size_t i = 0; i < n; i++)
+		found += m.count(key_of((i * 7919 % n) * 2));
+	report(name + " hit", n, now() - start);
+	start = now();
+	for (size_t i = 0; i < n; i++)
+		found += m.count(key_of((i * 7919 % n) * 2 + 1));
+	report(name + " miss", n, now() - start);
+	if (found != n)
+		std::cout << name << ": wrong lookups" << std::endl;
+}
+
+/*
+** usage: unordered_map [max keys = 1e7]
+*/
+void bench_unordered_map(int argc, char **argv)
+{
+	size_t max = arg_size(argc, argv, 0, 10000000);
+
+	for (size_t n = 1000; n <= max; n *= 10)
+	{
+		std::ostringstream label;
+		label << n << " keys";
+		print_header("unordered_map " + label.str());
+		run<ft::unordered_map<long, long> >("ft::unordered_map", n);
+		run<std_unordered_map>("std::unordered_map", n);
+		run<ft::map<long, long> >("ft::map", n);
+	}
+}
@@ -0,0 +1,290 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   aggregate_map.hpp                                  :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: mmosca <mmosca@student.42lyon.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2022/07/22 09:41:18 by mmosca            #+#    #+#             */
+/*   Updated: 2022/07/22 09:41:18 by mmosca           ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef FT_CONTAINERS_AGGREGATE_MAP_HPP
+#define FT_CONTAINERS_AGGREGATE_MAP_HPP
+
+#include <functional>
+#include "utility.hpp"
+#include "avl.hpp"
+
+namespace ft {
+
+	/**
+	 * Tree node caching the aggregate of the mapped values of its subtree under Op, recomputed with its height.
+	 */
+	template<typename U, typename V, class Op>
+	class AggregateNode : public Node<U, V> {
+	public:
+		/**
+		 * Member types
+		 */
+		typedef ft::pair<U, V> value_type;
+
+		/**
+		 * Member objects
+		 */
+		V aggregate;
+
+		/**
+		 * Constructor initialized value with value.
+		 * @param value value to initialized
+		 */
+		AggregateNode(const value_type &value) : Node<U, V>(value), aggregate(value.second) {}
+
+		/**
+		 * Updates the height and the aggregate from the children, left subtree first.
+		 */
+		void updateHeight() {
+			Node<U, V>::updateHeight();
+			aggregate = this->value.second;
+			if (this->left) {
+				aggregate = Op()(static_cast<AggregateNode *>(this->left)->aggregate, aggregate);
+			}
+			if (this->right) {
+				aggregate = Op()(aggregate, static_cast<AggregateNode *>(this->right)->aggregate);
+			}
+		}
+	};
+
+	/**
+	 * ft::aggregate_map is a sorted associative container answering aggregates of the mapped values over a range of keys in O(log n).
+	 * Every node caches the aggregate of its subtree, kept up to date by the insertions, erasures and rotations of the tree, so mapped values are only changed through assign().
+	 * @tparam Key the type of the keys
+	 * @tparam T the type of the mapped values
+	 * @tparam Op a default constructible associative binary operation on T
+	 */
+	template<class Key, class T, class Op = std::plus<T> >
+	class aggregate_map {
+	public:
+		/**
+		 * Member types
+		 */
+		typedef Key key_type;
+		typedef T mapped_type;
+		typedef ft::pair<Key, T> value_type;
+		typedef size_t size_type;
+		typedef Op operation_type;
+		typedef ft::AggregateNode<Key, T, Op> node_type;
+		typedef ft::avl_tree<Key, T, node_type> tree_type;
+		typedef ft::avl_iterator<node_type, const value_type> const_iterator;
+		typedef const_iterator iterator;
+
+		/**
+		 * Constructs an empty container.
+		 * @param identity the identity element of Op, the aggregate of an empty range
+		 */
+		explicit aggregate_map(const mapped_type &identity = mapped_type()) : _identity(identity) {}
+
+		/**
+		 * Copy constructor. Constructs the container with the copy of the contents of other.
+		 * @param other another container to be used as source to initialize the elements of the container with
+		 */
+		aggregate_map(const aggregate_map &other) : _identity(other._identity) {
+			for (const_iterator it = other.begin(); it != other.end(); ++it) {
+				_tree.insert(*it);
+			}
+		}
+
+		/**
+		 * Copy assignment operator. Replaces the contents with a copy of the contents of other.
+		 * @param other another container to use as data source
+		 * @return *this
+		 */
+		aggregate_map &operator=(const aggregate_map &other) {
+			if (this != &other) {
+				_tree.clear_tree();
+				_identity = other._identity;
+				for (const_iterator it = other.begin(); it != other.end(); ++it) {
+					_tree.insert(*it);
+				}
+			}
+			return *this;
+		}
+
+		/**
+		 * Returns an iterator to the first element. It is const: the elements are only modified through assign().
+		 * @return iterator to the first element
+		 */
+		const_iterator begin() const {
+			return _tree.begin();
+		}
+
+		/**
+		 * Returns an iterator to the element following the last element.
+		 * @return iterator to the element following the last element
+		 */
+		const_iterator end() const {
+			return _tree.end();
+		}
+
+		bool empty() const {
+			return _tree.isEmpty();
+		}
+
+		size_type size() const {
+			return _tree.getSize();
+		}
+
+		size_type count(const key_type &key) const {
+			return _tree.find(probe(key)) ? 1 : 0;
+		}
+
+		/**
+		 * Finds an element with key equivalent to key.
+		 * @param key key value of the element to search for
+		 * @return iterator to an element with key equivalent to key, or end()
+		 */
+		const_iterator find(const key_type &key) const {
+			return _tree.find_iterator(probe(key));
+		}
+
+		/**
+		 * Inserts value if the container doesn't already contain an element with an equivalent key.
+		 * @param value element value to insert
+		 * @return true if the insertion took place
+		 */
+		bool insert(const value_type &value) {
+			size_type previousSize = _tree.getSize();
+
+			_tree.insert(value);
+			return previousSize != _tree.getSize();
+		}
+
+		/**
+		 * Inserts value, or replaces the mapped value of the element with an equivalent key and updates the aggregates of its ancestors.
+		 * @param value element value to insert or assign
+		 * @return true if the insertion took place, false if the assignment took place
+		 */
+		bool assign(const value_type &value) {
+			node_type *node = _tree.find(value);
+
+			if (node == nullptr) {
+				_tree.insert(value);
+				return true;
+			}
+			node->value.second = value.second;
+			for (NodeBase *current = node; current != &_tree._header; current = current->parent) {
+				static_cast<node_type *>(current)->updateHeight();
+			}
+			return false;
+		}
+
+		/**
+		 * Removes the element (if one exists) with the key equivalent to key.
+		 * @param key key value of the elements to remove
+		 * @return Number of elements removed (0 or 1).
+		 */
+		size_type erase(const key_type &key) {
+			size_type previousSize = _tree.getSize();
+
+			_tree.remove(probe(key));
+			return previousSize - _tree.getSize();
+		}
+
+		/**
+		 * Erases all elements from the container.
+		 */
+		void clear() {
+			_tree.clear_tree();
+		}
+
+		/**
+		 * Returns the aggregate of the mapped values of all the elements.
+		 * @return the aggregate, the identity if the container is empty
+		 */
+		mapped_type aggregate() const {
+			return _tree.getRoot() ? _tree.getRoot()->aggregate : _identity;
+		}
+
+		/**
+		 * Returns the aggregate of the mapped values of the elements with keys in [lo, hi], in key order, in O(log n).
+		 * @param lo the smallest key of the range
+		 * @param hi the greatest key of the range
+		 * @return the aggregate, the identity if no key is in the range
+		 */
+		mapped_type aggregate(const key_type &lo, const key_type &hi) const {
+			const NodeBase *node = _tree.getRoot();
+
+			while (node) {
+				if (key(node) < lo) {
+					node = node->right;
+				} else if (hi < key(node)) {
+					node = node->left;
+				} else {
+					return Op()(Op()(from(node->left, lo), value(node)), until(node->right, hi));
+				}
+			}
+			return _identity;
+		}
+
+	private:
+		static value_type probe(const key_type &key) {
+			return ft::make_pair(key, mapped_type());
+		}
+
+		static const key_type &key(const NodeBase *node) {
+			return static_cast<const node_type *>(node)->value.first;
+		}
+
+		static const mapped_type &value(const NodeBase *node) {
+			return static_cast<const node_type *>(node)->value.second;
+		}
+
+		mapped_type total(const NodeBase *node) const {
+			return node ? static_cast<const node_type *>(node)->aggregate : _identity;
+		}
+
+		/**
+		 * Aggregate of the keys not less than lo in the subtree: along the search path, every node in the range adds itself and its whole right subtree.
+		 */
+		mapped_type from(const NodeBase *node, const key_type &lo) const {
+			mapped_type result = _identity;
+
+			while (node) {
+				if (key(node) < lo) {
+					node = node->right;
+				} else {
+					result = Op()(Op()(value(node), total(node->right)), result);
+					node = node->left;
+				}
+			}
+			return result;
+		}
+
+		/**
+		 * Aggregate of the keys not greater than hi in the subtree, mirroring from().
+		 */
+		mapped_type until(const NodeBase *node, const key_type &hi) const {
+			mapped_type result = _identity;
+
+			while (node) {
+				if (hi < key(node)) {
+					node = node->left;
+				} else {
+					result = Op()(result, Op()(total(node->left), value(node)));
+					node = node->right;
+				}
+			}
+			return result;
+		}
+
+		/**
+		 * Member objects
+		 */
+		tree_type _tree;
+		mapped_type _identity;
+	};
+
+}
+
+#endif //FT_CONTAINERS_AGGREGATE_MAP_HPP
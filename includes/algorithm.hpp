@@ -13,10 +13,122 @@
 #ifndef FT_CONTAINERS_ALGORITHM_HPP
 #define FT_CONTAINERS_ALGORITHM_HPP
 
+#include <cstring>
+#include "type_traits.hpp"
+
 namespace ft {
 
+	/**
+	 * Kinds of ranges the comparisons have a kernel for: any iterators, pointers to one integral type, whose equality is equality of their bytes, and pointers to unsigned bytes, whose order is also the order of memcmp.
+	 */
+	enum range_kind {
+		generic_range,
+		integral_range,
+		byte_range
+	};
+
+	template<class T, bool Integral = ft::is_integral<T>::value>
+	struct integral_range_kind {
+		static const range_kind value = generic_range;
+	};
+
+	template<class T>
+	struct integral_range_kind<T, true> {
+		static const range_kind value = (sizeof(T) == 1 && T(-1) > T(0)) ? byte_range : integral_range;
+	};
+
+	/**
+	 * The kernel for comparing the ranges of It1 and It2, pointers to the same type up to const.
+	 */
+	template<class It1, class It2>
+	struct range_kind_of {
+		static const range_kind value = generic_range;
+	};
+
+	template<class T>
+	struct range_kind_of<T *, T *> : public integral_range_kind<T> {};
+
+	template<class T>
+	struct range_kind_of<const T *, T *> : public integral_range_kind<T> {};
+
+	template<class T>
+	struct range_kind_of<T *, const T *> : public integral_range_kind<T> {};
+
+	template<class T>
+	struct range_kind_of<const T *, const T *> : public integral_range_kind<T> {};
+
+	template<range_kind Kind>
+	struct compare_kernel {
+		template<class InputIt1, class InputIt2>
+		static bool equal(InputIt1 first1, InputIt1 last1, InputIt2 first2) {
+			for (; first1 != last1; ++first1, ++first2) {
+				if (!(*first1 == *first2)) {
+					return false;
+				}
+			}
+			return true;
+		}
+
+		template<class InputIt1, class InputIt2>
+		static bool less(InputIt1 first1, InputIt1 last1, InputIt2 first2, InputIt2 last2) {
+			for ( ; (first1 != last1) && (first2 != last2); ++first1, (void) ++first2 ) {
+				if (*first1 < *first2) {
+					return true;
+				}
+				if (*first2 < *first1) {
+					return false;
+				}
+			}
+			return (first1 == last1) && (first2 != last2);
+		}
+	};
+
+	/**
+	 * Integers compare equal through memcmp. Their bytes are not in order of significance on little-endian machines, so the ordering skips the equal blocks through memcmp and compares the elements of the first different one.
+	 */
+	template<>
+	struct compare_kernel<integral_range> {
+		template<class T, class U>
+		static bool equal(T *first1, T *last1, U *first2) {
+			return first1 == last1 || first1 == first2 || std::memcmp(first1, first2, (last1 - first1) * sizeof(T)) == 0;
+		}
+
+		template<class T, class U>
+		static bool less(T *first1, T *last1, U *first2, U *last2) {
+			static const size_t block = 256 / sizeof(T);
+			size_t size = (last2 - first2) < (last1 - first1) ? last2 - first2 : last1 - first1;
+			size_t i = 0;
+
+			while (i + block <= size && std::memcmp(first1 + i, first2 + i, block * sizeof(T)) == 0) {
+				i += block;
+			}
+			for (; i < size; i++) {
+				if (first1[i] < first2[i]) {
+					return true;
+				}
+				if (first2[i] < first1[i]) {
+					return false;
+				}
+			}
+			return size < static_cast<size_t>(last2 - first2);
+		}
+	};
+
+	template<>
+	struct compare_kernel<byte_range> : public compare_kernel<integral_range> {
+		template<class T, class U>
+		static bool less(T *first1, T *last1, U *first2, U *last2) {
+			size_t size1 = last1 - first1;
+			size_t size2 = last2 - first2;
+			int order = (size1 == 0 || size2 == 0) ? 0 : std::memcmp(first1, first2, size1 < size2 ? size1 : size2);
+
+			return order < 0 || (order == 0 && size1 < size2);
+		}
+	};
+
 	/**
 	 * Returns true if the range [first1, last1) is equal to the range [first2, first2 + (last1 - first1)), and false otherwise.
+	 * Pointers to integers are compared with memcmp.
 	 * @param first the first range of the elements to compare
 	 * @param last the first range of the elements to compare
 	 * @param first2 the second range of the elements to compare
@@ -24,12 +136,7 @@ namespace ft {
 	 */
 	template<class InputIt1, class InputIt2>
 	bool equal(InputIt1 first1, InputIt1 last1, InputIt2 first2) {
-		for (; first1 != last1; ++first1, ++first2) {
-			if (!(*first1 == *first2)) {
-				return false;
-			}
-		}
-		return true;
+		return ft::compare_kernel<ft::range_kind_of<InputIt1, InputIt2>::value>::equal(first1, last1, first2);
 	}
 
 	/**
@@ -52,6 +159,7 @@ namespace ft {
 
 	/**
 	 * Checks if the first range [first1, last1) is lexicographically less than the second range [first2, last2).
+	 * Pointers to unsigned bytes are compared with memcmp, pointers to other integers skip their equal prefix with it.
 	 * @param first1 the first range of elements to examine
 	 * @param last1 the first range of elements to examine
 	 * @param first2 the second range of elements to examine
@@ -60,15 +168,7 @@ namespace ft {
 	 */
 	template<class InputIt1, class InputIt2>
 	bool lexicographical_compare(InputIt1 first1, InputIt1 last1, InputIt2 first2, InputIt2 last2) {
-		for ( ; (first1 != last1) && (first2 != last2); ++first1, (void) ++first2 ) {
-			if (*first1 < *first2) {
-				return true;
-			}
-			if (*first2 < *first1) {
-				return false;
-			}
-		}
-		return (first1 == last1) && (first2 != last2);
+		return ft::compare_kernel<ft::range_kind_of<InputIt1, InputIt2>::value>::less(first1, last1, first2, last2);
 	}
 
 	/**
@@ -0,0 +1,598 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   arena_avl.hpp                                      :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: mmosca <mmosca@student.42lyon.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2022/07/20 11:26:05 by mmosca            #+#    #+#             */
+/*   Updated: 2022/07/20 11:26:05 by mmosca           ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef FT_CONTAINERS_ARENA_AVL_HPP
+#define FT_CONTAINERS_ARENA_AVL_HPP
+
+#include <algorithm>
+#include <stdexcept>
+#include "iterator.hpp"
+#include "utility.hpp"
+#include "vector.hpp"
+
+namespace ft {
+
+	/**
+	 * Tree node stored in an arena and linked by 32 bit indices, 0 meaning no node.
+	 */
+	template<typename U, typename V>
+	class ArenaNode {
+	public:
+		/**
+		 * Member types
+		 */
+		typedef ft::pair<U, V> value_type;
+		typedef unsigned int index_type;
+
+		/**
+		 * Member objects
+		 */
+		value_type value;
+		index_type parent;
+		index_type left;
+		index_type right;
+		int height;
+
+		/**
+		 * Constructor initialized value with value.
+		 * @param value value to initialized
+		 */
+		ArenaNode(const value_type &value) : value(value), parent(0), left(0), right(0), height(1) {}
+	};
+
+	/**
+	 * Bidirectional iterator over an arena_avl_tree: the tree and an index, so it survives the arena moving in memory.
+	 * It does not follow its element through a swap of trees: it then reads the slot of the same index in the contents swapped in, and must be taken again.
+	 * @tparam Value the value type of the tree, const qualified for an iterator that cannot write through
+	 */
+	template<class Tree, class Value = typename Tree::value_type>
+	class arena_iterator : public ft::iterator<ft::bidirectional_iterator_tag, Value> {
+	public:
+		/**
+		 * Member types
+		 */
+		typedef Value value_type;
+		typedef typename Tree::index_type index_type;
+		typedef typename ft::iterator<ft::bidirectional_iterator_tag, value_type>::iterator_category iterator_category;
+		typedef typename ft::iterator<ft::bidirectional_iterator_tag, value_type>::difference_type difference_type;
+		typedef typename ft::iterator<ft::bidirectional_iterator_tag, value_type>::pointer pointer;
+		typedef typename ft::iterator<ft::bidirectional_iterator_tag, value_type>::reference reference;
+
+		/**
+		 * Member objects
+		 */
+		Tree *_tree;
+		index_type _index;
+
+		arena_iterator() : _tree(nullptr), _index(0) {}
+
+		arena_iterator(const Tree *tree, index_type index) : _tree(const_cast<Tree *>(tree)), _index(index) {}
+
+		/**
+		 * Copies a mutable iterator, into a const one if Value is const qualified.
+		 */
+		arena_iterator(const arena_iterator<Tree> &other) : _tree(other._tree), _index(other._index) {}
+
+		reference operator*() const {
+			return _tree->node(_index).value;
+		}
+
+		pointer operator->() const {
+			return &_tree->node(_index).value;
+		}
+
+		pointer base() const {
+			return &_tree->node(_index).value;
+		}
+
+		arena_iterator &operator++() {
+			_index = _tree->next(_index);
+			return *this;
+		}
+
+		arena_iterator operator++(int) {
+			arena_iterator tmp(*this);
+			_index = _tree->next(_index);
+			return tmp;
+		}
+
+		arena_iterator &operator--() {
+			_index = _tree->prev(_index);
+			return *this;
+		}
+
+		arena_iterator operator--(int) {
+			arena_iterator tmp(*this);
+			_index = _tree->prev(_index);
+			return tmp;
+		}
+
+		friend bool operator==(const arena_iterator &lhs, const arena_iterator &rhs) {
+			return lhs._index == rhs._index;
+		}
+
+		friend bool operator!=(const arena_iterator &lhs, const arena_iterator &rhs) {
+			return lhs._index != rhs._index;
+		}
+	};
+
+	/**
+	 * AVL tree whose nodes live in one contiguous arena and link to each other by 32 bit indices. Index i is the slot i - 1 of the arena, erased slots are chained in a free list and reused first.
+	 * Since no link is a pointer, the arena can be moved or written out as is.
+	 * It exposes the interface of ft::avl_tree and can be given to ft::map as its Tree.
+	 * @tparam U the type of the keys, default constructible
+	 * @tparam V the type of the mapped values, default constructible
+	 * @tparam Storage the arena, a vector-like sequence of ArenaNode providing size, operator[], push_back, clear and swap
+	 */
+	template<typename U, typename V, class Storage = ft::vector<ArenaNode<U, V> > >
+	class arena_avl_tree {
+	public:
+		/**
+		 * Member types
+		 */
+		typedef ft::pair<U, V> value_type;
+		typedef Storage storage_type;
+		typedef typename Storage::value_type node_type;
+		typedef typename node_type::index_type index_type;
+		typedef index_type node_pointer;
+		typedef ft::arena_iterator<arena_avl_tree> iterator;
+		typedef ft::arena_iterator<arena_avl_tree> const_iterator;
+		typedef size_t size_type;
+
+		/**
+		 * Constructor with the arena in parameter.
+		 * @param nodes arena to store the nodes into, empty
+		 */
+		arena_avl_tree(const storage_type &nodes = storage_type()) : _nodes(nodes), _root(0), _free(0), _size(0) {}
+
+		void clear_tree() {
+			_nodes.clear();
+			_root = 0;
+			_free = 0;
+			_size = 0;
+		}
+
+		/**
+		 * Rewrites the arena with the nodes in key order and no free slot, and rebuilds a perfectly balanced tree over it in O(n).
+		 */
+		void compact() {
+			storage_type nodes;
+
+			nodes.reserve(_size);
+			for (index_type index = begin()._index; index; index = next(index)) {
+				nodes.push_back(node_type(node(index).value));
+			}
+			_nodes.swap(nodes);
+			_free = 0;
+			_root = build(1, static_cast<index_type>(_size + 1));
+			if (_root) {
+				node(_root).parent = 0;
+			}
+		}
+
+		void insert(value_type value) {
+			_root = insert(value, _root);
+			node(_root).parent = 0;
+		}
+
+		void remove(value_type value) {
+			_root = remove(value, _root);
+			if (_root) {
+				node(_root).parent = 0;
+			}
+		}
+
+		bool isEmpty() const {
+			return _size == 0;
+		}
+
+		size_type getSize() const {
+			return _size;
+		}
+
+		size_type getMaxSize() const {
+			return std::min<size_type>(_nodes.max_size(), static_cast<index_type>(-1) - 1);
+		}
+
+		index_type find(value_type value) const {
+			index_type index = _root;
+
+			while (index && !(key(index) == value.first)) {
+				index = (key(index) < value.first) ? node(index).right : node(index).left;
+			}
+			return index;
+		}
+
+		/**
+		 * Looks up every key of [first, last) and writes the index holding it, or 0, to out, interleaving the descents like avl_tree::find_many.
+		 * @param first the range of keys to look up, traversed once
+		 * @param last the range of keys to look up
+		 * @param out the destination of the indices, in the order of the keys
+		 * @return out past the last index written
+		 */
+		template<class ForwardIt, class OutputIt>
+		OutputIt find_many(ForwardIt first, ForwardIt last, OutputIt out) const {
+			ForwardIt keys[batch_width];
+			index_type indices[batch_width];
+
+			while (first != last) {
+				size_t count = 0;
+
+				for (; count < batch_width && first != last; ++count, ++first) {
+					keys[count] = first;
+					indices[count] = _root;
+				}
+				for (bool moved = true; moved; ) {
+					moved = false;
+					for (size_t i = 0; i < count; i++) {
+						index_type index = indices[i];
+
+						if (index == 0 || key(index) == *keys[i]) {
+							continue;
+						}
+						index = (key(index) < *keys[i]) ? node(index).right : node(index).left;
+						if (index) {
+							__builtin_prefetch(&node(index));
+							moved = true;
+						}
+						indices[i] = index;
+					}
+				}
+				for (size_t i = 0; i < count; i++) {
+					*out++ = indices[i];
+				}
+			}
+			return out;
+		}
+
+		/**
+		 * Returns the index of the first node whose key is not less than the key of value, or 0.
+		 */
+		index_type lower_bound(const value_type &value) const {
+			index_type index = _root;
+			index_type bound = 0;
+
+			while (index) {
+				if (key(index) < value.first) {
+					index = node(index).right;
+				} else {
+					bound = index;
+					index = node(index).left;
+				}
+			}
+			return bound;
+		}
+
+		index_type getRoot() const {
+			return _root;
+		}
+
+		/**
+		 * Returns the head of the free list, which with the root, the size and the arena is the whole tree.
+		 */
+		index_type getFree() const {
+			return _free;
+		}
+
+		/**
+		 * Takes back the tree held by the arena, as it was when getRoot(), getFree() and getSize() were read, for an arena written out and opened again.
+		 * @param root the index of the root
+		 * @param free the head of the free list
+		 * @param size the number of nodes
+		 */
+		void restore(index_type root, index_type free, size_type size) {
+			_root = root;
+			_free = free;
+			_size = size;
+		}
+
+		iterator begin() const {
+			index_type index = _root;
+
+			while (index && node(index).left) {
+				index = node(index).left;
+			}
+			return iterator(this, index);
+		}
+
+		iterator end() const {
+			return iterator(this, 0);
+		}
+
+		/**
+		 * Returns an iterator to index, end() for 0.
+		 */
+		iterator make_iterator(index_type index) const {
+			return iterator(this, index);
+		}
+
+		/**
+		 * Returns an iterator to the node holding the key of value, or end().
+		 */
+		iterator find_iterator(const value_type &value) const {
+			return iterator(this, find(value));
+		}
+
+		void swap(arena_avl_tree &t) {
+			_nodes.swap(t._nodes);
+			std::swap(_root, t._root);
+			std::swap(_free, t._free);
+			std::swap(_size, t._size);
+		}
+
+		/**
+		 * Returns the arena, whose slots only hold indices and values.
+		 * @return the arena of the tree
+		 */
+		const storage_type &arena() const {
+			return _nodes;
+		}
+
+		storage_type &arena() {
+			return _nodes;
+		}
+
+		node_type &node(index_type index) {
+			return _nodes[index - 1];
+		}
+
+		const node_type &node(index_type index) const {
+			return _nodes[index - 1];
+		}
+
+		/**
+		 * Returns the in-order successor of index, 0 after the last node.
+		 */
+		index_type next(index_type index) const {
+			index_type parent;
+
+			if (node(index).right) {
+				index = node(index).right;
+				while (node(index).left) {
+					index = node(index).left;
+				}
+				return index;
+			}
+			parent = node(index).parent;
+			while (parent && node(parent).right == index) {
+				index = parent;
+				parent = node(parent).parent;
+			}
+			return parent;
+		}
+
+		/**
+		 * Returns the in-order predecessor of index, the last node for 0.
+		 */
+		index_type prev(index_type index) const {
+			index_type parent;
+
+			if (index == 0) {
+				index = _root;
+				while (index && node(index).right) {
+					index = node(index).right;
+				}
+				return index;
+			}
+			if (node(index).left) {
+				index = node(index).left;
+				while (node(index).right) {
+					index = node(index).right;
+				}
+				return index;
+			}
+			parent = node(index).parent;
+			while (parent && node(parent).left == index) {
+				index = parent;
+				parent = node(parent).parent;
+			}
+			return parent;
+		}
+
+	private:
+		/**
+		 * Number of descents find_many interleaves.
+		 */
+		static const size_t batch_width = 16;
+
+		const U &key(index_type index) const {
+			return node(index).value.first;
+		}
+
+		int height(index_type index) const {
+			return index ? node(index).height : 0;
+		}
+
+		void updateHeight(index_type index) {
+			node(index).height = 1 + std::max(height(node(index).left), height(node(index).right));
+		}
+
+		long balance(index_type index) const {
+			return height(node(index).left) - height(node(index).right);
+		}
+
+		/**
+		 * Takes a slot from the free list, or appends one to the arena.
+		 * @throw std::length_error if every index is taken
+		 */
+		index_type allocate(const value_type &value) {
+			index_type index = _free;
+
+			if (index) {
+				_free = node(index).left;
+				node(index) = node_type(value);
+				_size++;
+				return index;
+			}
+			if (_nodes.size() >= static_cast<size_type>(static_cast<index_type>(-1))) {
+				throw std::length_error("ft::arena_avl_tree: no index left");
+			}
+			_nodes.push_back(node_type(value));
+			_size++;
+			return static_cast<index_type>(_nodes.size());
+		}
+
+		/**
+		 * Chains index in the free list, its value reset to a default one so that what it held is released now rather than when the slot is reused.
+		 */
+		void release(index_type index) {
+			node(index) = node_type(value_type());
+			node(index).left = _free;
+			_free = index;
+			_size--;
+		}
+
+		/**
+		 * Links the nodes [first, last) into a perfectly balanced subtree.
+		 * @return the index of the root of the subtree
+		 */
+		index_type build(index_type first, index_type last) {
+			index_type middle = first + (last - first) / 2;
+			index_type child;
+
+			if (first == last) {
+				return 0;
+			}
+			child = build(first, middle);
+			node(middle).left = child;
+			if (child) {
+				node(child).parent = middle;
+			}
+			child = build(middle + 1, last);
+			node(middle).right = child;
+			if (child) {
+				node(child).parent = middle;
+			}
+			updateHeight(middle);
+			return middle;
+		}
+
+		/**
+		 * The arena may move while a node is allocated, so nodes are only referenced through their index across the recursive calls.
+		 */
+		index_type insert(const value_type &value, index_type index) {
+			index_type child;
+
+			if (index == 0) {
+				return allocate(value);
+			}
+			if (key(index) == value.first) {
+				return index;
+			}
+			if (key(index) < value.first) {
+				child = insert(value, node(index).right);
+				node(index).right = child;
+			} else {
+				child = insert(value, node(index).left);
+				node(index).left = child;
+			}
+			node(child).parent = index;
+			updateHeight(index);
+			return applyRotation(index);
+		}
+
+		index_type applyRotation(index_type index) {
+			long indexBalance = balance(index);
+
+			if (indexBalance < -1) {
+				if (balance(node(index).right) > 0) {
+					node(index).right = rightRotation(node(index).right);
+					node(node(index).right).parent = index;
+				}
+				return leftRotation(index);
+			} else if (indexBalance > 1) {
+				if (balance(node(index).left) < 0) {
+					node(index).left = leftRotation(node(index).left);
+					node(node(index).left).parent = index;
+				}
+				return rightRotation(index);
+			}
+			return index;
+		}
+
+		index_type leftRotation(index_type index) {
+			index_type right = node(index).right;
+			index_type center = node(right).left;
+
+			node(right).left = index;
+			node(index).parent = right;
+			node(index).right = center;
+			if (center) {
+				node(center).parent = index;
+			}
+			updateHeight(index);
+			updateHeight(right);
+			return right;
+		}
+
+		index_type rightRotation(index_type index) {
+			index_type left = node(index).left;
+			index_type center = node(left).right;
+
+			node(left).right = index;
+			node(index).parent = left;
+			node(index).left = center;
+			if (center) {
+				node(center).parent = index;
+			}
+			updateHeight(index);
+			updateHeight(left);
+			return left;
+		}
+
+		index_type remove(const value_type &value, index_type index) {
+			index_type child;
+
+			if (index == 0) {
+				return 0;
+			}
+			if (key(index) == value.first) {
+				if (node(index).left && node(index).right) {
+					index_type max = node(index).left;
+
+					while (node(max).right) {
+						max = node(max).right;
+					}
+					node(index).value = node(max).value;
+					child = remove(node(index).value, node(index).left);
+					node(index).left = child;
+				} else {
+					child = node(index).left ? node(index).left : node(index).right;
+					release(index);
+					return child;
+				}
+			} else if (key(index) < value.first) {
+				child = remove(value, node(index).right);
+				node(index).right = child;
+			} else {
+				child = remove(value, node(index).left);
+				node(index).left = child;
+			}
+			if (child) {
+				node(child).parent = index;
+			}
+			updateHeight(index);
+			return applyRotation(index);
+		}
+
+		/**
+		 * Member objects
+		 */
+		storage_type _nodes;
+		index_type _root;
+		index_type _free;
+		size_t _size;
+	};
+
+}
+
+#endif //FT_CONTAINERS_ARENA_AVL_HPP
@@ -0,0 +1,911 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   art.hpp                                            :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: mmosca <mmosca@student.42lyon.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2022/07/24 09:12:40 by mmosca            #+#    #+#             */
+/*   Updated: 2022/07/24 09:12:40 by mmosca           ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef FT_CONTAINERS_ART_HPP
+#define FT_CONTAINERS_ART_HPP
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include "utility.hpp"
+#include "iterator.hpp"
+
+#ifdef __SSE2__
+# include <emmintrin.h>
+#endif
+
+namespace ft {
+
+	/**
+	 * Bidirectional iterator over an ft::art_tree, walking the list linking its leaves in key order.
+	 */
+	template<class Tree>
+	class art_iterator : public ft::iterator<ft::bidirectional_iterator_tag, typename Tree::value_type> {
+	public:
+		/**
+		 * Member types
+		 */
+		typedef typename Tree::value_type value_type;
+		typedef typename Tree::leaf leaf;
+		typedef typename ft::iterator<ft::bidirectional_iterator_tag, value_type>::iterator_category iterator_category;
+		typedef typename ft::iterator<ft::bidirectional_iterator_tag, value_type>::difference_type difference_type;
+		typedef typename ft::iterator<ft::bidirectional_iterator_tag, value_type>::pointer pointer;
+		typedef typename ft::iterator<ft::bidirectional_iterator_tag, value_type>::reference reference;
+
+		/**
+		 * Member objects
+		 */
+		const Tree *_tree;
+		leaf *_leaf;
+
+		art_iterator() : _tree(nullptr), _leaf(nullptr) {}
+
+		art_iterator(const Tree *tree, leaf *leaf) : _tree(tree), _leaf(leaf) {}
+
+		reference operator*() const {
+			return _leaf->value;
+		}
+
+		pointer operator->() const {
+			return &_leaf->value;
+		}
+
+		pointer base() const {
+			return &_leaf->value;
+		}
+
+		art_iterator &operator++() {
+			_leaf = _leaf->next;
+			return *this;
+		}
+
+		art_iterator operator++(int) {
+			art_iterator tmp(*this);
+			_leaf = _leaf->next;
+			return tmp;
+		}
+
+		art_iterator &operator--() {
+			_leaf = _leaf ? _leaf->prev : _tree->last();
+			return *this;
+		}
+
+		art_iterator operator--(int) {
+			art_iterator tmp(*this);
+			--*this;
+			return tmp;
+		}
+
+		friend bool operator==(const art_iterator &lhs, const art_iterator &rhs) {
+			return lhs._leaf == rhs._leaf;
+		}
+
+		friend bool operator!=(const art_iterator &lhs, const art_iterator &rhs) {
+			return lhs._leaf != rhs._leaf;
+		}
+	};
+
+	/**
+	 * Adaptive radix tree: keys are split into bytes by Traits and every inner node branches on one byte, growing and shrinking between 4, 16, 48 and 256 children.
+	 * Chains of single children are compressed into a prefix of the node, of which the first max_prefix bytes are kept, the rest being read from any leaf below. A key ending at a node, a prefix of longer keys, is that node's terminal leaf.
+	 * Leaves are also linked in key order, so iteration does not go through the inner nodes. The byte order must agree with the operator< of the keys.
+	 * @tparam Key the type of the keys
+	 * @tparam T the type of the mapped values
+	 * @tparam Traits provides length(key) and byte(key, i), the bytes of the key, most significant first
+	 * @tparam Allocator an allocator rebound to allocate the leaves and the inner nodes
+	 */
+	template<class Key, class T, class Traits, class Allocator = std::allocator<ft::pair<const Key, T> > >
+	class art_tree {
+	public:
+		/**
+		 * Member types
+		 */
+		typedef ft::pair<Key, T> value_type;
+		typedef size_t size_type;
+		typedef ft::art_iterator<art_tree> iterator;
+		typedef ft::art_iterator<art_tree> const_iterator;
+
+		/**
+		 * Element of the tree, linked to its neighbours in key order.
+		 */
+		struct leaf {
+			value_type value;
+			leaf *prev;
+			leaf *next;
+
+			leaf(const value_type &value) : value(value), prev(nullptr), next(nullptr) {}
+		};
+
+		typedef typename Allocator::template rebind<leaf>::other leaf_allocator;
+
+		art_tree(const Allocator &alloc = Allocator()) : _alloc(alloc), _root(nullptr), _first(nullptr), _last(nullptr), _size(0) {}
+
+		~art_tree() {
+			clear();
+		}
+
+		void clear() {
+			leaf_allocator alloc(_alloc);
+
+			free_nodes(_root);
+			while (_first) {
+				leaf *next = _first->next;
+
+				alloc.destroy(_first);
+				alloc.deallocate(_first, 1);
+				_first = next;
+			}
+			_root = nullptr;
+			_last = nullptr;
+			_size = 0;
+		}
+
+		size_type size() const {
+			return _size;
+		}
+
+		leaf *first() const {
+			return _first;
+		}
+
+		leaf *last() const {
+			return _last;
+		}
+
+		/**
+		 * Returns the leaf holding key, or nullptr.
+		 */
+		leaf *find(const Key &key) const {
+			const node *n = _root;
+			size_t length = Traits::length(key);
+			size_t depth = 0;
+
+			while (n) {
+				const node *const *slot;
+
+				if (is_leaf(n)) {
+					return as_leaf(n)->value.first == key ? as_leaf(n) : nullptr;
+				}
+				if (n->prefix_length) {
+					if (depth + n->prefix_length > length || !stored_prefix_matches(n, key, depth)) {
+						return nullptr;
+					}
+					depth += n->prefix_length;
+				}
+				if (depth == length) {
+					return (n->terminal && n->terminal->value.first == key) ? n->terminal : nullptr;
+				}
+				slot = child(n, Traits::byte(key, depth));
+				n = slot ? *slot : nullptr;
+				depth++;
+			}
+			return nullptr;
+		}
+
+		/**
+		 * Returns the first leaf whose key is not less than key, or nullptr.
+		 */
+		leaf *lower_bound(const Key &key) const {
+			return lower_bound(_root, key, 0);
+		}
+
+		/**
+		 * Inserts value if its key is not in the tree yet.
+		 * @return the leaf holding the key, and true if the insertion took place
+		 */
+		ft::pair<leaf *, bool> insert(const value_type &value) {
+			leaf *next = lower_bound(value.first);
+			leaf *inserted;
+
+			if (next && next->value.first == value.first) {
+				return ft::make_pair(next, false);
+			}
+			inserted = insert(_root, value, 0);
+			inserted->next = next;
+			inserted->prev = next ? next->prev : _last;
+			if (inserted->prev) {
+				inserted->prev->next = inserted;
+			} else {
+				_first = inserted;
+			}
+			if (next) {
+				next->prev = inserted;
+			} else {
+				_last = inserted;
+			}
+			_size++;
+			return ft::make_pair(inserted, true);
+		}
+
+		/**
+		 * Removes the leaf holding key, if any.
+		 * @return true if a leaf was removed
+		 */
+		bool erase(const Key &key) {
+			leaf_allocator alloc(_alloc);
+			leaf *removed = nullptr;
+
+			if (!remove(_root, key, 0, removed)) {
+				return false;
+			}
+			(removed->prev ? removed->prev->next : _first) = removed->next;
+			(removed->next ? removed->next->prev : _last) = removed->prev;
+			alloc.destroy(removed);
+			alloc.deallocate(removed, 1);
+			_size--;
+			return true;
+		}
+
+		void swap(art_tree &other) {
+			std::swap(_alloc, other._alloc);
+			std::swap(_root, other._root);
+			std::swap(_first, other._first);
+			std::swap(_last, other._last);
+			std::swap(_size, other._size);
+		}
+
+	private:
+		art_tree(const art_tree &);
+		art_tree &operator=(const art_tree &);
+
+		/**
+		 * Number of prefix bytes kept in a node, enough for the whole prefix of 64 bit keys.
+		 */
+		static const size_t max_prefix = 8;
+
+		enum kind {
+			kind4,
+			kind16,
+			kind48,
+			kind256
+		};
+
+		/**
+		 * Header of the inner nodes. Child links to leaves are tagged with their low bit.
+		 */
+		struct node {
+			unsigned char kind;
+			unsigned short count;
+			unsigned int prefix_length;
+			unsigned char prefix[max_prefix];
+			leaf *terminal;
+		};
+
+		/**
+		 * Up to 4 children, keys sorted.
+		 */
+		struct node4 : node {
+			unsigned char keys[4];
+			node *children[4];
+		};
+
+		/**
+		 * Up to 16 children, keys sorted and compared at once with SSE2.
+		 */
+		struct node16 : node {
+			unsigned char keys[16];
+			node *children[16];
+		};
+
+		/**
+		 * Up to 48 children, index maps a byte to its slot plus one.
+		 */
+		struct node48 : node {
+			unsigned char index[256];
+			node *children[48];
+		};
+
+		/**
+		 * One child per byte.
+		 */
+		struct node256 : node {
+			node *children[256];
+		};
+
+		static bool is_leaf(const node *n) {
+			return reinterpret_cast<size_t>(n) & 1;
+		}
+
+		static leaf *as_leaf(const node *n) {
+			return reinterpret_cast<leaf *>(reinterpret_cast<size_t>(n) & ~static_cast<size_t>(1));
+		}
+
+		static node *tag(leaf *l) {
+			return reinterpret_cast<node *>(reinterpret_cast<size_t>(l) | 1);
+		}
+
+		/**
+		 * Returns the link to the child of n for byte, or nullptr.
+		 */
+		static node *const *child(const node *n, unsigned char byte) {
+			return const_cast<node *const *>(child(const_cast<node *>(n), byte));
+		}
+
+		static node **child(node *n, unsigned char byte) {
+			switch (n->kind) {
+				case kind4: {
+					node4 *p = static_cast<node4 *>(n);
+
+					for (unsigned short i = 0; i < p->count; i++) {
+						if (p->keys[i] == byte) {
+							return p->children + i;
+						}
+					}
+					return nullptr;
+				}
+				case kind16: {
+					node16 *p = static_cast<node16 *>(n);
+#ifdef __SSE2__
+					int mask = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(static_cast<char>(byte)), _mm_loadu_si128(reinterpret_cast<const __m128i *>(p->keys)))) & ((1 << p->count) - 1);
+
+					return mask ? p->children + __builtin_ctz(mask) : nullptr;
+#else
+					for (unsigned short i = 0; i < p->count; i++) {
+						if (p->keys[i] == byte) {
+							return p->children + i;
+						}
+					}
+					return nullptr;
+#endif
+				}
+				case kind48: {
+					node48 *p = static_cast<node48 *>(n);
+
+					return p->index[byte] ? p->children + p->index[byte] - 1 : nullptr;
+				}
+				default: {
+					node256 *p = static_cast<node256 *>(n);
+
+					return p->children[byte] ? p->children + byte : nullptr;
+				}
+			}
+		}
+
+		/**
+		 * Returns the child of n with the smallest byte greater than byte, -1 for the first child, or nullptr.
+		 */
+		static node *next_child(const node *n, int byte) {
+			switch (n->kind) {
+				case kind4:
+				case kind16: {
+					const unsigned char *keys = n->kind == kind4 ? static_cast<const node4 *>(n)->keys : static_cast<const node16 *>(n)->keys;
+					node *const *children = n->kind == kind4 ? static_cast<const node4 *>(n)->children : static_cast<const node16 *>(n)->children;
+
+					for (unsigned short i = 0; i < n->count; i++) {
+						if (keys[i] > byte) {
+							return children[i];
+						}
+					}
+					return nullptr;
+				}
+				case kind48: {
+					const node48 *p = static_cast<const node48 *>(n);
+
+					for (int b = byte + 1; b < 256; b++) {
+						if (p->index[b]) {
+							return p->children[p->index[b] - 1];
+						}
+					}
+					return nullptr;
+				}
+				default: {
+					const node256 *p = static_cast<const node256 *>(n);
+
+					for (int b = byte + 1; b < 256; b++) {
+						if (p->children[b]) {
+							return p->children[b];
+						}
+					}
+					return nullptr;
+				}
+			}
+		}
+
+		/**
+		 * Returns the leaf with the smallest key below n.
+		 */
+		static leaf *minimum(const node *n) {
+			while (!is_leaf(n)) {
+				if (n->terminal) {
+					return n->terminal;
+				}
+				n = next_child(n, -1);
+			}
+			return as_leaf(n);
+		}
+
+		/**
+		 * Checks the kept prefix bytes of n against key, the others are checked at the leaf.
+		 */
+		static bool stored_prefix_matches(const node *n, const Key &key, size_t depth) {
+			size_t stop = n->prefix_length < max_prefix ? n->prefix_length : max_prefix;
+
+			for (size_t i = 0; i < stop; i++) {
+				if (n->prefix[i] != Traits::byte(key, depth + i)) {
+					return false;
+				}
+			}
+			return true;
+		}
+
+		/**
+		 * Returns the index of the first byte of the prefix of n differing from key, prefix_length if none.
+		 */
+		static size_t prefix_mismatch(const node *n, const Key &key, size_t depth) {
+			size_t length = Traits::length(key);
+			size_t stop = n->prefix_length < max_prefix ? n->prefix_length : max_prefix;
+			size_t i = 0;
+
+			for (; i < stop; i++) {
+				if (depth + i == length || n->prefix[i] != Traits::byte(key, depth + i)) {
+					return i;
+				}
+			}
+			if (n->prefix_length > max_prefix) {
+				const Key &other = minimum(n)->value.first;
+
+				for (; i < n->prefix_length; i++) {
+					if (depth + i == length || Traits::byte(other, depth + i) != Traits::byte(key, depth + i)) {
+						return i;
+					}
+				}
+			}
+			return i;
+		}
+
+		static void set_prefix(node *n, const Key &key, size_t depth, size_t length) {
+			n->prefix_length = static_cast<unsigned int>(length);
+			for (size_t i = 0; i < length && i < max_prefix; i++) {
+				n->prefix[i] = Traits::byte(key, depth + i);
+			}
+		}
+
+		leaf *lower_bound(const node *n, const Key &key, size_t depth) const {
+			size_t length = Traits::length(key);
+			const node *const *slot;
+			const node *next;
+
+			if (n == nullptr) {
+				return nullptr;
+			}
+			if (is_leaf(n)) {
+				return as_leaf(n)->value.first < key ? nullptr : as_leaf(n);
+			}
+			if (n->prefix_length) {
+				const Key *full = n->prefix_length > max_prefix ? &minimum(n)->value.first : nullptr;
+
+				for (size_t i = 0; i < n->prefix_length; i++) {
+					unsigned char byte;
+
+					if (depth + i == length) {
+						return minimum(n);
+					}
+					byte = full ? Traits::byte(*full, depth + i) : n->prefix[i];
+					if (byte != Traits::byte(key, depth + i)) {
+						return byte > Traits::byte(key, depth + i) ? minimum(n) : nullptr;
+					}
+				}
+				depth += n->prefix_length;
+			}
+			if (depth == length) {
+				return minimum(n);
+			}
+			slot = child(n, Traits::byte(key, depth));
+			if (slot) {
+				leaf *found = lower_bound(*slot, key, depth + 1);
+
+				if (found) {
+					return found;
+				}
+			}
+			next = next_child(n, Traits::byte(key, depth));
+			return next ? minimum(next) : nullptr;
+		}
+
+		leaf *make_leaf(const value_type &value) {
+			leaf_allocator alloc(_alloc);
+			leaf *l = alloc.allocate(1);
+
+			alloc.construct(l, leaf(value));
+			return l;
+		}
+
+		template<class Node>
+		Node *make_node(unsigned char kind) {
+			typename Allocator::template rebind<Node>::other alloc(_alloc);
+			Node *n = alloc.allocate(1);
+
+			std::memset(static_cast<void *>(n), 0, sizeof(Node));
+			n->kind = kind;
+			return n;
+		}
+
+		template<class Node>
+		void release_node(Node *n) {
+			typename Allocator::template rebind<Node>::other alloc(_alloc);
+
+			alloc.deallocate(n, 1);
+		}
+
+		void release(node *n) {
+			switch (n->kind) {
+				case kind4:
+					release_node(static_cast<node4 *>(n));
+					break;
+				case kind16:
+					release_node(static_cast<node16 *>(n));
+					break;
+				case kind48:
+					release_node(static_cast<node48 *>(n));
+					break;
+				default:
+					release_node(static_cast<node256 *>(n));
+			}
+		}
+
+		/**
+		 * Releases the inner nodes below n, the leaves are released through their list.
+		 */
+		void free_nodes(node *n) {
+			if (n == nullptr || is_leaf(n)) {
+				return;
+			}
+			switch (n->kind) {
+				case kind4:
+					for (unsigned short i = 0; i < n->count; i++) {
+						free_nodes(static_cast<node4 *>(n)->children[i]);
+					}
+					break;
+				case kind16:
+					for (unsigned short i = 0; i < n->count; i++) {
+						free_nodes(static_cast<node16 *>(n)->children[i]);
+					}
+					break;
+				case kind48:
+					for (int i = 0; i < 48; i++) {
+						free_nodes(static_cast<node48 *>(n)->children[i]);
+					}
+					break;
+				default:
+					for (int i = 0; i < 256; i++) {
+						free_nodes(static_cast<node256 *>(n)->children[i]);
+					}
+			}
+			release(n);
+		}
+
+		static void copy_header(node *to, const node *from) {
+			to->count = from->count;
+			to->prefix_length = from->prefix_length;
+			std::memcpy(to->prefix, from->prefix, max_prefix);
+			to->terminal = from->terminal;
+		}
+
+		/**
+		 * Adds child under byte to the node at ref, growing it into the next kind when full.
+		 */
+		void add_child(node *&ref, unsigned char byte, node *child) {
+			node *n = ref;
+
+			if (n->kind == kind4 || n->kind == kind16) {
+				unsigned short capacity = n->kind == kind4 ? 4 : 16;
+				unsigned char *keys = n->kind == kind4 ? static_cast<node4 *>(n)->keys : static_cast<node16 *>(n)->keys;
+				node **children = n->kind == kind4 ? static_cast<node4 *>(n)->children : static_cast<node16 *>(n)->children;
+				unsigned short i = n->count;
+
+				if (n->count < capacity) {
+					for (; i > 0 && keys[i - 1] > byte; i--) {
+						keys[i] = keys[i - 1];
+						children[i] = children[i - 1];
+					}
+					keys[i] = byte;
+					children[i] = child;
+					n->count++;
+					return;
+				}
+				if (n->kind == kind4) {
+					node16 *grown = make_node<node16>(kind16);
+
+					copy_header(grown, n);
+					std::memcpy(grown->keys, keys, 4);
+					std::memcpy(grown->children, children, 4 * sizeof(node *));
+					ref = grown;
+				} else {
+					node48 *grown = make_node<node48>(kind48);
+
+					copy_header(grown, n);
+					for (unsigned short j = 0; j < 16; j++) {
+						grown->index[keys[j]] = static_cast<unsigned char>(j + 1);
+						grown->children[j] = children[j];
+					}
+					ref = grown;
+				}
+				release(n);
+				add_child(ref, byte, child);
+			} else if (n->kind == kind48) {
+				node48 *p = static_cast<node48 *>(n);
+
+				if (p->count < 48) {
+					unsigned short slot = 0;
+
+					while (p->children[slot]) {
+						slot++;
+					}
+					p->children[slot] = child;
+					p->index[byte] = static_cast<unsigned char>(slot + 1);
+					p->count++;
+					return;
+				}
+				node256 *grown = make_node<node256>(kind256);
+
+				copy_header(grown, p);
+				for (int b = 0; b < 256; b++) {
+					if (p->index[b]) {
+						grown->children[b] = p->children[p->index[b] - 1];
+					}
+				}
+				ref = grown;
+				release(n);
+				add_child(ref, byte, child);
+			} else {
+				static_cast<node256 *>(n)->children[byte] = child;
+				n->count++;
+			}
+		}
+
+		/**
+		 * Removes the child under byte from n, without shrinking it.
+		 */
+		static void remove_child(node *n, unsigned char byte) {
+			if (n->kind == kind4 || n->kind == kind16) {
+				unsigned char *keys = n->kind == kind4 ? static_cast<node4 *>(n)->keys : static_cast<node16 *>(n)->keys;
+				node **children = n->kind == kind4 ? static_cast<node4 *>(n)->children : static_cast<node16 *>(n)->children;
+				unsigned short i = 0;
+
+				while (keys[i] != byte) {
+					i++;
+				}
+				for (n->count--; i < n->count; i++) {
+					keys[i] = keys[i + 1];
+					children[i] = children[i + 1];
+				}
+			} else if (n->kind == kind48) {
+				node48 *p = static_cast<node48 *>(n);
+
+				p->children[p->index[byte] - 1] = nullptr;
+				p->index[byte] = 0;
+				p->count--;
+			} else {
+				static_cast<node256 *>(n)->children[byte] = nullptr;
+				n->count--;
+			}
+		}
+
+		/**
+		 * Shrinks the node at ref into the previous kind once it is sparse enough, with some slack against flapping, and replaces a node4 left with a single entry by that entry.
+		 */
+		void shrink(node *&ref) {
+			node *n = ref;
+
+			if (n->kind == kind256 && n->count <= 36) {
+				node256 *p = static_cast<node256 *>(n);
+				node48 *small = make_node<node48>(kind48);
+				unsigned short slot = 0;
+
+				copy_header(small, p);
+				for (int b = 0; b < 256; b++) {
+					if (p->children[b]) {
+						small->children[slot] = p->children[b];
+						small->index[b] = static_cast<unsigned char>(++slot);
+					}
+				}
+				ref = small;
+				release(n);
+			} else if (n->kind == kind48 && n->count <= 12) {
+				node48 *p = static_cast<node48 *>(n);
+				node16 *small = make_node<node16>(kind16);
+				unsigned short slot = 0;
+
+				copy_header(small, p);
+				for (int b = 0; b < 256; b++) {
+					if (p->index[b]) {
+						small->keys[slot] = static_cast<unsigned char>(b);
+						small->children[slot++] = p->children[p->index[b] - 1];
+					}
+				}
+				ref = small;
+				release(n);
+			} else if (n->kind == kind16 && n->count <= 3) {
+				node16 *p = static_cast<node16 *>(n);
+				node4 *small = make_node<node4>(kind4);
+
+				copy_header(small, p);
+				std::memcpy(small->keys, p->keys, p->count);
+				std::memcpy(small->children, p->children, p->count * sizeof(node *));
+				ref = small;
+				release(n);
+			} else if (n->kind == kind4 && n->count == 0 && n->terminal) {
+				ref = tag(n->terminal);
+				release(n);
+			} else if (n->kind == kind4 && n->count == 1 && !n->terminal) {
+				node4 *p = static_cast<node4 *>(n);
+				node *only = p->children[0];
+
+				if (!is_leaf(only)) {
+					unsigned char prefix[max_prefix];
+					size_t length = 0;
+
+					for (; length < p->prefix_length && length < max_prefix; length++) {
+						prefix[length] = p->prefix[length];
+					}
+					if (length < max_prefix) {
+						prefix[length++] = p->keys[0];
+					}
+					for (size_t i = 0; i < only->prefix_length && length < max_prefix; i++) {
+						prefix[length++] = only->prefix[i];
+					}
+					std::memcpy(only->prefix, prefix, length);
+					only->prefix_length += p->prefix_length + 1;
+				}
+				ref = only;
+				release(n);
+			}
+		}
+
+		/**
+		 * Adds l to the new node n, under its byte at depth, or as terminal if its key ends there.
+		 */
+		void attach(node *&n, leaf *l, size_t depth) {
+			if (Traits::length(l->value.first) == depth) {
+				n->terminal = l;
+			} else {
+				add_child(n, Traits::byte(l->value.first, depth), tag(l));
+			}
+		}
+
+		/**
+		 * Inserts value, whose key is not in the tree, below the link ref.
+		 * @return the new leaf
+		 */
+		leaf *insert(node *&ref, const value_type &value, size_t depth) {
+			const Key &key = value.first;
+			size_t length = Traits::length(key);
+			node **slot;
+			leaf *l;
+
+			if (ref == nullptr) {
+				l = make_leaf(value);
+				ref = tag(l);
+				return l;
+			}
+			if (is_leaf(ref)) {
+				leaf *existing = as_leaf(ref);
+				const Key &other = existing->value.first;
+				size_t common = 0;
+				node *split = make_node<node4>(kind4);
+
+				while (depth + common < length && depth + common < Traits::length(other) && Traits::byte(key, depth + common) == Traits::byte(other, depth + common)) {
+					common++;
+				}
+				set_prefix(split, key, depth, common);
+				l = make_leaf(value);
+				attach(split, existing, depth + common);
+				attach(split, l, depth + common);
+				ref = split;
+				return l;
+			}
+			if (ref->prefix_length) {
+				size_t mismatch = prefix_mismatch(ref, key, depth);
+
+				if (mismatch < ref->prefix_length) {
+					node *n = ref;
+					node *split = make_node<node4>(kind4);
+					size_t rest = n->prefix_length - mismatch - 1;
+					unsigned char byte;
+
+					set_prefix(split, key, depth, mismatch);
+					if (n->prefix_length > max_prefix) {
+						const Key &other = minimum(n)->value.first;
+
+						byte = Traits::byte(other, depth + mismatch);
+						set_prefix(n, other, depth + mismatch + 1, rest);
+					} else {
+						byte = n->prefix[mismatch];
+						std::memmove(n->prefix, n->prefix + mismatch + 1, rest);
+						n->prefix_length = static_cast<unsigned int>(rest);
+					}
+					add_child(split, byte, n);
+					l = make_leaf(value);
+					attach(split, l, depth + mismatch);
+					ref = split;
+					return l;
+				}
+				depth += ref->prefix_length;
+			}
+			if (depth == length) {
+				ref->terminal = make_leaf(value);
+				return ref->terminal;
+			}
+			slot = child(ref, Traits::byte(key, depth));
+			if (slot) {
+				return insert(*slot, value, depth + 1);
+			}
+			l = make_leaf(value);
+			add_child(ref, Traits::byte(key, depth), tag(l));
+			return l;
+		}
+
+		/**
+		 * Unlinks the leaf holding key below the link ref, shrinking the nodes on the way back up.
+		 * @return true if the leaf was found, and then stored in removed
+		 */
+		bool remove(node *&ref, const Key &key, size_t depth, leaf *&removed) {
+			size_t length = Traits::length(key);
+			unsigned char byte;
+			node **slot;
+
+			if (ref == nullptr) {
+				return false;
+			}
+			if (is_leaf(ref)) {
+				if (!(as_leaf(ref)->value.first == key)) {
+					return false;
+				}
+				removed = as_leaf(ref);
+				ref = nullptr;
+				return true;
+			}
+			if (ref->prefix_length) {
+				if (depth + ref->prefix_length > length || !stored_prefix_matches(ref, key, depth)) {
+					return false;
+				}
+				depth += ref->prefix_length;
+			}
+			if (depth == length) {
+				if (!ref->terminal || !(ref->terminal->value.first == key)) {
+					return false;
+				}
+				removed = ref->terminal;
+				ref->terminal = nullptr;
+				shrink(ref);
+				return true;
+			}
+			byte = Traits::byte(key, depth);
+			slot = child(ref, byte);
+			if (slot == nullptr) {
+				return false;
+			}
+			if (is_leaf(*slot)) {
+				if (!(as_leaf(*slot)->value.first == key)) {
+					return false;
+				}
+				removed = as_leaf(*slot);
+				remove_child(ref, byte);
+				shrink(ref);
+				return true;
+			}
+			return remove(*slot, key, depth + 1, removed);
+		}
+
+		/**
+		 * Member objects
+		 */
+		Allocator _alloc;
+		node *_root;
+		leaf *_first;
+		leaf *_last;
+		size_t _size;
+	};
+
+}
+
+#endif //FT_CONTAINERS_ART_HPP
@@ -20,33 +20,29 @@
 
 namespace ft {
 
-	template<typename U, typename V>
-	class Node {
+	/**
+	 * Links and height of a tree node. The header of a tree is a bare NodeBase of height 0: its parent is the root, its left and right the leftmost and rightmost nodes, and it stands for end().
+	 */
+	class NodeBase {
 	public:
-		/**
-		 * Member types
-		 */
-		typedef ft::pair<U, V> value_type;
-
 		/**
 		 * Member objects
 		 */
-		value_type value;
-		Node *parent;
-		Node *left;
-		Node *right;
+		NodeBase *parent;
+		NodeBase *left;
+		NodeBase *right;
 
 		/**
-		 * Constructor initialized value with value.
-		 * @param value value to initialized
+		 * Constructor, a height of 0 makes a header.
+		 * @param height height to initialize
 		 */
-		Node(const value_type &value) : value(value), left(nullptr), right(nullptr), _height(1) {}
+		explicit NodeBase(long height = 1) : parent(nullptr), left(nullptr), right(nullptr), _height(height) {}
 
 		/**
 		 * Returns the max value in the tree.
 		 * @return the max value in the tree
 		 */
-		Node *getMax() {
+		NodeBase *getMax() {
 			return right ? right->getMax() : this;
 		}
 
@@ -54,7 +50,7 @@ namespace ft {
 		 * Returns the min value in the tree.
 		 * @return the min value in the tree
 		 */
-		Node *getMin() {
+		NodeBase *getMin() {
 			return left ? left->getMin() : this;
 		}
 
@@ -81,13 +77,171 @@ namespace ft {
 			return (left ? left->_height : 0) - (right ? right->_height : 0);
 		}
 
-	private:
+		/**
+		 * Returns the in-order successor. Climbing from the rightmost node reaches the header, whose right link is that node.
+		 * @return the next node, or the header after the last node
+		 */
+		NodeBase *next() {
+			NodeBase *node = this;
+			NodeBase *parent;
+
+			if (node->right) {
+				node = node->right;
+				while (node->left) {
+					node = node->left;
+				}
+				return node;
+			}
+			parent = node->parent;
+			while (node == parent->right) {
+				node = parent;
+				parent = parent->parent;
+			}
+			return node->right != parent ? parent : node;
+		}
+
+		/**
+		 * Returns the in-order predecessor, the rightmost node from the header.
+		 * @return the previous node
+		 */
+		NodeBase *prev() {
+			NodeBase *node = this;
+			NodeBase *parent;
+
+			if (_height == 0) {
+				return right;
+			}
+			if (node->left) {
+				node = node->left;
+				while (node->right) {
+					node = node->right;
+				}
+				return node;
+			}
+			parent = node->parent;
+			while (node == parent->left) {
+				node = parent;
+				parent = parent->parent;
+			}
+			return parent;
+		}
+
+	protected:
 		/**
 		 * Member objects
 		 */
 		long _height;
 	};
 
+	template<typename U, typename V>
+	class Node : public NodeBase {
+	public:
+		/**
+		 * Member types
+		 */
+		typedef ft::pair<U, V> value_type;
+		typedef NodeBase base_type;
+
+		/**
+		 * Member objects
+		 */
+		value_type value;
+
+		/**
+		 * Constructor initialized value with value.
+		 * @param value value to initialized
+		 */
+		Node(const value_type &value) : NodeBase(), value(value) {}
+
+		/**
+		 * Key of a descent, made once and compared against every node on the way down.
+		 */
+		struct probe {
+			const U &key;
+
+			explicit probe(const U &key) : key(key) {}
+		};
+
+		/**
+		 * Compares the key of the node with the key of p.
+		 * @return a negative value if the key of the node is less, 0 if they are equal, a positive value otherwise
+		 */
+		int compare(const probe &p) const {
+			if (value.first == p.key) {
+				return 0;
+			}
+			return value.first < p.key ? -1 : 1;
+		}
+
+		/**
+		 * Replaces the value, through which a node type caching data derived from the key keeps it up to date.
+		 */
+		void assign(const value_type &other) {
+			value = other;
+		}
+	};
+
+	/**
+	 * Normalizes a string-like key, any type with size() and operator[], into its first 8 bytes, big-endian and zero padded.
+	 * A normalizer must preserve the order: a < b implies normalize(a) <= normalize(b).
+	 */
+	template<typename Key>
+	struct key_prefix {
+		unsigned long long operator()(const Key &key) const {
+			unsigned long long prefix = 0;
+
+			for (size_t i = 0; i < 8; i++) {
+				prefix = (prefix << 8) | (i < key.size() ? static_cast<unsigned char>(key[i]) : 0);
+			}
+			return prefix;
+		}
+	};
+
+	/**
+	 * Tree node caching a normalized prefix of its key inline. A descent compares the prefixes as integers and calls the comparison of the keys only on ties, so most levels do not touch the key, a string behind a pointer.
+	 * @tparam Prefix a default constructible normalizer, see ft::key_prefix
+	 */
+	template<typename U, typename V, class Prefix = ft::key_prefix<U> >
+	class PrefixNode : public Node<U, V> {
+	public:
+		/**
+		 * Member types
+		 */
+		typedef ft::pair<U, V> value_type;
+
+		/**
+		 * Member objects
+		 */
+		unsigned long long prefix;
+
+		/**
+		 * Constructor initialized value with value.
+		 * @param value value to initialized
+		 */
+		PrefixNode(const value_type &value) : Node<U, V>(value), prefix(Prefix()(value.first)) {}
+
+		/**
+		 * Key of a descent with its prefix, normalized once.
+		 */
+		struct probe : Node<U, V>::probe {
+			unsigned long long prefix;
+
+			explicit probe(const U &key) : Node<U, V>::probe(key), prefix(Prefix()(key)) {}
+		};
+
+		int compare(const probe &p) const {
+			if (prefix != p.prefix) {
+				return prefix < p.prefix ? -1 : 1;
+			}
+			return Node<U, V>::compare(p);
+		}
+
+		void assign(const value_type &other) {
+			this->value = other;
+			prefix = Prefix()(other.first);
+		}
+	};
+
 	template<typename U, typename V, class Node = Node<U, V>, class Allocator = std::allocator<Node> >
 	class avl_tree {
 	public:
@@ -97,6 +251,7 @@ namespace ft {
 		typedef ft::pair<U, V> value_type;
 		typedef Node node_type;
 		typedef Node* node_pointer;
+		typedef NodeBase* base_pointer;
 		typedef Allocator node_allocator;
 		typedef typename ft::avl_iterator<Node> iterator;
 		typedef typename ft::avl_iterator<Node> const_iterator;
@@ -105,15 +260,19 @@ namespace ft {
 		/**
 		 * Member objects
 		 */
-		node_pointer _root;
+		NodeBase _header;
 		node_allocator _alloc;
 		size_t _size;
+		node_pointer _block;
+		size_t _block_size;
 
 		/**
 		 * Constructor with allocator in parameter.
 		 * @param node_alloc allocator to set
 		 */
-		avl_tree(const node_allocator &node_alloc = node_allocator()) : _root(nullptr), _alloc(node_alloc), _size(0) {}
+		avl_tree(const node_allocator &node_alloc = node_allocator()) : _header(0), _alloc(node_alloc), _size(0), _block(nullptr), _block_size(0) {
+			set_root(nullptr);
+		}
 
 		/**
 		 * Destructor.
@@ -123,23 +282,202 @@ namespace ft {
 		}
 
 		void clear_tree() {
-			clear_tree(_root);
+			clear_tree(root());
+			release_block();
 			_size = 0;
-			_root = nullptr;
+			set_root(nullptr);
 		}
 
-		void insert(value_type value) {
-			_root = insert(value, _root);
-			reset_parents();
+		/**
+		 * Moves every node, in key order, into one block and rebuilds a perfectly balanced tree over it in O(n), so that scans walk memory forward.
+		 * Nodes later removed from the block are only destroyed: their slots are given back with the block by the next compact or clear.
+		 */
+		void compact() {
+			node_pointer block;
+			size_t size = _size;
+			size_t i = 0;
+
+			if (size == 0) {
+				return;
+			}
+			block = _alloc.allocate(size);
+			try {
+				for (base_pointer node = _header.left; node != &_header; node = node->next()) {
+					_alloc.construct(block + i, node_type(static_cast<node_pointer>(node)->value));
+					i++;
+				}
+			} catch (...) {
+				for (; i > 0; i--) {
+					_alloc.destroy(block + i - 1);
+				}
+				_alloc.deallocate(block, size);
+				throw;
+			}
+			clear_tree();
+			_block = block;
+			_block_size = size;
+			_size = size;
+			set_root(build(0, size));
 		}
 
-		void remove(value_type value) {
-			_root = remove(value, _root);
-			reset_parents();
+		void insert(const value_type &value) {
+			set_root(insert(value, probe(value.first), root()));
+		}
+
+		/**
+		 * Inserts the values of [first, last), sorted by key, keeping the elements already present and the first of equal keys.
+		 * A batch of m values smaller than about 4n / height goes through insert() value by value, the descents of neighbouring keys sharing the cached top of their path. A larger one is merged with the n nodes in one in-order pass and the tree relinked perfectly balanced in O(n + m), reusing every node. An empty tree takes the values in one block, as compact() leaves it.
+		 * @return the number of values inserted
+		 */
+		template<class ForwardIt>
+		size_type insert_sorted(ForwardIt first, ForwardIt last) {
+			size_type count = static_cast<size_type>(ft::distance(first, last));
+			size_type previousSize = _size;
+			std::allocator<base_pointer> alloc;
+			base_pointer *nodes;
+			base_pointer node = _header.left;
+			size_t n = 0;
+
+			if (_size == 0 && _block == nullptr && count > 0) {
+				node_pointer block = _alloc.allocate(count);
+
+				try {
+					for (; first != last; ++first) {
+						probe key((*first).first);
+
+						if (n > 0 && block[n - 1].compare(key) == 0) {
+							continue;
+						}
+						_alloc.construct(block + n, node_type(value_type((*first).first, (*first).second)));
+						n++;
+					}
+				} catch (...) {
+					for (; n > 0; n--) {
+						_alloc.destroy(block + n - 1);
+					}
+					_alloc.deallocate(block, count);
+					throw;
+				}
+				_block = block;
+				_block_size = count;
+				_size = n;
+				set_root(build(0, n));
+				return n;
+			}
+			if (count * static_cast<size_type>(root() ? root()->height() : 0) < _size * 4) {
+				for (; first != last; ++first) {
+					insert(value_type((*first).first, (*first).second));
+				}
+				return _size - previousSize;
+			}
+			nodes = alloc.allocate(_size + count);
+			try {
+				for (; first != last; ++first) {
+					probe key((*first).first);
+					int order = 1;
+					node_pointer added;
+
+					while (node != &_header && (order = static_cast<node_pointer>(node)->compare(key)) < 0) {
+						nodes[n++] = node;
+						node = node->next();
+					}
+					if ((node != &_header && order == 0) || (n > 0 && static_cast<node_pointer>(nodes[n - 1])->compare(key) == 0)) {
+						continue;
+					}
+					added = _alloc.allocate(1);
+					try {
+						_alloc.construct(added, node_type(value_type((*first).first, (*first).second)));
+					} catch (...) {
+						_alloc.deallocate(added, 1);
+						throw;
+					}
+					nodes[n++] = added;
+					_size++;
+				}
+			} catch (...) {
+				discard_merged(nodes, n);
+				alloc.deallocate(nodes, previousSize + count);
+				_size = previousSize;
+				throw;
+			}
+			for (; node != &_header; node = node->next()) {
+				nodes[n++] = node;
+			}
+			set_root(build(nodes, 0, n));
+			alloc.deallocate(nodes, previousSize + count);
+			return _size - previousSize;
+		}
+
+		void remove(const value_type &value) {
+			set_root(remove(probe(value.first), root()));
+		}
+
+		/**
+		 * Removes every element for which pred returns true, in one in-order pass evaluating pred once per element.
+		 * The first removed elements are unlinked one by one as the pass reaches them, while their path is still in cache, a node with two children taking in the value of its predecessor, the last survivor. Past about 4n / height of them, the rest are only collected, then destroyed at once and the survivors relinked perfectly balanced in O(n), reusing their nodes.
+		 * If pred throws, the elements it already chose are removed and the others kept before the exception is rethrown.
+		 * @param pred predicate called with each element, in key order
+		 * @return the number of elements removed
+		 */
+		template<class Pred>
+		size_type erase_if(Pred pred) {
+			size_type previousSize = _size;
+			std::allocator<base_pointer> alloc;
+			base_pointer *nodes;
+			base_pointer node = _header.left;
+			base_pointer next;
+			size_t height;
+			size_t kept = 0;
+			size_t doomed = _size;
+
+			if (_size == 0) {
+				return 0;
+			}
+			height = root()->height();
+			nodes = alloc.allocate(previousSize);
+			try {
+				for (; node != &_header; node = next) {
+					next = node->next();
+					if (!pred(static_cast<node_pointer>(node)->value)) {
+						nodes[kept++] = node;
+					} else if (doomed == previousSize && (previousSize - _size + 1) * height < previousSize * 4) {
+						bool inner = node->left && node->right;
+
+						set_root(remove(probe(static_cast<node_pointer>(node)->value.first), root()));
+						if (inner) {
+							nodes[kept - 1] = node;
+						}
+					} else {
+						nodes[--doomed] = node;
+					}
+				}
+			} catch (...) {
+				if (doomed < previousSize) {
+					for (; node != &_header; node = node->next()) {
+						nodes[kept++] = node;
+					}
+					for (size_t i = doomed; i < previousSize; i++) {
+						destroy_node(nodes[i]);
+					}
+					_size = kept;
+					set_root(build(nodes, 0, kept));
+				}
+				alloc.deallocate(nodes, previousSize);
+				throw;
+			}
+			if (doomed < previousSize) {
+				for (size_t i = doomed; i < previousSize; i++) {
+					destroy_node(nodes[i]);
+				}
+				_size = kept;
+				set_root(build(nodes, 0, kept));
+			}
+			alloc.deallocate(nodes, previousSize);
+			return previousSize - _size;
 		}
 
 		bool isEmpty() const {
-			return _root == nullptr;
+			return _size == 0;
 		}
 
 		size_type getSize() const {
@@ -150,81 +488,255 @@ namespace ft {
 			return _alloc.max_size();
 		}
 
-		node_pointer find(value_type value) const {
-			return find(value, _root);
+		node_pointer find(const value_type &value) const {
+			return find(probe(value.first), root());
+		}
+
+		/**
+		 * Looks up every key of [first, last) and writes the node holding it, or nullptr, to out.
+		 * The keys are taken batch_width at a time and their descents advance in lockstep, one level per round, prefetching the child each descent moves to so that the cache misses of a round overlap.
+		 * @param first the range of keys to look up, traversed once
+		 * @param last the range of keys to look up
+		 * @param out the destination of the nodes, in the order of the keys
+		 * @return out past the last node written
+		 */
+		template<class ForwardIt, class OutputIt>
+		OutputIt find_many(ForwardIt first, ForwardIt last, OutputIt out) const {
+			ForwardIt keys[batch_width];
+			base_pointer nodes[batch_width];
+
+			while (first != last) {
+				size_t count = 0;
+
+				for (; count < batch_width && first != last; ++count, ++first) {
+					keys[count] = first;
+					nodes[count] = root();
+				}
+				for (bool moved = true; moved; ) {
+					moved = false;
+					for (size_t i = 0; i < count; i++) {
+						base_pointer node = nodes[i];
+
+						if (node == nullptr || key(node) == *keys[i]) {
+							continue;
+						}
+						node = (key(node) < *keys[i]) ? node->right : node->left;
+						if (node) {
+							__builtin_prefetch(node);
+							moved = true;
+						}
+						nodes[i] = node;
+					}
+				}
+				for (size_t i = 0; i < count; i++) {
+					*out++ = static_cast<node_pointer>(nodes[i]);
+				}
+			}
+			return out;
 		}
 
 		node_pointer getRoot() const {
-			return _root;
+			return static_cast<node_pointer>(root());
 		}
 
 		iterator begin() {
-			return _root ? iterator(_root->getMin(), _root->getMin(), _root->getMax()) : iterator();
+			return iterator(_header.left);
 		}
 
 		const_iterator begin() const {
-			return _root ? const_iterator(_root->getMin(), _root->getMin(), _root->getMax()) : const_iterator();
+			return const_iterator(_header.left);
 		}
 
 		iterator end() {
-			return _root ? iterator(nullptr, _root->getMin(), _root->getMax()) : iterator();
+			return iterator(&_header);
 		}
 
 		const_iterator end() const {
-			return _root ? const_iterator(nullptr, _root->getMin(), _root->getMax()) : const_iterator();
+			return const_iterator(const_cast<base_pointer>(&_header));
 		}
 
-		void swap(avl_tree &t) {
-			node_type *tmpRoot = _root;
-			node_allocator tmpAllocator = _alloc;
-			size_t tmpSize = _size;
+		/**
+		 * Returns an iterator to node, or end() for nullptr.
+		 */
+		iterator make_iterator(node_pointer node) const {
+			return node ? iterator(node) : end();
+		}
 
-			_root = t._root;
-			_alloc = t._alloc;
-			_size = t._size;
+		/**
+		 * Returns an iterator to the node holding the key of value, or end().
+		 */
+		iterator find_iterator(const value_type &value) const {
+			return make_iterator(find(value));
+		}
 
-			t._root = tmpRoot;
-			t._alloc = tmpAllocator;
-			t._size = tmpSize;
+		/**
+		 * Returns an iterator to the node holding the key of value, or end(), searching from finger rather than from the root.
+		 */
+		iterator find_near(const_iterator finger, const value_type &value) const {
+			int order;
+			base_pointer node = seek(finger._node, probe(value.first), order);
+
+			return (node && order == 0) ? iterator(node) : end();
 		}
 
-	private:
-		node_pointer find(value_type value, node_pointer node) const {
+		/**
+		 * Returns an iterator to the first node whose key is not less than the key of value, or end(), searching from finger rather than from the root.
+		 */
+		iterator lower_bound_near(const_iterator finger, const value_type &value) const {
+			int order;
+			base_pointer node = seek(finger._node, probe(value.first), order);
+
 			if (node == nullptr) {
-				return nullptr;
-			} else if (node->value.first == value.first) {
-				return node;
+				return end();
+			}
+			return iterator(order < 0 ? node->next() : node);
+		}
+
+		void swap(avl_tree &t) {
+			std::swap(_header, t._header);
+			std::swap(_alloc, t._alloc);
+			std::swap(_size, t._size);
+			std::swap(_block, t._block);
+			std::swap(_block_size, t._block_size);
+			set_root(root());
+			t.set_root(t.root());
+		}
+
+	private:
+		/**
+		 * Number of descents find_many interleaves, enough to cover the memory latency without spilling the lanes out of registers and L1.
+		 */
+		static const size_t batch_width = 16;
+
+		typedef typename node_type::probe probe;
+
+		base_pointer root() const {
+			return _header.parent;
+		}
+
+		/**
+		 * Hangs root under the header and points the header to the leftmost and rightmost nodes.
+		 */
+		void set_root(base_pointer root) {
+			_header.parent = root;
+			if (root) {
+				root->parent = &_header;
+				_header.left = root->getMin();
+				_header.right = root->getMax();
 			} else {
-				return find(value, (node->value.first < value.first) ? node->right : node->left);
+				_header.left = &_header;
+				_header.right = &_header;
 			}
 		}
 
-		node_pointer insert(value_type value, node_pointer node) {
+		static const U &key(base_pointer node) {
+			return static_cast<node_pointer>(node)->value.first;
+		}
+
+		/**
+		 * Goes through Node so that a node type augmenting updateHeight keeps its data up to date.
+		 */
+		static void updateHeight(base_pointer node) {
+			static_cast<node_pointer>(node)->updateHeight();
+		}
+
+		/**
+		 * Finger search: climbs from finger while the parent is on the same side of the key, the subtree left behind holding no key closer to it, then descends.
+		 * Climbing out of a right subtree towards a greater key, or a left one towards a smaller key, passes a parent known to be on the same side without comparing it.
+		 * A key d elements away from finger is usually reached in O(log d) steps, the climb stopping below the common ancestor of both.
+		 * @param order set to the comparison of the returned node with the key
+		 * @return the node holding the key, or the last node of the search path, its in-order neighbour; nullptr for an empty tree
+		 */
+		base_pointer seek(base_pointer finger, const probe &key, int &order) const {
+			base_pointer node = finger;
+			base_pointer last = nullptr;
+
+			if (node == nullptr || node == &_header) {
+				node = root();
+			} else {
+				order = static_cast<node_pointer>(node)->compare(key);
+				if (order == 0) {
+					return node;
+				}
+				while (node->parent != &_header) {
+					base_pointer parent = node->parent;
+					int up;
+
+					if ((order < 0) == (node == parent->right)) {
+						node = parent;
+						continue;
+					}
+					up = static_cast<node_pointer>(parent)->compare(key);
+					if (up == 0) {
+						order = 0;
+						return parent;
+					}
+					if ((up < 0) != (order < 0)) {
+						break;
+					}
+					node = parent;
+				}
+			}
+			while (node) {
+				last = node;
+				order = static_cast<node_pointer>(node)->compare(key);
+				if (order == 0) {
+					return node;
+				}
+				node = order < 0 ? node->right : node->left;
+			}
+			return last;
+		}
+
+		node_pointer find(const probe &key, base_pointer node) const {
+			while (node) {
+				int order = static_cast<node_pointer>(node)->compare(key);
+
+				if (order == 0) {
+					return static_cast<node_pointer>(node);
+				}
+				node = order < 0 ? node->right : node->left;
+			}
+			return nullptr;
+		}
+
+		base_pointer insert(const value_type &value, const probe &key, base_pointer node) {
+			int order;
+
 			if (node == nullptr) {
 				node_pointer newNode = _alloc.allocate(1);
 				_alloc.construct(newNode, node_type(value));
 				_size++;
 				return newNode;
 			}
-			if (node->value.first == value.first) {
+			order = static_cast<node_pointer>(node)->compare(key);
+			if (order == 0) {
 				return node;
 			}
-			(node->value.first < value.first) ? node->right = insert(value, node->right) : node->left = insert(value, node->left);
-			node->updateHeight();
+			if (order < 0) {
+				node->right = insert(value, key, node->right);
+				node->right->parent = node;
+			} else {
+				node->left = insert(value, key, node->left);
+				node->left->parent = node;
+			}
+			updateHeight(node);
 			return applyRotation(node);
 		}
 
-		node_pointer applyRotation(node_pointer node) {
+		base_pointer applyRotation(base_pointer node) {
 			long balance = node->balance();
 
 			if (balance < -1) {
 				if (node->right && node->right->balance() > 0) {
 					node->right = rightRotation(node->right);
+					node->right->parent = node;
 				}
 				return leftRotation(node);
 			} else if (balance > 1) {
 				if (node->left && node->left->balance() < 0) {
 					node->left = leftRotation(node->left);
+					node->left->parent = node;
 				}
 				return rightRotation(node);
 			} else {
@@ -232,82 +744,165 @@ namespace ft {
 			}
 		}
 
-		node_pointer leftRotation(node_pointer node) {
-			node_pointer right = node->right;
-			node_pointer center = right->left;
+		base_pointer leftRotation(base_pointer node) {
+			base_pointer right = node->right;
+			base_pointer center = right->left;
 
 			right->left = node;
+			node->parent = right;
 			node->right = center;
-			node->updateHeight();
-			right->updateHeight();
+			if (center) {
+				center->parent = node;
+			}
+			updateHeight(node);
+			updateHeight(right);
 			return right;
 		}
 
-		node_pointer rightRotation(node_pointer node) {
-			node_pointer left = node->left;
-			node_pointer center = left->right;
+		base_pointer rightRotation(base_pointer node) {
+			base_pointer left = node->left;
+			base_pointer center = left->right;
 
 			left->right = node;
+			node->parent = left;
 			node->left = center;
-			node->updateHeight();
-			left->updateHeight();
+			if (center) {
+				center->parent = node;
+			}
+			updateHeight(node);
+			updateHeight(left);
 			return left;
 		}
 
-		node_pointer remove(value_type value, node_pointer node) {
+		base_pointer remove(const probe &key, base_pointer node) {
+			int order;
+
 			if (node == nullptr) {
 				return nullptr;
 			}
-			if (node->value.first == value.first) {
-				node_pointer tmp;
+			order = static_cast<node_pointer>(node)->compare(key);
+			if (order == 0) {
+				base_pointer tmp;
 
 				if (node->left != nullptr && node->right != nullptr) {
-					node->value = node->left->getMax()->value;
-					node->left = remove(node->value, node->left);
+					node_pointer current = static_cast<node_pointer>(node);
+
+					current->assign(static_cast<node_pointer>(node->left->getMax())->value);
+					node->left = remove(probe(current->value.first), node->left);
+					if (node->left) {
+						node->left->parent = node;
+					}
 				} else {
 					tmp = (node->left == nullptr) ? node->right : node->left;
-					_alloc.destroy(node);
-					_alloc.deallocate(node, 1);
+					destroy_node(node);
 					_size--;
 					return tmp;
 				}
+			} else if (order < 0) {
+				node->right = remove(key, node->right);
+				if (node->right) {
+					node->right->parent = node;
+				}
 			} else {
-				(node->value.first < value.first) ? node->right = remove(value, node->right) : node->left = remove(value, node->left);
+				node->left = remove(key, node->left);
+				if (node->left) {
+					node->left->parent = node;
+				}
 			}
-			node->updateHeight();
+			updateHeight(node);
 			return applyRotation(node);
 		}
 
-		void reset_parents() {
-			if (!_root) {
+		void clear_tree(base_pointer node) {
+			if (node == nullptr) {
 				return;
 			}
-			_root->parent = nullptr;
-			reset_parents(_root);
+			clear_tree(node->left);
+			clear_tree(node->right);
+			destroy_node(node);
 		}
 
-		void reset_parents(node_pointer node) {
-			if (node == nullptr) {
-				return;
+		/**
+		 * Destroys node, and deallocates it unless it lives in the block of compact.
+		 */
+		void destroy_node(base_pointer node) {
+			node_pointer current = static_cast<node_pointer>(node);
+
+			_alloc.destroy(current);
+			if (current < _block || current >= _block + _block_size) {
+				_alloc.deallocate(current, 1);
 			}
+		}
+
+		/**
+		 * Destroys the nodes of the first n of nodes that are not in the tree, the ones an interrupted merge added between its nodes, left linked as they were.
+		 */
+		void discard_merged(base_pointer *nodes, size_t n) {
+			base_pointer node = _header.left;
+
+			for (size_t i = 0; i < n; i++) {
+				if (nodes[i] == node) {
+					node = node->next();
+				} else {
+					destroy_node(nodes[i]);
+				}
+			}
+		}
+
+		void release_block() {
+			if (_block) {
+				_alloc.deallocate(_block, _block_size);
+				_block = nullptr;
+				_block_size = 0;
+			}
+		}
+
+		/**
+		 * Links the nodes [first, last) of nodes, in key order, into a perfectly balanced subtree, each middle node becoming the root of its halves.
+		 * @return the root of the subtree
+		 */
+		base_pointer build(base_pointer *nodes, size_t first, size_t last) {
+			size_t middle = first + (last - first) / 2;
+			base_pointer node;
+
+			if (first == last) {
+				return nullptr;
+			}
+			node = nodes[middle];
+			node->left = build(nodes, first, middle);
+			node->right = build(nodes, middle + 1, last);
 			if (node->left) {
 				node->left->parent = node;
 			}
 			if (node->right) {
 				node->right->parent = node;
 			}
-			reset_parents(node->left);
-			reset_parents(node->right);
+			updateHeight(node);
+			return node;
 		}
 
-		void clear_tree(node_pointer node) {
-			if (node == nullptr) {
-				return;
+		/**
+		 * Links the nodes [first, last) of the block into a perfectly balanced subtree, each middle node becoming the root of its halves.
+		 * @return the root of the subtree
+		 */
+		base_pointer build(size_t first, size_t last) {
+			size_t middle = first + (last - first) / 2;
+			base_pointer node;
+
+			if (first == last) {
+				return nullptr;
 			}
-			clear_tree(node->left);
-			clear_tree(node->right);
-			_alloc.destroy(node);
-			_alloc.deallocate(node, 1);
+			node = _block + middle;
+			node->left = build(first, middle);
+			node->right = build(middle + 1, last);
+			if (node->left) {
+				node->left->parent = node;
+			}
+			if (node->right) {
+				node->right->parent = node;
+			}
+			updateHeight(node);
+			return node;
 		}
 	};
 
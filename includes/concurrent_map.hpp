@@ -0,0 +1,667 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   concurrent_map.hpp                                 :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: mmosca <mmosca@student.42lyon.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2022/07/14 10:41:27 by mmosca            #+#    #+#             */
+/*   Updated: 2022/07/14 10:41:27 by mmosca           ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef FT_CONTAINERS_CONCURRENT_MAP_HPP
+#define FT_CONTAINERS_CONCURRENT_MAP_HPP
+
+#include <functional>
+#include <memory>
+#include <algorithm>
+#include <pthread.h>
+#include "utility.hpp"
+#include "iterator.hpp"
+#include "vector.hpp"
+#include "epoch.hpp"
+
+namespace ft {
+
+	/**
+	 * ft::concurrent_map is an ordered associative container safe to share between threads.
+	 * Every write builds a new version of the tree by path copying and publishes it atomically, readers never take a lock: they pin an epoch, read the published version and the nodes replaced by later writes are only released once no reader can see them anymore.
+	 * @tparam Key the type of the keys
+	 * @tparam T the type of the mapped values
+	 * @tparam Compare comparison function object used to order the keys
+	 * @tparam Allocator an allocator that is used to acquire/release memory and to construct/destroy the elements in that memory
+	 */
+	template<class Key, class T, class Compare = std::less<Key>, class Allocator = std::allocator<ft::pair<const Key, T> > >
+	class concurrent_map {
+	private:
+		/**
+		 * Member classes
+		 */
+		struct node {
+			ft::pair<const Key, T> value;
+			node *left;
+			node *right;
+			long height;
+			size_t generation;
+
+			node(const ft::pair<const Key, T> &value, node *left, node *right, size_t generation) : value(value), left(left), right(right), height(1), generation(generation) {}
+		};
+
+		struct version {
+			node *root;
+			size_t size;
+		};
+
+	public:
+		/**
+		 * Member types
+		 */
+		typedef Key key_type;
+		typedef T mapped_type;
+		typedef ft::pair<const Key, T> value_type;
+		typedef Compare key_compare;
+		typedef size_t size_type;
+		typedef ptrdiff_t difference_type;
+		typedef Allocator allocator_type;
+		typedef typename Allocator::template rebind<node>::other node_allocator;
+		typedef typename Allocator::template rebind<version>::other version_allocator;
+
+		/**
+		 * Constant forward iterator walking a published version of the tree with an explicit stack of ancestors.
+		 */
+		class const_iterator : public ft::iterator<ft::forward_iterator_tag, const value_type> {
+		public:
+			typedef const value_type &reference;
+			typedef const value_type *pointer;
+
+			const_iterator() : _depth(0) {}
+
+			reference operator*() const {
+				return _stack[_depth - 1]->value;
+			}
+
+			pointer operator->() const {
+				return &_stack[_depth - 1]->value;
+			}
+
+			const_iterator &operator++() {
+				const node *current = _stack[_depth - 1];
+
+				if (current->right) {
+					descend(current->right);
+					return *this;
+				}
+				_depth--;
+				while (_depth > 0 && _stack[_depth - 1]->right == current) {
+					current = _stack[--_depth];
+				}
+				return *this;
+			}
+
+			const_iterator operator++(int) {
+				const_iterator tmp(*this);
+				++*this;
+				return tmp;
+			}
+
+			friend bool operator==(const const_iterator &lhs, const const_iterator &rhs) {
+				return lhs.current() == rhs.current();
+			}
+
+			friend bool operator!=(const const_iterator &lhs, const const_iterator &rhs) {
+				return !(lhs == rhs);
+			}
+
+		private:
+			friend class concurrent_map;
+
+			static const size_type max_depth = 96;
+
+			const node *current() const {
+				return _depth ? _stack[_depth - 1] : nullptr;
+			}
+
+			void descend(const node *n) {
+				for (; n; n = n->left) {
+					_stack[_depth++] = n;
+				}
+			}
+
+			const node *_stack[max_depth];
+			size_type _depth;
+		};
+		typedef const_iterator iterator;
+
+		/**
+		 * Read-only view of the map as it was when the snapshot was taken. The calling thread stays pinned while the snapshot is alive, so a snapshot must be used and destroyed on the thread that took it.
+		 */
+		class snapshot {
+		public:
+			/**
+			 * Returns an iterator to the first element of the snapshot.
+			 * @return iterator to the first element
+			 */
+			const_iterator begin() const {
+				const_iterator it;
+
+				it.descend(_version->root);
+				return it;
+			}
+
+			/**
+			 * Returns an iterator to the element following the last element of the snapshot.
+			 * @return iterator to the element following the last element
+			 */
+			const_iterator end() const {
+				return const_iterator();
+			}
+
+			/**
+			 * Returns the number of elements in the snapshot.
+			 * @return the number of elements
+			 */
+			size_type size() const {
+				return _version->size;
+			}
+
+			/**
+			 * Checks if the snapshot has no elements.
+			 * @return true if the snapshot is empty, false otherwise
+			 */
+			bool empty() const {
+				return _version->size == 0;
+			}
+
+			/**
+			 * Returns the number of elements with key that compares equivalent to key, which is either 1 or 0.
+			 * @param key key value of the elements to count
+			 * @return number of elements with key that compares equivalent to key
+			 */
+			size_type count(const key_type &key) const {
+				return find(key) == end() ? 0 : 1;
+			}
+
+			/**
+			 * Finds an element with key equivalent to key.
+			 * @param key key value of the element to search for
+			 * @return iterator to an element with key equivalent to key, or end()
+			 */
+			const_iterator find(const key_type &key) const {
+				const_iterator it;
+
+				for (const node *n = _version->root; n; ) {
+					it._stack[it._depth++] = n;
+					if (_comp(key, n->value.first)) {
+						n = n->left;
+					} else if (_comp(n->value.first, key)) {
+						n = n->right;
+					} else {
+						return it;
+					}
+				}
+				return end();
+			}
+
+			/**
+			 * Returns an iterator pointing to the first element that is not less than key.
+			 * @param key key value to compare the elements to
+			 * @return iterator pointing to the first element that is not less than key
+			 */
+			const_iterator lower_bound(const key_type &key) const {
+				return bound(key, false);
+			}
+
+			/**
+			 * Returns an iterator pointing to the first element that is greater than key.
+			 * @param key key value to compare the elements to
+			 * @return iterator pointing to the first element that is greater than key
+			 */
+			const_iterator upper_bound(const key_type &key) const {
+				return bound(key, true);
+			}
+
+		private:
+			friend class concurrent_map;
+
+			snapshot(epoch_domain &domain, const version *v, const key_compare &comp) : _guard(domain), _version(v), _comp(comp) {}
+
+			snapshot &operator=(const snapshot &);
+
+			/**
+			 * Descends towards key and cuts the stack back to the path of the last candidate, the first node the bound holds for.
+			 */
+			const_iterator bound(const key_type &key, bool upper) const {
+				const_iterator it;
+				size_type keep = 0;
+
+				for (const node *n = _version->root; n; ) {
+					it._stack[it._depth++] = n;
+					if (upper ? _comp(key, n->value.first) : !_comp(n->value.first, key)) {
+						keep = it._depth;
+						n = n->left;
+					} else {
+						n = n->right;
+					}
+				}
+				it._depth = keep;
+				return it;
+			}
+
+			/**
+			 * Member objects
+			 */
+			epoch_domain::guard _guard;
+			const version *_version;
+			key_compare _comp;
+		};
+
+		/**
+		 * Constructs an empty container.
+		 * @param comp comparison function object to use for all comparisons of keys
+		 * @param alloc allocator to use for all memory allocations of this container
+		 */
+		concurrent_map(const key_compare &comp = key_compare(), const allocator_type &alloc = allocator_type()) : _alloc(alloc), _node_alloc(alloc), _version_alloc(alloc), _comp(comp), _domain(epoch_domain::shared()), _generation(0) {
+			pthread_mutex_init(&_lock, nullptr);
+			_current = make_version(nullptr, 0);
+		}
+
+		/**
+		 * Destructs the map. No thread may use it concurrently anymore.
+		 */
+		~concurrent_map() {
+			_domain.reclaim(this);
+			clear_tree(_current->root);
+			_version_alloc.deallocate(_current, 1);
+			pthread_mutex_destroy(&_lock);
+		}
+
+		/**
+		 * Returns the allocator associated with the container.
+		 * @return the associated allocator
+		 */
+		allocator_type get_allocator() const {
+			return _alloc;
+		}
+
+		/**
+		 * Takes a consistent read-only view of the map without taking any lock.
+		 * @return the snapshot
+		 */
+		snapshot get_snapshot() const {
+			_domain.pin();
+			snapshot s(_domain, __atomic_load_n(&_current, __ATOMIC_ACQUIRE), _comp);
+			_domain.unpin();
+			return s;
+		}
+
+		/**
+		 * Checks if the container has no elements.
+		 * @return true if the container is empty, false otherwise
+		 */
+		bool empty() const {
+			return size() == 0;
+		}
+
+		/**
+		 * Returns the number of elements in the container.
+		 * @return the number of elements in the container
+		 */
+		size_type size() const {
+			epoch_domain::guard guard(_domain);
+
+			return __atomic_load_n(&_current, __ATOMIC_ACQUIRE)->size;
+		}
+
+		/**
+		 * Returns the number of elements with key that compares equivalent to key, which is either 1 or 0.
+		 * @param key key value of the elements to count
+		 * @return number of elements with key that compares equivalent to key
+		 */
+		size_type count(const key_type &key) const {
+			epoch_domain::guard guard(_domain);
+
+			return lookup(key) ? 1 : 0;
+		}
+
+		/**
+		 * Copies the value mapped to key into value, without taking any lock.
+		 * @param key key value of the element to search for
+		 * @param value where the mapped value is copied
+		 * @return true if an element with key equivalent to key was found
+		 */
+		bool find(const key_type &key, mapped_type &value) const {
+			epoch_domain::guard guard(_domain);
+			const node *n = lookup(key);
+
+			if (!n) {
+				return false;
+			}
+			value = n->value.second;
+			return true;
+		}
+
+		/**
+		 * Inserts value if the container doesn't already contain an element with an equivalent key.
+		 * @param value element value to insert
+		 * @return true if the insertion took place
+		 */
+		bool insert(const value_type &value) {
+			return write(value, false);
+		}
+
+		/**
+		 * Inserts value, or replaces the mapped value of the element with an equivalent key.
+		 * @param value element value to insert or assign
+		 * @return true if the insertion took place, false if the assignment took place
+		 */
+		bool insert_or_assign(const value_type &value) {
+			return write(value, true);
+		}
+
+		/**
+		 * Removes the element (if one exists) with the key equivalent to key.
+		 * @param key key value of the elements to remove
+		 * @return Number of elements removed (0 or 1).
+		 */
+		size_type erase(const key_type &key) {
+			bool erased = false;
+			node *root;
+
+			pthread_mutex_lock(&_lock);
+			epoch_domain::guard guard(_domain);
+			_generation++;
+			root = remove(_current->root, key, erased);
+			if (erased) {
+				publish(root, _current->size - 1);
+			}
+			pthread_mutex_unlock(&_lock);
+			return erased ? 1 : 0;
+		}
+
+		/**
+		 * Erases all elements from the container.
+		 */
+		void clear() {
+			pthread_mutex_lock(&_lock);
+			epoch_domain::guard guard(_domain);
+			_generation++;
+			retire_tree(_current->root);
+			publish(nullptr, 0);
+			pthread_mutex_unlock(&_lock);
+		}
+
+		/**
+		 * Returns the function object that compares the keys.
+		 * @return the key comparison function object
+		 */
+		key_compare key_comp() const {
+			return _comp;
+		}
+
+	private:
+		concurrent_map(const concurrent_map &);
+		concurrent_map &operator=(const concurrent_map &);
+
+		/**
+		 * Descends the published version looking for key. The caller must be pinned.
+		 */
+		const node *lookup(const key_type &key) const {
+			const node *n = __atomic_load_n(&_current, __ATOMIC_ACQUIRE)->root;
+
+			while (n) {
+				if (_comp(key, n->value.first)) {
+					n = n->left;
+				} else if (_comp(n->value.first, key)) {
+					n = n->right;
+				} else {
+					return n;
+				}
+			}
+			return nullptr;
+		}
+
+		bool write(const value_type &value, bool assign) {
+			bool inserted = false;
+			bool changed = false;
+			node *root;
+
+			pthread_mutex_lock(&_lock);
+			epoch_domain::guard guard(_domain);
+			_generation++;
+			root = insert(_current->root, value, assign, inserted, changed);
+			if (changed) {
+				publish(root, _current->size + (inserted ? 1 : 0));
+			}
+			pthread_mutex_unlock(&_lock);
+			return inserted;
+		}
+
+		/**
+		 * Replaces the published version, then retires the previous version and the nodes this write replaced: readers pinned from now on can only reach the new version. Called with the write lock held.
+		 */
+		void publish(node *root, size_type size) {
+			version *previous = _current;
+
+			__atomic_store_n(&_current, make_version(root, size), __ATOMIC_RELEASE);
+			_domain.retire(previous, &delete_version, this);
+			for (typename ft::vector<node *>::iterator it = _replaced.begin(); it != _replaced.end(); it++) {
+				_domain.retire(*it, &delete_node, this);
+			}
+			_replaced.clear();
+		}
+
+		version *make_version(node *root, size_type size) {
+			version *v = _version_alloc.allocate(1);
+
+			v->root = root;
+			v->size = size;
+			return v;
+		}
+
+		node *create(const value_type &value, node *left, node *right) {
+			node *n = _node_alloc.allocate(1);
+
+			_node_alloc.construct(n, node(value, left, right, _generation));
+			update(n);
+			return n;
+		}
+
+		/**
+		 * Returns a node of the current write that can be modified in place: nodes created by this write are returned as is, published nodes are copied and retired once the write is published.
+		 */
+		node *own(node *n) {
+			node *copy;
+
+			if (n->generation == _generation) {
+				return n;
+			}
+			copy = create(n->value, n->left, n->right);
+			_replaced.push_back(n);
+			return copy;
+		}
+
+		static long height(const node *n) {
+			return n ? n->height : 0;
+		}
+
+		static void update(node *n) {
+			n->height = 1 + std::max(height(n->left), height(n->right));
+		}
+
+		node *leftRotation(node *n) {
+			node *right = own(n->right);
+
+			n->right = right->left;
+			right->left = n;
+			update(n);
+			update(right);
+			return right;
+		}
+
+		node *rightRotation(node *n) {
+			node *left = own(n->left);
+
+			n->left = left->right;
+			left->right = n;
+			update(n);
+			update(left);
+			return left;
+		}
+
+		/**
+		 * Rebalances an owned node whose children have just been replaced.
+		 */
+		node *applyRotation(node *n) {
+			long balance;
+
+			update(n);
+			balance = height(n->left) - height(n->right);
+			if (balance < -1) {
+				if (height(n->right->left) > height(n->right->right)) {
+					n->right = rightRotation(own(n->right));
+				}
+				return leftRotation(n);
+			} else if (balance > 1) {
+				if (height(n->left->right) > height(n->left->left)) {
+					n->left = leftRotation(own(n->left));
+				}
+				return rightRotation(n);
+			}
+			return n;
+		}
+
+		node *insert(node *n, const value_type &value, bool assign, bool &inserted, bool &changed) {
+			node *child;
+
+			if (!n) {
+				inserted = true;
+				changed = true;
+				return create(value, nullptr, nullptr);
+			}
+			if (_comp(value.first, n->value.first)) {
+				child = insert(n->left, value, assign, inserted, changed);
+				if (!changed) {
+					return n;
+				}
+				n = own(n);
+				n->left = child;
+			} else if (_comp(n->value.first, value.first)) {
+				child = insert(n->right, value, assign, inserted, changed);
+				if (!changed) {
+					return n;
+				}
+				n = own(n);
+				n->right = child;
+			} else {
+				if (!assign) {
+					return n;
+				}
+				changed = true;
+				child = create(value, n->left, n->right);
+				_replaced.push_back(n);
+				return child;
+			}
+			return applyRotation(n);
+		}
+
+		/**
+		 * Detaches the minimum of the subtree n, stores it in min and returns the new subtree.
+		 */
+		node *removeMin(node *n, node *&min) {
+			if (!n->left) {
+				min = n;
+				return n->right;
+			}
+			n = own(n);
+			n->left = removeMin(n->left, min);
+			return applyRotation(n);
+		}
+
+		node *remove(node *n, const key_type &key, bool &erased) {
+			node *child;
+
+			if (!n) {
+				return nullptr;
+			}
+			if (_comp(key, n->value.first)) {
+				child = remove(n->left, key, erased);
+				if (!erased) {
+					return n;
+				}
+				n = own(n);
+				n->left = child;
+			} else if (_comp(n->value.first, key)) {
+				child = remove(n->right, key, erased);
+				if (!erased) {
+					return n;
+				}
+				n = own(n);
+				n->right = child;
+			} else {
+				node *min;
+				node *right;
+
+				erased = true;
+				_replaced.push_back(n);
+				if (!n->left || !n->right) {
+					return n->left ? n->left : n->right;
+				}
+				right = removeMin(n->right, min);
+				child = create(min->value, n->left, right);
+				_replaced.push_back(min);
+				return applyRotation(child);
+			}
+			return applyRotation(n);
+		}
+
+		void retire_tree(node *n) {
+			if (!n) {
+				return;
+			}
+			retire_tree(n->left);
+			retire_tree(n->right);
+			_replaced.push_back(n);
+		}
+
+		void clear_tree(node *n) {
+			if (!n) {
+				return;
+			}
+			clear_tree(n->left);
+			clear_tree(n->right);
+			_node_alloc.destroy(n);
+			_node_alloc.deallocate(n, 1);
+		}
+
+		static void delete_node(void *context, void *ptr) {
+			concurrent_map *self = static_cast<concurrent_map *>(context);
+			node *n = static_cast<node *>(ptr);
+
+			self->_node_alloc.destroy(n);
+			self->_node_alloc.deallocate(n, 1);
+		}
+
+		static void delete_version(void *context, void *ptr) {
+			concurrent_map *self = static_cast<concurrent_map *>(context);
+
+			self->_version_alloc.deallocate(static_cast<version *>(ptr), 1);
+		}
+
+		/**
+		 * Member objects
+		 */
+		allocator_type _alloc;
+		node_allocator _node_alloc;
+		version_allocator _version_alloc;
+		key_compare _comp;
+		epoch_domain &_domain;
+		pthread_mutex_t _lock;
+		version *_current;
+		size_t _generation;
+		ft::vector<node *> _replaced;
+	};
+
+}
+
+#endif //FT_CONTAINERS_CONCURRENT_MAP_HPP
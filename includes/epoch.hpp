@@ -0,0 +1,338 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   epoch.hpp                                          :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: mmosca <mmosca@student.42lyon.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2022/07/14 10:02:11 by mmosca            #+#    #+#             */
+/*   Updated: 2022/07/14 10:02:11 by mmosca           ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef FT_CONTAINERS_EPOCH_HPP
+#define FT_CONTAINERS_EPOCH_HPP
+
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <pthread.h>
+
+namespace ft {
+
+	/**
+	 * ft::epoch_domain implements epoch-based memory reclamation: readers pin the current epoch while they hold pointers into a shared structure, writers retire the memory they unlinked and it is only released once every pinned reader has moved past the epoch of the retirement.
+	 * A domain holds a thread-specific key, of which a process has few, and a slot per thread: the containers share the one of shared() rather than each holding its own.
+	 */
+	class epoch_domain {
+	public:
+		/**
+		 * Member types
+		 */
+		typedef size_t size_type;
+		typedef void (*deleter_type)(void *context, void *ptr);
+
+		/**
+		 * Member constants
+		 */
+		static const size_type max_threads = 128;
+		static const size_type collect_threshold = 64;
+
+		/**
+		 * RAII helper pinning the calling thread in the domain for the lifetime of the guard.
+		 */
+		class guard {
+		public:
+			/**
+			 * Pins the calling thread in domain.
+			 * @param domain the domain to pin
+			 */
+			explicit guard(epoch_domain &domain) : _domain(domain) {
+				_domain.pin();
+			}
+
+			/**
+			 * Pins the calling thread once more in the domain of other.
+			 * @param other the guard to copy
+			 */
+			guard(const guard &other) : _domain(other._domain) {
+				_domain.pin();
+			}
+
+			/**
+			 * Unpins the calling thread.
+			 */
+			~guard() {
+				_domain.unpin();
+			}
+
+		private:
+			guard &operator=(const guard &);
+
+			/**
+			 * Member objects
+			 */
+			epoch_domain &_domain;
+		};
+
+		/**
+		 * Returns the domain shared by every container of the process, constructed on first use.
+		 * @return the shared domain
+		 */
+		static epoch_domain &shared() {
+			static epoch_domain domain;
+
+			return domain;
+		}
+
+		/**
+		 * Constructs an empty domain.
+		 */
+		epoch_domain() : _epoch(1), _alloc() {
+			for (size_type i = 0; i < max_threads; i++) {
+				_slots[i].epoch = 0;
+				_slots[i].depth = 0;
+				_slots[i].owned = 0;
+				_slots[i].busy = 0;
+				_slots[i].retired = nullptr;
+				_slots[i].count = 0;
+			}
+			if (pthread_key_create(&_key, &release_slot) != 0) {
+				throw std::runtime_error("ft::epoch_domain: pthread_key_create failed");
+			}
+		}
+
+		/**
+		 * Destructs the domain and releases every retired pointer. No thread may be pinned anymore.
+		 */
+		~epoch_domain() {
+			pthread_key_delete(_key);
+			for (size_type i = 0; i < max_threads; i++) {
+				release(_slots[i].retired);
+				_slots[i].retired = nullptr;
+			}
+		}
+
+		/**
+		 * Pins the calling thread in the current epoch. Pins nest.
+		 */
+		void pin() {
+			slot *s = current_slot();
+
+			if (s->depth++ == 0) {
+				__atomic_store_n(&s->epoch, __atomic_load_n(&_epoch, __ATOMIC_ACQUIRE), __ATOMIC_RELAXED);
+				__atomic_thread_fence(__ATOMIC_SEQ_CST);
+			}
+		}
+
+		/**
+		 * Unpins the calling thread once the outermost pin is released.
+		 */
+		void unpin() {
+			slot *s = current_slot();
+
+			if (--s->depth == 0) {
+				__atomic_store_n(&s->epoch, 0, __ATOMIC_RELEASE);
+			}
+		}
+
+		/**
+		 * Hands ptr over to the domain, deleter(context, ptr) is called once no pinned reader can reach it anymore.
+		 * The pointer must already be unreachable for readers pinning from now on.
+		 * @param ptr the pointer to retire
+		 * @param deleter the function releasing ptr
+		 * @param context the first argument given to deleter
+		 */
+		void retire(void *ptr, deleter_type deleter, void *context) {
+			slot *s = current_slot();
+			retired_node *node = _alloc.allocate(1);
+			size_type count;
+
+			node->ptr = ptr;
+			node->deleter = deleter;
+			node->context = context;
+			node->epoch = __atomic_load_n(&_epoch, __ATOMIC_ACQUIRE);
+			lock(s);
+			node->next = s->retired;
+			s->retired = node;
+			count = ++s->count;
+			unlock(s);
+			if (count >= collect_threshold) {
+				collect();
+			}
+		}
+
+		/**
+		 * Tries to advance the global epoch and releases what the calling thread retired two epochs ago or earlier.
+		 */
+		void collect() {
+			slot *s = current_slot();
+			retired_node **link = &s->retired;
+			size_type epoch;
+
+			try_advance();
+			epoch = __atomic_load_n(&_epoch, __ATOMIC_ACQUIRE);
+			lock(s);
+			while (*link) {
+				retired_node *node = *link;
+
+				if (node->epoch + 2 <= epoch) {
+					*link = node->next;
+					node->deleter(node->context, node->ptr);
+					_alloc.deallocate(node, 1);
+					s->count--;
+				} else {
+					link = &node->next;
+				}
+			}
+			unlock(s);
+		}
+
+		/**
+		 * Releases at once every pointer retired with context, whatever its epoch, for the owner of context being destroyed. No thread may still read what it retired.
+		 * @param context the context the pointers were retired with
+		 */
+		void reclaim(void *context) {
+			for (size_type i = 0; i < max_threads; i++) {
+				slot *s = &_slots[i];
+				retired_node **link = &s->retired;
+
+				lock(s);
+				while (*link) {
+					retired_node *node = *link;
+
+					if (node->context == context) {
+						*link = node->next;
+						node->deleter(node->context, node->ptr);
+						_alloc.deallocate(node, 1);
+						s->count--;
+					} else {
+						link = &node->next;
+					}
+				}
+				unlock(s);
+			}
+		}
+
+		/**
+		 * Returns the current global epoch.
+		 * @return the current global epoch
+		 */
+		size_type epoch() const {
+			return __atomic_load_n(&_epoch, __ATOMIC_ACQUIRE);
+		}
+
+	private:
+		/**
+		 * Member classes
+		 */
+		struct retired_node {
+			void *ptr;
+			deleter_type deleter;
+			void *context;
+			size_type epoch;
+			retired_node *next;
+		};
+
+		struct slot {
+			size_type epoch;
+			size_type depth;
+			int owned;
+			int busy;
+			retired_node *retired;
+			size_type count;
+			char padding[64];
+		};
+
+		epoch_domain(const epoch_domain &);
+		epoch_domain &operator=(const epoch_domain &);
+
+		/**
+		 * Returns the slot of the calling thread, claiming a free one on first use.
+		 * @return the slot of the calling thread
+		 */
+		slot *current_slot() {
+			slot *s = static_cast<slot *>(pthread_getspecific(_key));
+
+			if (s) {
+				return s;
+			}
+			for (size_type i = 0; i < max_threads; i++) {
+				int expected = 0;
+
+				if (__atomic_compare_exchange_n(&_slots[i].owned, &expected, 1, false, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED)) {
+					pthread_setspecific(_key, &_slots[i]);
+					return &_slots[i];
+				}
+			}
+			throw std::length_error("ft::epoch_domain: too many threads");
+		}
+
+		/**
+		 * Locks the retired list of s, only contended while release() walks it for another thread.
+		 */
+		static void lock(slot *s) {
+			while (__atomic_exchange_n(&s->busy, 1, __ATOMIC_ACQUIRE)) {
+				while (__atomic_load_n(&s->busy, __ATOMIC_RELAXED)) {
+				}
+			}
+		}
+
+		static void unlock(slot *s) {
+			__atomic_store_n(&s->busy, 0, __ATOMIC_RELEASE);
+		}
+
+		/**
+		 * Advances the global epoch if every pinned thread has observed it.
+		 */
+		void try_advance() {
+			size_type epoch = __atomic_load_n(&_epoch, __ATOMIC_ACQUIRE);
+
+			for (size_type i = 0; i < max_threads; i++) {
+				size_type pinned = __atomic_load_n(&_slots[i].epoch, __ATOMIC_ACQUIRE);
+
+				if (pinned != 0 && pinned != epoch) {
+					return;
+				}
+			}
+			__atomic_compare_exchange_n(&_epoch, &epoch, epoch + 1, false, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED);
+		}
+
+		/**
+		 * Releases a whole retired list.
+		 * @param node the head of the list
+		 */
+		void release(retired_node *node) {
+			while (node) {
+				retired_node *next = node->next;
+
+				node->deleter(node->context, node->ptr);
+				_alloc.deallocate(node, 1);
+				node = next;
+			}
+		}
+
+		/**
+		 * Gives the slot of an exiting thread back to the domain, its retired list is inherited by the next owner.
+		 * @param ptr the slot of the exiting thread
+		 */
+		static void release_slot(void *ptr) {
+			slot *s = static_cast<slot *>(ptr);
+
+			__atomic_store_n(&s->epoch, 0, __ATOMIC_RELEASE);
+			s->depth = 0;
+			__atomic_store_n(&s->owned, 0, __ATOMIC_RELEASE);
+		}
+
+		/**
+		 * Member objects
+		 */
+		size_type _epoch;
+		pthread_key_t _key;
+		std::allocator<retired_node> _alloc;
+		slot _slots[max_threads];
+	};
+
+}
+
+#endif //FT_CONTAINERS_EPOCH_HPP
@@ -0,0 +1,450 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   frozen_map.hpp                                     :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: mmosca <mmosca@student.42lyon.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2022/07/17 10:12:31 by mmosca            #+#    #+#             */
+/*   Updated: 2022/07/17 10:12:31 by mmosca           ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef FT_CONTAINERS_FROZEN_MAP_HPP
+#define FT_CONTAINERS_FROZEN_MAP_HPP
+
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include "utility.hpp"
+#include "iterator.hpp"
+#include "map.hpp"
+
+namespace ft {
+
+	/**
+	 * Input iterator walking an ft::frozen_map in key order. Keys and values live in separate arrays, so elements are returned by value.
+	 */
+	template<class Map>
+	class frozen_iterator : public ft::iterator<ft::input_iterator_tag, typename Map::value_type> {
+	public:
+		/**
+		 * Member types
+		 */
+		typedef typename Map::value_type value_type;
+		typedef typename Map::key_type key_type;
+		typedef typename Map::mapped_type mapped_type;
+		typedef value_type reference;
+
+		/**
+		 * Holds the element for operator->.
+		 */
+		class pointer {
+		public:
+			explicit pointer(const value_type &value) : _value(value) {}
+
+			const value_type *operator->() const {
+				return &_value;
+			}
+
+		private:
+			value_type _value;
+		};
+
+		/**
+		 * Member objects
+		 */
+		const Map *_map;
+		size_t _index;
+
+		frozen_iterator() : _map(nullptr), _index(0) {}
+
+		frozen_iterator(const Map *map, size_t index) : _map(map), _index(index) {}
+
+		const key_type &key() const {
+			return _map->_keys[_index];
+		}
+
+		const mapped_type &value() const {
+			return _map->_values[_index];
+		}
+
+		reference operator*() const {
+			return value_type(key(), value());
+		}
+
+		pointer operator->() const {
+			return pointer(**this);
+		}
+
+		/**
+		 * Moves to the in-order successor in the implicit tree: the leftmost node of the right subtree, or the first ancestor reached from a left child.
+		 */
+		frozen_iterator &operator++() {
+			size_t size = _map->size();
+
+			if (_index * 2 + 1 <= size) {
+				_index = _index * 2 + 1;
+				while (_index * 2 <= size) {
+					_index *= 2;
+				}
+			} else {
+				while (_index & 1) {
+					_index >>= 1;
+				}
+				_index >>= 1;
+			}
+			return *this;
+		}
+
+		frozen_iterator operator++(int) {
+			frozen_iterator tmp(*this);
+			++*this;
+			return tmp;
+		}
+
+		friend bool operator==(const frozen_iterator &lhs, const frozen_iterator &rhs) {
+			return lhs._index == rhs._index;
+		}
+
+		friend bool operator!=(const frozen_iterator &lhs, const frozen_iterator &rhs) {
+			return lhs._index != rhs._index;
+		}
+	};
+
+	/**
+	 * ft::frozen_map is an immutable sorted associative container built once from sorted unique elements.
+	 * Keys are laid out in Eytzinger order, the breadth-first order of a complete binary search tree, in one contiguous array: the children of index k are 2k and 2k + 1, so a search only moves forward in memory and the next levels can be prefetched.
+	 * Values live in a parallel array, so the searches only touch keys.
+	 * @tparam Key the type of the keys
+	 * @tparam T the type of the mapped values
+	 * @tparam Compare a Compare type providing a strict weak ordering
+	 * @tparam Allocator an allocator that is used to acquire/release memory and to construct/destroy the elements in that memory
+	 */
+	template<class Key, class T, class Compare = std::less<Key>, class Allocator = std::allocator<ft::pair<const Key, T> > >
+	class frozen_map {
+	public:
+		/**
+		 * Member types
+		 */
+		typedef Key key_type;
+		typedef T mapped_type;
+		typedef ft::pair<const Key, T> value_type;
+		typedef size_t size_type;
+		typedef ptrdiff_t difference_type;
+		typedef Compare key_compare;
+		typedef Allocator allocator_type;
+		typedef typename Allocator::template rebind<Key>::other key_allocator;
+		typedef typename Allocator::template rebind<T>::other mapped_allocator;
+		typedef ft::frozen_iterator<frozen_map> const_iterator;
+		typedef const_iterator iterator;
+
+		/**
+		 * Constructs an empty container.
+		 * @param comp comparison function object to use for all comparisons of keys
+		 * @param alloc allocator to use for all memory allocations of this container
+		 */
+		explicit frozen_map(const key_compare &comp = key_compare(), const allocator_type &alloc = allocator_type()) : _key_alloc(alloc), _mapped_alloc(alloc), _comp(comp), _keys(nullptr), _values(nullptr), _size(0) {}
+
+		/**
+		 * Constructs the container with the contents of the range [first, last), which must be sorted by comp and free of duplicate keys.
+		 * @param first the range to copy the elements from
+		 * @param last the range to copy the elements from
+		 * @param comp comparison function object to use for all comparisons of keys
+		 * @param alloc allocator to use for all memory allocations of this container
+		 */
+		template<class ForwardIt>
+		frozen_map(ForwardIt first, ForwardIt last, const key_compare &comp = key_compare(), const allocator_type &alloc = allocator_type()) : _key_alloc(alloc), _mapped_alloc(alloc), _comp(comp), _keys(nullptr), _values(nullptr), _size(0) {
+			size_type size = 0;
+
+			for (ForwardIt it = first; it != last; ++it) {
+				size++;
+			}
+			build(first, size);
+		}
+
+		/**
+		 * Constructs the container with the contents of map, laid out in the order of map.key_comp(). ft::map iterating by operator< on the keys, its elements are sorted again for any other order.
+		 * @param map the map to freeze
+		 */
+		template<class MapAllocator>
+		explicit frozen_map(const ft::map<Key, T, Compare, MapAllocator> &map) : _key_alloc(allocator_type()), _mapped_alloc(allocator_type()), _comp(map.key_comp()), _keys(nullptr), _values(nullptr), _size(0) {
+			typedef typename ft::map<Key, T, Compare, MapAllocator>::const_iterator map_iterator;
+			ft::vector<const Key *> keys;
+			ft::vector<const T *> values;
+			ft::vector<size_type> order;
+			bool sorted = true;
+
+			for (map_iterator it = map.begin(), previous = it; sorted && it != map.end(); previous = it++) {
+				sorted = it == previous || _comp((*previous).first, (*it).first);
+			}
+			if (sorted) {
+				build(map.begin(), map.size());
+				return;
+			}
+			for (map_iterator it = map.begin(); it != map.end(); ++it) {
+				order.push_back(keys.size());
+				keys.push_back(&(*it).first);
+				values.push_back(&(*it).second);
+			}
+			std::stable_sort(&order[0], &order[0] + order.size(), indirect_compare(&keys[0], _comp));
+			build(indirect_iterator(&keys[0], &values[0], &order[0]), map.size());
+		}
+
+		/**
+		 * Copy constructor. Constructs the container with the copy of the contents of other.
+		 * @param other another container to be used as source to initialize the elements of the container with
+		 */
+		frozen_map(const frozen_map &other) : _key_alloc(other._key_alloc), _mapped_alloc(other._mapped_alloc), _comp(other._comp), _keys(nullptr), _values(nullptr), _size(0) {
+			build(other.begin(), other.size());
+		}
+
+		/**
+		 * Destructs the frozen_map.
+		 */
+		~frozen_map() {
+			release();
+		}
+
+		/**
+		 * Copy assignment operator. Replaces the contents with a copy of the contents of other.
+		 * @param other another container to use as data source
+		 * @return *this
+		 */
+		frozen_map &operator=(const frozen_map &other) {
+			if (this != &other) {
+				release();
+				_comp = other._comp;
+				build(other.begin(), other.size());
+			}
+			return *this;
+		}
+
+		/**
+		 * Returns an iterator to the element with the smallest key.
+		 * @return iterator to the first element
+		 */
+		const_iterator begin() const {
+			size_type index = _size ? 1 : 0;
+
+			while (index * 2 <= _size) {
+				index *= 2;
+			}
+			return const_iterator(this, index);
+		}
+
+		/**
+		 * Returns an iterator to the element following the last element.
+		 * @return iterator to the element following the last element
+		 */
+		const_iterator end() const {
+			return const_iterator(this, 0);
+		}
+
+		bool empty() const {
+			return _size == 0;
+		}
+
+		size_type size() const {
+			return _size;
+		}
+
+		/**
+		 * Returns a reference to the mapped value of the element with key equivalent to key.
+		 * @param key the key of the element to find
+		 * @return reference to the mapped value of the requested element
+		 */
+		const mapped_type &at(const key_type &key) const {
+			size_type index = find_index(key);
+
+			if (index == 0) {
+				throw std::out_of_range("ft::frozen_map::at: key not found");
+			}
+			return _values[index];
+		}
+
+		size_type count(const key_type &key) const {
+			return find_index(key) ? 1 : 0;
+		}
+
+		/**
+		 * Finds an element with key equivalent to key.
+		 * @param key key value of the element to search for
+		 * @return iterator to an element with key equivalent to key, or end()
+		 */
+		const_iterator find(const key_type &key) const {
+			return const_iterator(this, find_index(key));
+		}
+
+		/**
+		 * Returns an iterator pointing to the first element that is not less than key.
+		 * @param key key value to compare the elements to
+		 * @return iterator pointing to the first element that is not less than key
+		 */
+		const_iterator lower_bound(const key_type &key) const {
+			size_type index = 1;
+
+			while (index <= _size) {
+				__builtin_prefetch(_keys + index * prefetch_stride);
+				index = index * 2 + _comp(_keys[index], key);
+			}
+			return const_iterator(this, index >> (__builtin_ctzl(~index) + 1));
+		}
+
+		/**
+		 * Returns an iterator pointing to the first element that is greater than key.
+		 * @param key key value to compare the elements to
+		 * @return iterator pointing to the first element that is greater than key
+		 */
+		const_iterator upper_bound(const key_type &key) const {
+			size_type index = 1;
+
+			while (index <= _size) {
+				__builtin_prefetch(_keys + index * prefetch_stride);
+				index = index * 2 + !_comp(key, _keys[index]);
+			}
+			return const_iterator(this, index >> (__builtin_ctzl(~index) + 1));
+		}
+
+		ft::pair<const_iterator, const_iterator> equal_range(const key_type &key) const {
+			return ft::make_pair(lower_bound(key), upper_bound(key));
+		}
+
+		key_compare key_comp() const {
+			return _comp;
+		}
+
+	private:
+		friend class ft::frozen_iterator<frozen_map>;
+
+		/**
+		 * The descendants of index k four levels down start at 16k: with 4 byte keys they share the cache line prefetched while k is compared.
+		 */
+		static const size_type prefetch_stride = sizeof(Key) >= 64 ? 1 : 64 / sizeof(Key);
+
+		/**
+		 * Orders the indices of elements by their keys, seen through pointers. Indices are sorted rather than pointers, std::swap being ambiguous with ft::swap for pointers to ft::pair.
+		 */
+		class indirect_compare {
+		public:
+			indirect_compare(const Key *const *keys, const key_compare &comp) : _keys(keys), _comp(comp) {}
+
+			bool operator()(size_type lhs, size_type rhs) const {
+				return _comp(*_keys[lhs], *_keys[rhs]);
+			}
+
+		private:
+			const Key *const *_keys;
+			key_compare _comp;
+		};
+
+		/**
+		 * Element seen through pointers, as build() reads it.
+		 */
+		struct indirect_element {
+			const Key &first;
+			const T &second;
+
+			indirect_element(const Key &first, const T &second) : first(first), second(second) {}
+		};
+
+		/**
+		 * Input iterator over elements seen through pointers, in the order of sorted indices.
+		 */
+		class indirect_iterator {
+		public:
+			indirect_iterator(const Key *const *keys, const T *const *values, const size_type *order) : _keys(keys), _values(values), _order(order) {}
+
+			indirect_element operator*() const {
+				return indirect_element(*_keys[*_order], *_values[*_order]);
+			}
+
+			indirect_iterator &operator++() {
+				++_order;
+				return *this;
+			}
+
+		private:
+			const Key *const *_keys;
+			const T *const *_values;
+			const size_type *_order;
+		};
+
+		/**
+		 * Returns the index of key, or 0 if it is missing.
+		 */
+		size_type find_index(const key_type &key) const {
+			size_type index = lower_bound(key)._index;
+
+			return (index && !_comp(key, _keys[index])) ? index : 0;
+		}
+
+		/**
+		 * Copies size sorted elements from first, slot 0 of the arrays is left unused so that the root is at index 1.
+		 */
+		template<class InputIt>
+		void build(InputIt first, size_type size) {
+			_size = size;
+			if (size == 0) {
+				return;
+			}
+			_keys = _key_alloc.allocate(size + 1);
+			_values = _mapped_alloc.allocate(size + 1);
+			fill(first, 1);
+		}
+
+		/**
+		 * Places the elements in order: left subtree, index, right subtree.
+		 */
+		template<class InputIt>
+		void fill(InputIt &it, size_type index) {
+			if (index > _size) {
+				return;
+			}
+			fill(it, index * 2);
+			_key_alloc.construct(_keys + index, (*it).first);
+			_mapped_alloc.construct(_values + index, (*it).second);
+			++it;
+			fill(it, index * 2 + 1);
+		}
+
+		void release() {
+			if (_size == 0) {
+				return;
+			}
+			for (size_type i = 1; i <= _size; i++) {
+				_key_alloc.destroy(_keys + i);
+				_mapped_alloc.destroy(_values + i);
+			}
+			_key_alloc.deallocate(_keys, _size + 1);
+			_mapped_alloc.deallocate(_values, _size + 1);
+			_keys = nullptr;
+			_values = nullptr;
+			_size = 0;
+		}
+
+		/**
+		 * Member objects
+		 */
+		key_allocator _key_alloc;
+		mapped_allocator _mapped_alloc;
+		key_compare _comp;
+		Key *_keys;
+		T *_values;
+		size_type _size;
+	};
+
+	/**
+	 * Freezes map into an ft::frozen_map holding a copy of its elements.
+	 * @param map the map to freeze
+	 * @return the frozen copy of map
+	 */
+	template<class Key, class T, class Compare, class Allocator>
+	ft::frozen_map<Key, T, Compare, Allocator> freeze(const ft::map<Key, T, Compare, Allocator> &map) {
+		return ft::frozen_map<Key, T, Compare, Allocator>(map);
+	}
+
+}
+
+#endif //FT_CONTAINERS_FROZEN_MAP_HPP
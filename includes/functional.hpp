@@ -0,0 +1,77 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   functional.hpp                                     :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: mmosca <mmosca@student.42lyon.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2022/07/16 14:20:03 by mmosca            #+#    #+#             */
+/*   Updated: 2022/07/16 14:20:03 by mmosca           ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef FT_CONTAINERS_FUNCTIONAL_HPP
+#define FT_CONTAINERS_FUNCTIONAL_HPP
+
+#include <cstddef>
+#include <string>
+
+namespace ft {
+
+	/**
+	 * ft::hash is the function object computing the hash of a key for the unordered containers. Integral values hash to themselves, the containers mix the result before using it.
+	 * @tparam Key the type of the keys to hash
+	 */
+	template<class Key>
+	struct hash;
+
+	template<class T>
+	struct hash<T *> {
+		size_t operator()(T *ptr) const {
+			return reinterpret_cast<size_t>(ptr);
+		}
+	};
+
+#define FT_CONTAINERS_INTEGRAL_HASH(type) \
+	template<> \
+	struct hash<type> { \
+		size_t operator()(type value) const { \
+			return static_cast<size_t>(value); \
+		} \
+	};
+
+	FT_CONTAINERS_INTEGRAL_HASH(bool)
+	FT_CONTAINERS_INTEGRAL_HASH(char)
+	FT_CONTAINERS_INTEGRAL_HASH(signed char)
+	FT_CONTAINERS_INTEGRAL_HASH(unsigned char)
+	FT_CONTAINERS_INTEGRAL_HASH(wchar_t)
+	FT_CONTAINERS_INTEGRAL_HASH(short int)
+	FT_CONTAINERS_INTEGRAL_HASH(unsigned short int)
+	FT_CONTAINERS_INTEGRAL_HASH(int)
+	FT_CONTAINERS_INTEGRAL_HASH(unsigned int)
+	FT_CONTAINERS_INTEGRAL_HASH(long int)
+	FT_CONTAINERS_INTEGRAL_HASH(unsigned long int)
+	FT_CONTAINERS_INTEGRAL_HASH(long long int)
+	FT_CONTAINERS_INTEGRAL_HASH(unsigned long long int)
+
+#undef FT_CONTAINERS_INTEGRAL_HASH
+
+	/**
+	 * Hashes the bytes of a string with FNV-1a.
+	 */
+	template<>
+	struct hash<std::string> {
+		size_t operator()(const std::string &str) const {
+			size_t h = static_cast<size_t>(14695981039346656037UL);
+
+			for (std::string::size_type i = 0; i < str.size(); i++) {
+				h ^= static_cast<unsigned char>(str[i]);
+				h *= static_cast<size_t>(1099511628211UL);
+			}
+			return h;
+		}
+	};
+
+}
+
+#endif //FT_CONTAINERS_FUNCTIONAL_HPP
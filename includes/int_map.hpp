@@ -0,0 +1,256 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   int_map.hpp                                        :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: mmosca <mmosca@student.42lyon.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2022/07/24 14:31:07 by mmosca            #+#    #+#             */
+/*   Updated: 2022/07/24 14:31:07 by mmosca           ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef FT_CONTAINERS_INT_MAP_HPP
+#define FT_CONTAINERS_INT_MAP_HPP
+
+#include <memory>
+#include <stdexcept>
+#include "utility.hpp"
+#include "iterator.hpp"
+#include "type_traits.hpp"
+#include "art.hpp"
+
+namespace ft {
+
+	/**
+	 * Splits an integral key into its bytes, most significant first, with the sign bit flipped so that negative keys come first.
+	 */
+	template<class Key>
+	struct int_key_traits {
+		static size_t length(const Key &) {
+			return sizeof(Key);
+		}
+
+		static unsigned char byte(const Key &key, size_t i) {
+			unsigned long long bits = static_cast<unsigned long long>(key);
+
+			if (Key(-1) < Key(0)) {
+				bits ^= 1ULL << (sizeof(Key) * 8 - 1);
+			}
+			return static_cast<unsigned char>(bits >> ((sizeof(Key) - 1 - i) * 8));
+		}
+	};
+
+	/**
+	 * ft::int_map is a sorted associative container of integral keys, stored in an adaptive radix tree: a lookup reads one byte of the key per level, at most sizeof(Key) levels, instead of comparing keys down a binary tree.
+	 * Dense and clustered keys share their leading bytes in a few wide nodes. The elements are linked in key order, so iteration, lower_bound() and range scans stay as cheap as in ft::map.
+	 * @tparam Key an integral type, the type of the keys
+	 * @tparam T the type of the mapped values
+	 * @tparam Allocator an allocator that is used for the elements and the inner nodes
+	 */
+	template<class Key, class T, class Allocator = std::allocator<ft::pair<const Key, T> >, class = typename ft::enable_if<ft::is_integral<Key>::value>::type>
+	class int_map {
+	public:
+		/**
+		 * Member types
+		 */
+		typedef Key key_type;
+		typedef T mapped_type;
+		typedef ft::pair<const Key, T> value_type;
+		typedef ft::pair<Key, T> node_value_type;
+		typedef size_t size_type;
+		typedef ptrdiff_t difference_type;
+		typedef Allocator allocator_type;
+		typedef ft::art_tree<Key, T, ft::int_key_traits<Key>, Allocator> tree_type;
+		typedef typename tree_type::iterator iterator;
+		typedef typename tree_type::const_iterator const_iterator;
+		typedef typename ft::reverse_iterator<iterator> reverse_iterator;
+		typedef typename ft::reverse_iterator<const_iterator> const_reverse_iterator;
+
+		/**
+		 * Constructs an empty container.
+		 * @param alloc allocator to use for all memory allocations of this container
+		 */
+		explicit int_map(const allocator_type &alloc = allocator_type()) : _tree(alloc) {}
+
+		/**
+		 * Copy constructor. Constructs the container with the copy of the contents of other.
+		 * @param other another container to be used as source to initialize the elements of the container with
+		 */
+		int_map(const int_map &other) {
+			insert(other.begin(), other.end());
+		}
+
+		/**
+		 * Copy assignment operator. Replaces the contents with a copy of the contents of other.
+		 * @param other another container to use as data source
+		 * @return *this
+		 */
+		int_map &operator=(const int_map &other) {
+			if (this != &other) {
+				clear();
+				insert(other.begin(), other.end());
+			}
+			return *this;
+		}
+
+		/**
+		 * Returns a reference to the value that is mapped to a key equivalent to key, performing an insertion if such key does not already exist.
+		 * @param key the key of the element to find
+		 * @return reference to the mapped value of the new element if no element with key key existed
+		 */
+		mapped_type &operator[](const key_type &key) {
+			return insert(value_type(key, mapped_type())).first->second;
+		}
+
+		/**
+		 * Returns a reference to the mapped value of the element with key equivalent to key.
+		 * @param key the key of the element to find
+		 * @return reference to the mapped value of the requested element
+		 */
+		mapped_type &at(const key_type &key) const {
+			iterator it = find(key);
+
+			if (it == end()) {
+				throw std::out_of_range("ft::int_map::at: key not found");
+			}
+			return it->second;
+		}
+
+		iterator begin() const {
+			return iterator(&_tree, _tree.first());
+		}
+
+		iterator end() const {
+			return iterator(&_tree, nullptr);
+		}
+
+		reverse_iterator rbegin() const {
+			return reverse_iterator(end());
+		}
+
+		reverse_iterator rend() const {
+			return reverse_iterator(begin());
+		}
+
+		bool empty() const {
+			return _tree.size() == 0;
+		}
+
+		size_type size() const {
+			return _tree.size();
+		}
+
+		/**
+		 * Erases all elements from the container.
+		 */
+		void clear() {
+			_tree.clear();
+		}
+
+		/**
+		 * Inserts value if the container doesn't already contain an element with an equivalent key.
+		 * @param value element value to insert
+		 * @return Returns a pair consisting of an iterator to the inserted element and a bool denoting whether the insertion took place
+		 */
+		ft::pair<iterator, bool> insert(const value_type &value) {
+			ft::pair<typename tree_type::leaf *, bool> result = _tree.insert(node_value_type(value.first, value.second));
+
+			return ft::make_pair(iterator(&_tree, result.first), result.second);
+		}
+
+		/**
+		 * Inserts elements from range [first, last).
+		 * @param first range of elements to insert
+		 * @param last range of elements to insert
+		 */
+		template<class InputIt>
+		void insert(InputIt first, InputIt last) {
+			for (; first != last; ++first) {
+				insert(value_type((*first).first, (*first).second));
+			}
+		}
+
+		/**
+		 * Removes the element at pos.
+		 * @param pos iterator to the element to remove
+		 */
+		void erase(iterator pos) {
+			_tree.erase(pos->first);
+		}
+
+		/**
+		 * Removes the elements in the range [first, last).
+		 * @param first range of elements to remove
+		 * @param last range of elements to remove
+		 */
+		void erase(iterator first, iterator last) {
+			while (first != last) {
+				erase(first++);
+			}
+		}
+
+		/**
+		 * Removes the element (if one exists) with the key equivalent to key.
+		 * @param key key value of the elements to remove
+		 * @return Number of elements removed (0 or 1).
+		 */
+		size_type erase(const key_type &key) {
+			return _tree.erase(key) ? 1 : 0;
+		}
+
+		/**
+		 * Exchanges the contents of the container with those of other. Iterators keep pointing to the same elements, now in the other container.
+		 * @param other container to exchange the contents with
+		 */
+		void swap(int_map &other) {
+			_tree.swap(other._tree);
+		}
+
+		size_type count(const key_type &key) const {
+			return _tree.find(key) ? 1 : 0;
+		}
+
+		/**
+		 * Finds an element with key equivalent to key.
+		 * @param key key value of the element to search for
+		 * @return iterator to an element with key equivalent to key, or end()
+		 */
+		iterator find(const key_type &key) const {
+			return iterator(&_tree, _tree.find(key));
+		}
+
+		/**
+		 * Returns an iterator pointing to the first element that is not less than key.
+		 * @param key key value to compare the elements to
+		 * @return iterator pointing to the first element that is not less than key
+		 */
+		iterator lower_bound(const key_type &key) const {
+			return iterator(&_tree, _tree.lower_bound(key));
+		}
+
+		/**
+		 * Returns an iterator pointing to the first element that is greater than key.
+		 * @param key key value to compare the elements to
+		 * @return iterator pointing to the first element that is greater than key
+		 */
+		iterator upper_bound(const key_type &key) const {
+			iterator it = lower_bound(key);
+
+			return (it != end() && it->first == key) ? ++it : it;
+		}
+
+		ft::pair<iterator, iterator> equal_range(const key_type &key) const {
+			return ft::make_pair(lower_bound(key), upper_bound(key));
+		}
+
+	private:
+		/**
+		 * Member objects
+		 */
+		tree_type _tree;
+	};
+
+}
+
+#endif //FT_CONTAINERS_INT_MAP_HPP
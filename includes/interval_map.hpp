@@ -0,0 +1,283 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   interval_map.hpp                                   :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: mmosca <mmosca@student.42lyon.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2022/07/22 16:08:54 by mmosca            #+#    #+#             */
+/*   Updated: 2022/07/22 16:08:54 by mmosca           ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef FT_CONTAINERS_INTERVAL_MAP_HPP
+#define FT_CONTAINERS_INTERVAL_MAP_HPP
+
+#include "utility.hpp"
+#include "avl.hpp"
+
+namespace ft {
+
+	/**
+	 * Half-open interval [lo, hi), ordered by lo then hi.
+	 */
+	template<class Key>
+	struct interval {
+		Key lo;
+		Key hi;
+
+		interval() : lo(), hi() {}
+
+		interval(const Key &lo, const Key &hi) : lo(lo), hi(hi) {}
+
+		friend bool operator==(const interval &lhs, const interval &rhs) {
+			return !(lhs.lo < rhs.lo) && !(rhs.lo < lhs.lo) && !(lhs.hi < rhs.hi) && !(rhs.hi < lhs.hi);
+		}
+
+		friend bool operator<(const interval &lhs, const interval &rhs) {
+			return lhs.lo < rhs.lo || (!(rhs.lo < lhs.lo) && lhs.hi < rhs.hi);
+		}
+	};
+
+	/**
+	 * Tree node caching the greatest end of the intervals of its subtree, recomputed with its height.
+	 */
+	template<typename Key, typename V>
+	class IntervalNode : public Node<ft::interval<Key>, V> {
+	public:
+		/**
+		 * Member types
+		 */
+		typedef ft::pair<ft::interval<Key>, V> value_type;
+
+		/**
+		 * Member objects
+		 */
+		Key max_end;
+
+		/**
+		 * Constructor initialized value with value.
+		 * @param value value to initialized
+		 */
+		IntervalNode(const value_type &value) : Node<ft::interval<Key>, V>(value), max_end(value.first.hi) {}
+
+		/**
+		 * Updates the height and the greatest end from the children.
+		 */
+		void updateHeight() {
+			Node<ft::interval<Key>, V>::updateHeight();
+			max_end = this->value.first.hi;
+			if (this->left && max_end < static_cast<IntervalNode *>(this->left)->max_end) {
+				max_end = static_cast<IntervalNode *>(this->left)->max_end;
+			}
+			if (this->right && max_end < static_cast<IntervalNode *>(this->right)->max_end) {
+				max_end = static_cast<IntervalNode *>(this->right)->max_end;
+			}
+		}
+	};
+
+	/**
+	 * ft::interval_map is an associative container of half-open intervals [lo, hi) with unique bounds, ordered by start, answering overlap and stabbing queries in O(log n + k) for k results.
+	 * Every node caches the greatest end of its subtree, so the subtrees ending before a query are skipped.
+	 * @tparam Key the type of the bounds
+	 * @tparam T the type of the mapped values
+	 */
+	template<class Key, class T>
+	class interval_map {
+	public:
+		/**
+		 * Member types
+		 */
+		typedef ft::interval<Key> key_type;
+		typedef Key bound_type;
+		typedef T mapped_type;
+		typedef ft::pair<key_type, T> value_type;
+		typedef size_t size_type;
+		typedef ft::IntervalNode<Key, T> node_type;
+		typedef ft::avl_tree<key_type, T, node_type> tree_type;
+		typedef typename tree_type::iterator iterator;
+		typedef ft::avl_iterator<node_type, const value_type> const_iterator;
+
+		/**
+		 * Constructs an empty container.
+		 */
+		interval_map() {}
+
+		/**
+		 * Copy constructor. Constructs the container with the copy of the contents of other.
+		 * @param other another container to be used as source to initialize the elements of the container with
+		 */
+		interval_map(const interval_map &other) {
+			for (const_iterator it = other.begin(); it != other.end(); ++it) {
+				_tree.insert(*it);
+			}
+		}
+
+		/**
+		 * Copy assignment operator. Replaces the contents with a copy of the contents of other.
+		 * @param other another container to use as data source
+		 * @return *this
+		 */
+		interval_map &operator=(const interval_map &other) {
+			if (this != &other) {
+				_tree.clear_tree();
+				for (const_iterator it = other.begin(); it != other.end(); ++it) {
+					_tree.insert(*it);
+				}
+			}
+			return *this;
+		}
+
+		/**
+		 * Returns an iterator to the interval with the smallest start. The intervals must not be modified through it, the mapped values may.
+		 * @return iterator to the first element
+		 */
+		iterator begin() {
+			return _tree.begin();
+		}
+
+		/**
+		 * Returns a const iterator to the interval with the smallest start.
+		 * @return const iterator to the first element
+		 */
+		const_iterator begin() const {
+			return _tree.begin();
+		}
+
+		/**
+		 * Returns an iterator to the element following the last interval.
+		 * @return iterator to the element following the last element
+		 */
+		iterator end() {
+			return _tree.end();
+		}
+
+		/**
+		 * Returns a const iterator to the element following the last interval.
+		 * @return const iterator to the element following the last element
+		 */
+		const_iterator end() const {
+			return _tree.end();
+		}
+
+		/**
+		 * Checks if the container has no intervals.
+		 * @return true if the container is empty, false otherwise
+		 */
+		bool empty() const {
+			return _tree.isEmpty();
+		}
+
+		/**
+		 * Returns the number of intervals in the container.
+		 * @return the number of elements in the container
+		 */
+		size_type size() const {
+			return _tree.getSize();
+		}
+
+		/**
+		 * Inserts the interval [lo, hi), lo < hi, mapped to value if it is not already in the container.
+		 * @param lo the start of the interval
+		 * @param hi the end of the interval, excluded
+		 * @param value the mapped value
+		 * @return true if the insertion took place
+		 */
+		bool insert(const bound_type &lo, const bound_type &hi, const mapped_type &value) {
+			size_type previousSize = _tree.getSize();
+
+			_tree.insert(ft::make_pair(key_type(lo, hi), value));
+			return previousSize != _tree.getSize();
+		}
+
+		/**
+		 * Removes the interval [lo, hi) if it is in the container.
+		 * @return Number of elements removed (0 or 1).
+		 */
+		size_type erase(const bound_type &lo, const bound_type &hi) {
+			size_type previousSize = _tree.getSize();
+
+			_tree.remove(ft::make_pair(key_type(lo, hi), mapped_type()));
+			return previousSize - _tree.getSize();
+		}
+
+		/**
+		 * Finds the interval [lo, hi).
+		 * @return iterator to the interval, or end()
+		 */
+		iterator find(const bound_type &lo, const bound_type &hi) {
+			return _tree.find_iterator(ft::make_pair(key_type(lo, hi), mapped_type()));
+		}
+
+		/**
+		 * Finds the interval [lo, hi).
+		 * @return const iterator to the interval, or end()
+		 */
+		const_iterator find(const bound_type &lo, const bound_type &hi) const {
+			return _tree.find_iterator(ft::make_pair(key_type(lo, hi), mapped_type()));
+		}
+
+		/**
+		 * Erases all elements from the container.
+		 */
+		void clear() {
+			_tree.clear_tree();
+		}
+
+		/**
+		 * Writes an iterator to every interval overlapping [lo, hi), in order of start.
+		 * @param lo the start of the query
+		 * @param hi the end of the query, excluded
+		 * @param out the destination of the iterators
+		 * @return out past the last iterator written
+		 */
+		template<class OutputIt>
+		OutputIt overlapping(const bound_type &lo, const bound_type &hi, OutputIt out) const {
+			return collect(_tree.getRoot(), lo, hi, false, out);
+		}
+
+		/**
+		 * Writes an iterator to every interval containing point, in order of start.
+		 * @param point the point to stab
+		 * @param out the destination of the iterators
+		 * @return out past the last iterator written
+		 */
+		template<class OutputIt>
+		OutputIt containing(const bound_type &point, OutputIt out) const {
+			return collect(_tree.getRoot(), point, point, true, out);
+		}
+
+	private:
+		/**
+		 * Visits in order the intervals of the subtree ending after lo and starting before hi, or at hi when closed, skipping the subtrees whose greatest end is not after lo and the right of any start past hi.
+		 */
+		template<class OutputIt>
+		OutputIt collect(const NodeBase *base, const bound_type &lo, const bound_type &hi, bool closed, OutputIt out) const {
+			while (base) {
+				const node_type *node = static_cast<const node_type *>(base);
+				const key_type &key = node->value.first;
+
+				if (!(lo < node->max_end)) {
+					break;
+				}
+				out = collect(node->left, lo, hi, closed, out);
+				if (closed ? hi < key.lo : !(key.lo < hi)) {
+					break;
+				}
+				if (lo < key.hi) {
+					*out++ = _tree.make_iterator(const_cast<node_type *>(node));
+				}
+				base = node->right;
+			}
+			return out;
+		}
+
+		/**
+		 * Member objects
+		 */
+		tree_type _tree;
+	};
+
+}
+
+#endif //FT_CONTAINERS_INTERVAL_MAP_HPP
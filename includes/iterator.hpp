@@ -884,13 +884,18 @@ namespace ft {
 		return (it.base() - n.base());
 	}
 
-	template<typename T>
+	/**
+	 * Bidirectional iterator over an ft::avl_tree, a single pointer to a node or to the header of the tree which stands for end().
+	 * @tparam Value the value type of the nodes, const qualified for an iterator that cannot write through
+	 */
+	template<typename T, typename Value = typename T::value_type>
 	class avl_iterator : public ft::iterator<ft::bidirectional_iterator_tag, T> {
 	public:
 		/**
 		 * Member types
 		 */
-		typedef typename T::value_type value_type;
+		typedef Value value_type;
+		typedef typename T::base_type base_type;
 		typedef typename ft::iterator<ft::bidirectional_iterator_tag, value_type>::iterator_category iterator_category;
 		typedef typename ft::iterator<ft::bidirectional_iterator_tag, value_type>::difference_type difference_type;
 		typedef typename ft::iterator<ft::bidirectional_iterator_tag, value_type>::pointer pointer;
@@ -899,55 +904,32 @@ namespace ft {
 		/**
 		 * Member objects
 		 */
-		T *_node;
-		T *_first_node;
-		T *_last_node;
-		bool _end;
+		base_type *_node;
 
 		/**
 		 * Default constructor.
 		 */
-		avl_iterator() : _node(), _first_node(), _last_node(), _end(false) {}
+		avl_iterator() : _node(nullptr) {}
 
 		/**
-		 * Constructor with initialized _addr with T* values.
-		 * @param node pointer to set
-		 * @param first pointer to set
-		 * @param last pointer to set
+		 * Constructor pointing the iterator to node.
+		 * @param node node, or tree header, to point to
 		 */
-		avl_iterator(T *node, T *first, T *last) : _node(node), _first_node(first), _last_node(last), _end(node == nullptr) {}
+		explicit avl_iterator(base_type *node) : _node(node) {}
 
 		/**
-		 * Avl iterator is initialized with that of copy.
+		 * Avl iterator is initialized with that of copy, a mutable one, into a const one if Value is const qualified.
 		 * @param avl_it avl iterator to copy
 		 */
 		template<typename U>
-		avl_iterator(const ft::avl_iterator<U> &avl_it) : _node(avl_it._node), _first_node(avl_it._first_node), _last_node(avl_it._last_node), _end(avl_it._end == nullptr) {}
-
-		/**
-		 * Destructor.
-		 */
-		~avl_iterator() {}
-
-		/**
-		 * The underlying iterator is assigned the value of the underlying iterator of other.
-		 * @param other iterator adaptor to assign
-		 * @return *this
-		 */
-		ft::avl_iterator<T> &operator=(const ft::avl_iterator<T> &other) {
-			_node = other._node;
-			_first_node = other._node;
-			_last_node = other._last_node;
-			_end = other._end;
-			return *this;
-		}
+		avl_iterator(const ft::avl_iterator<U> &avl_it) : _node(avl_it._node) {}
 
 		/**
 		 * Returns a reference to the element previous to current.
 		 * @return reference to the element previous to current
 		 */
 		reference operator*() const {
-			return _node->value;
+			return static_cast<T *>(_node)->value;
 		}
 
 		/**
@@ -955,7 +937,7 @@ namespace ft {
 		 * @return pointer to the element previous to current
 		 */
 		pointer operator->() const {
-			return &_node->value;
+			return &static_cast<T *>(_node)->value;
 		}
 
 		/**
@@ -963,37 +945,15 @@ namespace ft {
 		 * @return the underlying iterator
 		 */
 		pointer base() const {
-			return &_node->value;
+			return &static_cast<T *>(_node)->value;
 		}
 
 		/**
 		 * Pre-increments by one respectively.
 		 * @return *this
 		 */
-		ft::avl_iterator<T> &operator++() {
-			T *tmp;
-
-			if (!_node) {
-				return *this;
-			}
-			if (!_node->right) {
-				if (_node == _last_node) {
-					_end = true;
-					_node = nullptr;
-					return *this;
-				}
-				tmp = _node;
-				_node = _node->parent;
-				while (_node->right && tmp == _node->right) {
-					tmp = _node;
-					_node = _node->parent;
-				}
-				return *this;
-			}
-			_node = _node->right;
-			while (_node->left) {
-				_node = _node->left;
-			}
+		avl_iterator &operator++() {
+			_node = _node->next();
 			return *this;
 		}
 
@@ -1001,9 +961,9 @@ namespace ft {
 		 * Post-increments by one respectively.
 		 * @return a copy of *this that was made before the change
 		 */
-		ft::avl_iterator<T> operator++(int) {
-			ft::avl_iterator<T> tmp(*this);
-			++*this;
+		avl_iterator operator++(int) {
+			avl_iterator tmp(*this);
+			_node = _node->next();
 			return tmp;
 		}
 
@@ -1011,34 +971,8 @@ namespace ft {
 		 * Pre-decrements by one respectively.
 		 * @return *this
 		 */
-		ft::avl_iterator<T> &operator--() {
-			T *tmp;
-
-			if (!_node && _end) {
-				_node = _last_node;
-				_end = false;
-				return *this;
-			}
-			if (!_node) {
-				return *this;
-			}
-			if (!_node->left) {
-				if (_node == _first_node) {
-					_node = nullptr;
-					return *this;
-				}
-				tmp = _node;
-				_node = _node->parent;
-				while (_node->left && tmp == _node->left) {
-					tmp = _node;
-					_node = _node->parent;
-				}
-				return *this;
-			}
-			_node = _node->left;
-			while (_node->right) {
-				_node = _node->right;
-			}
+		avl_iterator &operator--() {
+			_node = _node->prev();
 			return *this;
 		}
 
@@ -1046,9 +980,9 @@ namespace ft {
 		 * Post-decrements by one respectively.
 		 * @return a copy of *this that was made before the change
 		 */
-		ft::avl_iterator<T> operator--(int) {
-			ft::avl_iterator<T> tmp(*this);
-			--*this;
+		avl_iterator operator--(int) {
+			avl_iterator tmp(*this);
+			_node = _node->prev();
 			return tmp;
 		}
 
@@ -1060,8 +994,8 @@ namespace ft {
 	 * @param rhs iterator adaptors to compare
 	 * @return true if the corresponding comparison yields true, false otherwise
 	 */
-	template<typename T>
-	bool operator==(const ft::avl_iterator<T> &lhs, const ft::avl_iterator<T> &rhs) {
+	template<typename T, typename Value>
+	bool operator==(const ft::avl_iterator<T, Value> &lhs, const ft::avl_iterator<T, Value> &rhs) {
 		return lhs._node == rhs._node;
 	}
 
@@ -1071,8 +1005,8 @@ namespace ft {
 	 * @param rhs iterator adaptors to compare
 	 * @return true if the corresponding comparison yields true, false otherwise
 	 */
-	template<typename U, typename V>
-	bool operator==(const ft::avl_iterator<U> &lhs, const ft::avl_iterator<V> &rhs) {
+	template<typename U, typename X, typename V, typename Y>
+	bool operator==(const ft::avl_iterator<U, X> &lhs, const ft::avl_iterator<V, Y> &rhs) {
 		return lhs._node == rhs._node;
 	}
 
@@ -1082,8 +1016,8 @@ namespace ft {
 	 * @param rhs iterator adaptors to compare
 	 * @return true if the corresponding comparison yields true, false otherwise
 	 */
-	template<typename T>
-	bool operator!=(const ft::avl_iterator<T> &lhs, const ft::avl_iterator<T> &rhs) {
+	template<typename T, typename Value>
+	bool operator!=(const ft::avl_iterator<T, Value> &lhs, const ft::avl_iterator<T, Value> &rhs) {
 		return lhs._node != rhs._node;
 	}
 
@@ -1093,8 +1027,8 @@ namespace ft {
 	 * @param rhs iterator adaptors to compare
 	 * @return true if the corresponding comparison yields true, false otherwise
 	 */
-	template<typename U, typename V>
-	bool operator!=(const ft::avl_iterator<U> &lhs, const ft::avl_iterator<V> &rhs) {
+	template<typename U, typename X, typename V, typename Y>
+	bool operator!=(const ft::avl_iterator<U, X> &lhs, const ft::avl_iterator<V, Y> &rhs) {
 		return lhs._node != rhs._node;
 	}
 
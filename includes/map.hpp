@@ -13,17 +13,31 @@
 #ifndef FT_CONTAINERS_MAP_HPP
 #define FT_CONTAINERS_MAP_HPP
 
+#include <algorithm>
 #include <functional>
 #include <memory>
 #include <map>
 #include "utility.hpp"
 #include "algorithm.hpp"
 #include "iterator.hpp"
+#include "vector.hpp"
 #include "avl.hpp"
+#include "threaded_avl.hpp"
+#include "parentless_avl.hpp"
+#include "arena_avl.hpp"
 
 namespace ft {
 
-	template<class Key, class T, class Compare = std::less<Key>, class Allocator = std::allocator<ft::pair<const Key, T> > >
+	/**
+	 * ft::map is a sorted associative container that contains key-value pairs with unique keys.
+	 * @tparam Key the type of the keys
+	 * @tparam T the type of the mapped values
+	 * @tparam Compare a Compare type providing a strict weak ordering
+	 * @tparam Allocator an allocator that is used to acquire/release memory and to construct/destroy the elements in that memory
+	 * @tparam Tree the balanced tree storing the elements: ft::avl_tree, ft::avl_tree over ft::PrefixNode for long string keys, ft::threaded_avl_tree for iterators that never climb, ft::parentless_avl_tree for smaller nodes, or ft::arena_avl_tree for nodes linked by 32 bit indices in one relocatable arena.
+	 * Unlike the others, ft::parentless_avl_tree invalidates every iterator of the map on any insert or erase, its iterators carrying the path to their node, which rotations change. The iterators of ft::arena_avl_tree, an index into the tree, are invalidated by swap().
+	 */
+	template<class Key, class T, class Compare = std::less<Key>, class Allocator = std::allocator<ft::pair<const Key, T> >, class Tree = ft::avl_tree<Key, T> >
 	class map {
 	public:
 		/**
@@ -39,8 +53,9 @@ namespace ft {
 		typedef typename Allocator::const_reference const_reference;
 		typedef typename Allocator::pointer pointer;
 		typedef typename Allocator::const_pointer const_pointer;
-		typedef typename ft::avl_tree<key_type, mapped_type>::iterator iterator;
-		typedef typename ft::avl_tree<key_type, mapped_type>::const_iterator const_iterator;
+		typedef Tree tree_type;
+		typedef typename Tree::iterator iterator;
+		typedef typename Tree::const_iterator const_iterator;
 		typedef typename ft::reverse_iterator<iterator> reverse_iterator;
 		typedef typename ft::reverse_iterator<const_iterator> const_reverse_iterator;
 		typedef typename ft::iterator_traits<iterator>::difference_type difference_type;
@@ -50,7 +65,7 @@ namespace ft {
 		 */
 		class value_compare : public std::binary_function<value_type, value_type, bool> {
 		public:
-			friend class map<key_type, mapped_type, key_compare, Allocator>;
+			friend class map<key_type, mapped_type, key_compare, Allocator, Tree>;
 			bool operator()(const value_type &x, const value_type &y) const {
 				return comp(x.first, y.first);
 			}
@@ -222,13 +237,21 @@ namespace ft {
 			_tree.clear_tree();
 		}
 
+		/**
+		 * Rebuilds the tree perfectly balanced with its nodes laid out contiguously in key order, for maps whose nodes got scattered by insertions and erasures. Invalidates all iterators.
+		 * Only for trees providing compact(): ft::avl_tree and ft::arena_avl_tree.
+		 */
+		void compact() {
+			_tree.compact();
+		}
+
 		/**
 		 * Inserts element(s) into the container, if the container doesn't already contain an element with an equivalent key.
 		 * @param value element value to insert
 		 * @return Returns a pair consisting of an iterator to the inserted element and a bool denoting whether the insertion took place
 		 */
 		ft::pair<iterator, bool> insert(const value_type &value) {
-			typename avl_tree<key_type, mapped_type>::size_type previousSize = _tree.getSize();
+			typename Tree::size_type previousSize = _tree.getSize();
 			_tree.insert(value);
 			return ft::make_pair(find(value.first), previousSize != _tree.getSize());
 		}
@@ -257,6 +280,47 @@ namespace ft {
 			}
 		}
 
+		/**
+		 * Inserts elements from range [first, last), sorted by operator< on the key as the tree orders them, in one pass merging them with the tree when the batch is large enough, cheaper than inserting them one by one.
+		 * Requires a Tree providing insert_sorted(), as ft::avl_tree.
+		 * @param first range of elements to insert, sorted by operator< on the key
+		 * @param last range of elements to insert
+		 * @return the number of elements inserted
+		 */
+		template<class ForwardIt>
+		size_type insert_sorted_batch(ForwardIt first, ForwardIt last) {
+			return _tree.insert_sorted(first, last);
+		}
+
+		/**
+		 * Inserts elements from range [first, last) in any order, sorting a copy of them first for insert_sorted_batch. Of equal keys, the first is inserted.
+		 * @param first range of elements to insert
+		 * @param last range of elements to insert
+		 * @return the number of elements inserted
+		 */
+		template<class InputIt>
+		size_type insert_batch(InputIt first, InputIt last) {
+			ft::vector<node_value_type> batch;
+			ft::vector<size_type> order;
+			ft::vector<node_value_type> sorted;
+
+			for (; first != last; ++first) {
+				batch.push_back(node_value_type((*first).first, (*first).second));
+			}
+			if (batch.empty()) {
+				return 0;
+			}
+			for (size_type i = 0; i < batch.size(); i++) {
+				order.push_back(i);
+			}
+			std::stable_sort(&order[0], &order[0] + order.size(), batch_compare(&batch[0]));
+			sorted.reserve(batch.size());
+			for (size_type i = 0; i < order.size(); i++) {
+				sorted.push_back(batch[order[i]]);
+			}
+			return insert_sorted_batch(&sorted[0], &sorted[0] + sorted.size());
+		}
+
 		/**
 		 * Removes the element at pos.
 		 * @param pos iterator to the element to remove
@@ -271,12 +335,7 @@ namespace ft {
 		 * @param last range of elements to remove
 		 */
 		void erase(iterator first, iterator last) {
-			while (first != last) {
-				iterator next = first;
-				next++;
-				erase(first);
-				first = next;
-			}
+			erase_range(first, last, _tree);
 		}
 
 		/**
@@ -292,6 +351,17 @@ namespace ft {
 			return 1;
 		}
 
+		/**
+		 * Removes every element for which pred returns true, rebuilding the tree in one pass when many are removed.
+		 * Requires a Tree providing erase_if(), as ft::avl_tree.
+		 * @param pred predicate called with each element, in key order
+		 * @return the number of elements removed
+		 */
+		template<class Pred>
+		size_type erase_if(Pred pred) {
+			return _tree.erase_if(pred);
+		}
+
 		/**
 		 * Exchanges the contents of the container with those of other.
 		 * @param other container to exchange the contents with
@@ -315,10 +385,7 @@ namespace ft {
 		 * @return iterator to an element with key equivalent to key
 		 */
 		iterator find(const key_type &key) {
-			if (_tree.getRoot()) {
-				return iterator(_tree.find(ft::make_pair(key, mapped_type())), _tree.getRoot()->getMin(), _tree.getRoot()->getMax());
-			}
-			return end();
+			return _tree.find_iterator(ft::make_pair(key, mapped_type()));
 		}
 
 		/**
@@ -327,10 +394,46 @@ namespace ft {
 		 * @return const iterator to an element with key equivalent to key
 		 */
 		const_iterator find(const key_type &key) const {
-			if (_tree.getRoot()) {
-				return const_iterator(_tree.find(ft::make_pair(key, mapped_type())), _tree.getRoot()->getMin(), _tree.getRoot()->getMax());
-			}
-			return end();
+			return _tree.find_iterator(ft::make_pair(key, mapped_type()));
+		}
+
+		/**
+		 * Finds an element with key equivalent to key, starting from hint rather than from the root: the search climbs from hint only as far as the key lies beyond, so a key near hint, as in merges and sorted probes, is found in O(log d) for d elements in between.
+		 * Requires a Tree providing find_near(), as ft::avl_tree.
+		 * @param hint iterator to start the search from, any element or end()
+		 * @param key key value of the element to search for
+		 * @return iterator to an element with key equivalent to key, or end()
+		 */
+		iterator find(const_iterator hint, const key_type &key) {
+			return _tree.find_near(hint, ft::make_pair(key, mapped_type()));
+		}
+
+		const_iterator find(const_iterator hint, const key_type &key) const {
+			return _tree.find_near(hint, ft::make_pair(key, mapped_type()));
+		}
+
+		/**
+		 * Finds the elements with keys equivalent to each key of [first, last), interleaving the lookups to hide the memory latency of large maps.
+		 * @param first the range of keys to search for
+		 * @param last the range of keys to search for
+		 * @param out the destination of an iterator per key, to the element found or end()
+		 * @return out past the last iterator written
+		 */
+		template<class ForwardIt, class OutputIt>
+		OutputIt find_many(ForwardIt first, ForwardIt last, OutputIt out) {
+			return _tree.find_many(first, last, find_output<iterator, OutputIt>(out, _tree)).base();
+		}
+
+		/**
+		 * Finds the elements with keys equivalent to each key of [first, last), interleaving the lookups to hide the memory latency of large maps.
+		 * @param first the range of keys to search for
+		 * @param last the range of keys to search for
+		 * @param out the destination of a const iterator per key, to the element found or end()
+		 * @return out past the last iterator written
+		 */
+		template<class ForwardIt, class OutputIt>
+		OutputIt find_many(ForwardIt first, ForwardIt last, OutputIt out) const {
+			return _tree.find_many(first, last, find_output<const_iterator, OutputIt>(out, _tree)).base();
 		}
 
 		/**
@@ -387,6 +490,21 @@ namespace ft {
 			return first;
 		}
 
+		/**
+		 * Returns an iterator pointing to the first element that is not less than key, searching from hint as find(hint, key) does.
+		 * Requires a Tree providing lower_bound_near(), as ft::avl_tree.
+		 * @param hint iterator to start the search from, any element or end()
+		 * @param key key value to compare the elements to
+		 * @return iterator pointing to the first element that is not less than key
+		 */
+		iterator lower_bound(const_iterator hint, const key_type &key) {
+			return _tree.lower_bound_near(hint, ft::make_pair(key, mapped_type()));
+		}
+
+		const_iterator lower_bound(const_iterator hint, const key_type &key) const {
+			return _tree.lower_bound_near(hint, ft::make_pair(key, mapped_type()));
+		}
+
 		/**
 		 * Returns an iterator pointing to the first element that is greater than key.
 		 * @param key key value to compare the elements to
@@ -446,7 +564,7 @@ namespace ft {
 		 * @return true if the contents of the maps are equal, false otherwise
 		 */
 		friend bool operator==(const map &lhs, const map &rhs) {
-			return lhs.size() == rhs.size() && ft::equal(lhs.begin(), lhs.end(), rhs.begin());
+			return &lhs == &rhs || (lhs.size() == rhs.size() && ft::equal(lhs.begin(), lhs.end(), rhs.begin()));
 		}
 
 		/**
@@ -466,7 +584,7 @@ namespace ft {
 		 * @return true if the contents of the lhs are lexicographically less than the contents of rhs, false otherwise
 		 */
 		friend bool operator<(const map &lhs, const map &rhs) {
-			return ft::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+			return &lhs != &rhs && ft::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
 		}
 
 		/**
@@ -509,14 +627,106 @@ namespace ft {
 		}
 
 	private:
+		typedef typename Tree::node_pointer node_pointer;
+		typedef ft::pair<Key, T> node_value_type;
+
+		/**
+		 * Erases [first, last) element by element, the trees whose iterators survive the erase of other elements.
+		 */
+		template<class OtherTree>
+		void erase_range(iterator first, iterator last, OtherTree &) {
+			while (first != last) {
+				iterator next = first;
+				next++;
+				erase(first);
+				first = next;
+			}
+		}
+
+		/**
+		 * Erases [first, last) from a parentless_avl_tree, whose erase invalidates every iterator: the keys are collected first.
+		 */
+		template<class U, class V, class Node, class NodeAllocator>
+		void erase_range(iterator first, iterator last, ft::parentless_avl_tree<U, V, Node, NodeAllocator> &) {
+			ft::vector<key_type> keys;
+
+			for (; first != last; ++first) {
+				keys.push_back((*first).first);
+			}
+			for (typename ft::vector<key_type>::size_type i = 0; i < keys.size(); i++) {
+				erase(keys[i]);
+			}
+		}
+
+		/**
+		 * Orders the indices of the elements of a batch by operator< on their keys, the order of the tree, whatever key_compare is. Indices are sorted rather than the elements, std::swap being ambiguous with ft::swap for ft::pair and pointers to it.
+		 */
+		class batch_compare {
+		public:
+			explicit batch_compare(const node_value_type *batch) : _batch(batch) {}
+
+			bool operator()(size_type lhs, size_type rhs) const {
+				return _batch[lhs].first < _batch[rhs].first;
+			}
+
+		private:
+			const node_value_type *_batch;
+		};
+
+		/**
+		 * Output iterator turning the nodes written by avl_tree::find_many into map iterators.
+		 */
+		template<class Iterator, class OutputIt>
+		class find_output {
+		public:
+			find_output(OutputIt out, const Tree &tree) : _out(out), _tree(&tree) {}
+
+			find_output &operator*() {
+				return *this;
+			}
+
+			find_output &operator++() {
+				return *this;
+			}
+
+			find_output &operator++(int) {
+				return *this;
+			}
+
+			find_output &operator=(node_pointer node) {
+				*_out = Iterator(_tree->make_iterator(node));
+				++_out;
+				return *this;
+			}
+
+			OutputIt base() const {
+				return _out;
+			}
+
+		private:
+			OutputIt _out;
+			const Tree *_tree;
+		};
+
 		/**
 		 * Member objects
 		 */
 		allocator_type _alloc;
 		key_compare _comp;
-		avl_tree<key_type, mapped_type> _tree;
+		Tree _tree;
 	};
 
+	/**
+	 * Erases all elements of map satisfying pred.
+	 * @param map container from which to erase
+	 * @param pred predicate that returns true if the element should be erased
+	 * @return the number of erased elements
+	 */
+	template<class Key, class T, class Compare, class Allocator, class Tree, class Pred>
+	typename ft::map<Key, T, Compare, Allocator, Tree>::size_type erase_if(ft::map<Key, T, Compare, Allocator, Tree> &map, Pred pred) {
+		return map.erase_if(pred);
+	}
+
 }
 
 #endif //FT_CONTAINERS_MAP_HPP
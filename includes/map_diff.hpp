@@ -0,0 +1,67 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   map_diff.hpp                                       :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: mmosca <mmosca@student.42lyon.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2022/07/28 10:12:45 by mmosca            #+#    #+#             */
+/*   Updated: 2022/07/28 10:12:45 by mmosca           ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef FT_CONTAINERS_MAP_DIFF_HPP
+#define FT_CONTAINERS_MAP_DIFF_HPP
+
+#include "utility.hpp"
+
+namespace ft {
+
+	/**
+	 * Reports the differences between two snapshots of a sorted map, walking both in key order in lockstep: O(n + m) comparisons, against O(n log m) for looking up every key of one map in the other.
+	 * Both maps must order their keys with the same comparison. Diffing a map with itself returns at once.
+	 * @tparam Map the type of the maps, an ft::map or any sorted map with the same interface
+	 * @tparam Callback function object providing removed(element) for the keys only in before, added(element) for the keys only in after, and changed(old element, new element) for the keys whose mapped values differ by operator==
+	 * @param before the previous snapshot
+	 * @param after the current snapshot
+	 * @param callback receives the differences, in key order
+	 * @return callback
+	 */
+	template<class Map, class Callback>
+	Callback map_diff(const Map &before, const Map &after, Callback callback) {
+		typename Map::key_compare comp = before.key_comp();
+		typename Map::const_iterator lhs = before.begin();
+		typename Map::const_iterator rhs = after.begin();
+		typename Map::const_iterator lhsEnd = before.end();
+		typename Map::const_iterator rhsEnd = after.end();
+
+		if (&before == &after) {
+			return callback;
+		}
+		while (lhs != lhsEnd && rhs != rhsEnd) {
+			if (comp((*lhs).first, (*rhs).first)) {
+				callback.removed(*lhs);
+				++lhs;
+			} else if (comp((*rhs).first, (*lhs).first)) {
+				callback.added(*rhs);
+				++rhs;
+			} else {
+				if (!((*lhs).second == (*rhs).second)) {
+					callback.changed(*lhs, *rhs);
+				}
+				++lhs;
+				++rhs;
+			}
+		}
+		for (; lhs != lhsEnd; ++lhs) {
+			callback.removed(*lhs);
+		}
+		for (; rhs != rhsEnd; ++rhs) {
+			callback.added(*rhs);
+		}
+		return callback;
+	}
+
+}
+
+#endif //FT_CONTAINERS_MAP_DIFF_HPP
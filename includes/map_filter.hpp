@@ -0,0 +1,260 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   map_filter.hpp                                     :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: mmosca <mmosca@student.42lyon.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2022/07/26 11:20:34 by mmosca            #+#    #+#             */
+/*   Updated: 2022/07/26 11:20:34 by mmosca           ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef FT_CONTAINERS_MAP_FILTER_HPP
+#define FT_CONTAINERS_MAP_FILTER_HPP
+
+#include <cstring>
+#include <memory>
+#include "utility.hpp"
+#include "functional.hpp"
+
+namespace ft {
+
+	/**
+	 * Blocked Bloom filter: every key sets one bit in each of the 8 words of one 64 byte block, so a query reads a single cache line.
+	 * It answers "maybe" for every key inserted, and "no" for most others, with about 2.6% of false positives at 8 bits per key, 0.3% at 12 and 0.06% at 16.
+	 * @tparam Key the type of the keys
+	 * @tparam Hash function object hashing the keys, mixed before use
+	 */
+	template<class Key, class Hash = ft::hash<Key> >
+	class bloom_filter {
+	public:
+		typedef unsigned long long word_type;
+		typedef size_t size_type;
+
+		/**
+		 * Constructs a filter sized for capacity keys.
+		 * @param capacity the number of keys the filter is sized for
+		 * @param bits_per_key the size of the filter per key, more bits giving fewer false positives
+		 * @param hash hash function to use
+		 */
+		explicit bloom_filter(size_type capacity = 0, size_type bits_per_key = 16, const Hash &hash = Hash()) : _hash(hash), _bits_per_key(bits_per_key), _storage(nullptr), _words(nullptr), _blocks(0), _capacity(0) {
+			reset(capacity);
+		}
+
+		~bloom_filter() {
+			release();
+		}
+
+		/**
+		 * Empties the filter and resizes it for capacity keys.
+		 * @param capacity the number of keys the filter is sized for
+		 */
+		void reset(size_type capacity) {
+			size_type blocks = (capacity * _bits_per_key + block_bits - 1) / block_bits;
+
+			if (blocks == 0) {
+				blocks = 1;
+			}
+			if (blocks != _blocks) {
+				std::allocator<word_type> alloc;
+
+				release();
+				_storage = alloc.allocate(blocks * block_words + block_words - 1);
+				_words = _storage + (block_words - reinterpret_cast<size_t>(_storage) / sizeof(word_type) % block_words) % block_words;
+				_blocks = blocks;
+			}
+			std::memset(static_cast<void *>(_words), 0, _blocks * block_words * sizeof(word_type));
+			_capacity = capacity;
+		}
+
+		/**
+		 * Returns the number of keys the filter is sized for.
+		 */
+		size_type capacity() const {
+			return _capacity;
+		}
+
+		void insert(const Key &key) {
+			size_t h = mix(_hash(key));
+			word_type *block = _words + block_of(h) * block_words;
+
+			for (size_t i = 0; i < block_words; i++) {
+				block[i] |= bit(h, i);
+			}
+		}
+
+		/**
+		 * Checks if key may have been inserted.
+		 * @return false if key was never inserted since the last reset
+		 */
+		bool may_contain(const Key &key) const {
+			size_t h = mix(_hash(key));
+			const word_type *block = _words + block_of(h) * block_words;
+			word_type missing = 0;
+
+			for (size_t i = 0; i < block_words; i++) {
+				missing |= bit(h, i) & ~block[i];
+			}
+			return missing == 0;
+		}
+
+	private:
+		bloom_filter(const bloom_filter &);
+		bloom_filter &operator=(const bloom_filter &);
+
+		static const size_t block_words = 8;
+		static const size_t block_bits = block_words * 64;
+
+		static size_t mix(size_t h) {
+			h *= static_cast<size_t>(0x9E3779B97F4A7C15UL);
+			return h ^ (h >> (sizeof(size_t) * 4));
+		}
+
+		/**
+		 * Maps the high half of the hash onto the blocks with a multiplication rather than a division.
+		 */
+		size_t block_of(size_t h) const {
+			return static_cast<size_t>(((h >> 32) * static_cast<word_type>(_blocks)) >> 32);
+		}
+
+		/**
+		 * The bit of word i of the block, from the low half of the hash multiplied by an odd salt per word.
+		 */
+		static word_type bit(size_t h, size_t i) {
+			static const unsigned int salts[block_words] = {0x47b6137bU, 0x44974d91U, 0x8824ad5bU, 0xa2b7289dU, 0x705495c7U, 0x2df1424bU, 0x9efc4947U, 0x5c6bfb31U};
+
+			return static_cast<word_type>(1) << ((static_cast<unsigned int>(h) * salts[i]) >> 26);
+		}
+
+		void release() {
+			if (_storage) {
+				std::allocator<word_type>().deallocate(_storage, _blocks * block_words + block_words - 1);
+			}
+			_storage = nullptr;
+			_words = nullptr;
+			_blocks = 0;
+		}
+
+		/**
+		 * Member objects
+		 */
+		Hash _hash;
+		size_type _bits_per_key;
+		word_type *_storage;
+		word_type *_words;
+		size_type _blocks;
+		size_type _capacity;
+	};
+
+	/**
+	 * ft::map_filter puts a Bloom filter in front of a map, so that find() and count() of missing keys usually return without descending the tree.
+	 * The writes must go through the filter while it is attached. The filter doubles and rebuilds from the map when it is full, and rebuilds when the keys erased since the last rebuild reach a quarter of its capacity, keeping the false positives low.
+	 * @tparam Map the type of the map, an ft::map or any map with the same interface
+	 * @tparam Hash function object hashing the keys
+	 */
+	template<class Map, class Hash = ft::hash<typename Map::key_type> >
+	class map_filter {
+	public:
+		/**
+		 * Member types
+		 */
+		typedef typename Map::key_type key_type;
+		typedef typename Map::value_type value_type;
+		typedef typename Map::size_type size_type;
+		typedef typename Map::iterator iterator;
+
+		/**
+		 * Attaches a filter to map, built from its contents.
+		 * @param map the map to filter the lookups of
+		 * @param bits_per_key the size of the filter per key, more bits giving fewer false positives
+		 */
+		explicit map_filter(Map &map, size_type bits_per_key = 16) : _map(map), _filter(0, bits_per_key), _erased(0) {
+			rebuild();
+		}
+
+		/**
+		 * Refills the filter from the map, sized for twice its elements, forgetting the erased keys.
+		 */
+		void rebuild() {
+			_filter.reset(_map.size() * 2 + min_capacity);
+			for (iterator it = _map.begin(); it != _map.end(); ++it) {
+				_filter.insert(it->first);
+			}
+			_erased = 0;
+		}
+
+		/**
+		 * Finds an element with key equivalent to key, returning at once when the filter rules it out.
+		 * @param key key value of the element to search for
+		 * @return iterator to an element with key equivalent to key, or end()
+		 */
+		iterator find(const key_type &key) const {
+			if (!_filter.may_contain(key)) {
+				return _map.end();
+			}
+			return _map.find(key);
+		}
+
+		size_type count(const key_type &key) const {
+			return _filter.may_contain(key) ? _map.count(key) : 0;
+		}
+
+		/**
+		 * Inserts value into the map if it doesn't already contain an element with an equivalent key.
+		 * @param value element value to insert
+		 * @return Returns a pair consisting of an iterator to the inserted element and a bool denoting whether the insertion took place
+		 */
+		ft::pair<iterator, bool> insert(const value_type &value) {
+			ft::pair<iterator, bool> result = _map.insert(value);
+
+			if (result.second) {
+				if (_map.size() + _erased > _filter.capacity()) {
+					rebuild();
+				} else {
+					_filter.insert(value.first);
+				}
+			}
+			return result;
+		}
+
+		/**
+		 * Removes the element (if one exists) with the key equivalent to key. Its bits stay in the filter until the next rebuild.
+		 * @param key key value of the elements to remove
+		 * @return Number of elements removed (0 or 1).
+		 */
+		size_type erase(const key_type &key) {
+			size_type erased = count(key) ? _map.erase(key) : 0;
+
+			_erased += erased;
+			if (_erased * 4 > _filter.capacity()) {
+				rebuild();
+			}
+			return erased;
+		}
+
+		/**
+		 * Erases all elements from the map and the filter.
+		 */
+		void clear() {
+			_map.clear();
+			rebuild();
+		}
+
+	private:
+		map_filter(const map_filter &);
+		map_filter &operator=(const map_filter &);
+
+		static const size_type min_capacity = 64;
+
+		/**
+		 * Member objects
+		 */
+		Map &_map;
+		ft::bloom_filter<key_type, Hash> _filter;
+		size_type _erased;
+	};
+
+}
+
+#endif //FT_CONTAINERS_MAP_FILTER_HPP
@@ -0,0 +1,294 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   map_rebuild.hpp                                    :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: mmosca <mmosca@student.42lyon.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2022/07/21 14:02:47 by mmosca            #+#    #+#             */
+/*   Updated: 2022/07/21 14:02:47 by mmosca           ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef FT_CONTAINERS_MAP_REBUILD_HPP
+#define FT_CONTAINERS_MAP_REBUILD_HPP
+
+#include <stdexcept>
+#include <pthread.h>
+#include "utility.hpp"
+#include "map.hpp"
+
+namespace ft {
+
+	/**
+	 * ft::map_rebuild rebuilds an ft::map on a worker thread while the map keeps serving.
+	 * While a rebuild runs the map is only read: the worker copies it in key order into one block of a fresh map in O(n), and the writes go to a small map of pending writes that lookups check first.
+	 * Once the worker is done, the pending writes are replayed into the fresh map, which is swapped in in O(1). The old tree is then released on the worker.
+	 * If the copy throws, the pending writes are replayed into the map itself, which is kept, and poll() or finish() throws.
+	 * While a rebuild runs, the map must only be accessed through the map_rebuild.
+	 * @tparam Map the ft::map to rebuild, whose tree provides insert_sorted()
+	 */
+	template<class Map>
+	class map_rebuild {
+	public:
+		/**
+		 * Member types
+		 */
+		typedef typename Map::key_type key_type;
+		typedef typename Map::mapped_type mapped_type;
+		typedef typename Map::value_type value_type;
+		typedef typename Map::size_type size_type;
+		typedef typename Map::key_compare key_compare;
+
+		/**
+		 * Constructs an idle rebuild of map.
+		 * @param map the map to rebuild
+		 */
+		explicit map_rebuild(Map &map) : _map(map), _other(nullptr), _state(idle), _done(0), _failed(0) {}
+
+		/**
+		 * Waits for a running rebuild and swaps it in, keeping the map if it failed.
+		 */
+		~map_rebuild() {
+			try {
+				finish();
+			} catch (const std::runtime_error &) {
+			}
+		}
+
+		/**
+		 * Starts rebuilding the map on a worker thread.
+		 * @return false if a rebuild is already running
+		 */
+		bool start() {
+			if (_state == building) {
+				return false;
+			}
+			join();
+			_other = new Map(_map.key_comp());
+			_failed = 0;
+			run(building, &build);
+			return true;
+		}
+
+		/**
+		 * Checks if a rebuild is running.
+		 * @return true from start() until the rebuilt map is swapped in
+		 */
+		bool running() const {
+			return _state == building;
+		}
+
+		/**
+		 * Swaps the rebuilt map in if the worker is done, without waiting.
+		 * @return true if the rebuilt map was swapped in
+		 * @throw std::runtime_error if the worker is done but failed, the map being kept
+		 */
+		bool poll() {
+			if (_state == building && __atomic_load_n(&_done, __ATOMIC_ACQUIRE)) {
+				swap_in();
+				return true;
+			}
+			return false;
+		}
+
+		/**
+		 * Waits for a running rebuild, swaps it in, and waits for the old tree to be released.
+		 * @throw std::runtime_error if the rebuild failed, the map being kept
+		 */
+		void finish() {
+			if (_state == building) {
+				swap_in();
+			}
+			join();
+		}
+
+		/**
+		 * Returns the number of elements with key that compares equivalent to key, which is either 1 or 0.
+		 * @param key key value of the elements to count
+		 * @return number of elements with key that compares equivalent to key
+		 */
+		size_type count(const key_type &key) const {
+			typename pending_map::const_iterator it = _pending.find(key);
+
+			if (it != _pending.end()) {
+				return it->second.first ? 1 : 0;
+			}
+			return _map.count(key);
+		}
+
+		/**
+		 * Copies the value mapped to key into value.
+		 * @param key key value of the element to search for
+		 * @param value where the mapped value is copied
+		 * @return true if an element with key equivalent to key was found
+		 */
+		bool find(const key_type &key, mapped_type &value) const {
+			typename pending_map::const_iterator pending = _pending.find(key);
+			typename Map::const_iterator it;
+
+			if (pending != _pending.end()) {
+				if (pending->second.first) {
+					value = pending->second.second;
+				}
+				return pending->second.first;
+			}
+			it = _map.find(key);
+			if (it == _map.end()) {
+				return false;
+			}
+			value = it->second;
+			return true;
+		}
+
+		/**
+		 * Inserts value, or replaces the mapped value of the element with an equivalent key.
+		 * @param value element value to insert or assign
+		 * @return true if the insertion took place, false if the assignment took place
+		 */
+		bool insert_or_assign(const value_type &value) {
+			bool inserted = !count(value.first);
+
+			if (_state != building) {
+				if (inserted) {
+					_map.insert(value);
+				} else {
+					_map.find(value.first)->second = value.second;
+				}
+				return inserted;
+			}
+			pending(value.first) = ft::make_pair(true, value.second);
+			return inserted;
+		}
+
+		/**
+		 * Removes the element (if one exists) with the key equivalent to key.
+		 * @param key key value of the elements to remove
+		 * @return Number of elements removed (0 or 1).
+		 */
+		size_type erase(const key_type &key) {
+			if (_state != building) {
+				return _map.erase(key);
+			}
+			if (!count(key)) {
+				return 0;
+			}
+			pending(key).first = false;
+			return 1;
+		}
+
+	private:
+		/**
+		 * Writes made during a rebuild: true and the mapped value for an insertion, false for an erasure.
+		 */
+		typedef ft::map<key_type, ft::pair<bool, mapped_type>, key_compare> pending_map;
+
+		enum state {
+			idle,
+			building,
+			reclaiming
+		};
+
+		map_rebuild(const map_rebuild &);
+		map_rebuild &operator=(const map_rebuild &);
+
+		/**
+		 * Returns the pending write of key, adding one if there is none.
+		 */
+		ft::pair<bool, mapped_type> &pending(const key_type &key) {
+			typename pending_map::iterator it = _pending.find(key);
+
+			if (it == _pending.end()) {
+				it = _pending.insert(ft::make_pair(key, ft::pair<bool, mapped_type>(false, mapped_type()))).first;
+			}
+			return it->second;
+		}
+
+		void run(state job, void *(*routine)(void *)) {
+			__atomic_store_n(&_done, 0, __ATOMIC_RELAXED);
+			if (pthread_create(&_thread, nullptr, routine, this) != 0) {
+				delete _other;
+				_other = nullptr;
+				throw std::runtime_error("ft::map_rebuild: pthread_create failed");
+			}
+			_state = job;
+		}
+
+		void join() {
+			if (_state != idle) {
+				pthread_join(_thread, nullptr);
+				_state = idle;
+			}
+			delete _other;
+			_other = nullptr;
+		}
+
+		/**
+		 * Waits for the worker, replays the pending writes into the rebuilt map, swaps it in and hands the old tree to a worker.
+		 * @throw std::runtime_error if the worker failed, once the pending writes are replayed into the map
+		 */
+		void swap_in() {
+			Map *target;
+
+			pthread_join(_thread, nullptr);
+			_state = idle;
+			target = _failed ? &_map : _other;
+			for (typename pending_map::iterator it = _pending.begin(); it != _pending.end(); ++it) {
+				if (!it->second.first) {
+					target->erase(it->first);
+				} else if (!target->insert(ft::make_pair(it->first, it->second.second)).second) {
+					target->find(it->first)->second = it->second.second;
+				}
+			}
+			_pending.clear();
+			if (_failed) {
+				delete _other;
+				_other = nullptr;
+				throw std::runtime_error("ft::map_rebuild: the rebuild failed");
+			}
+			_map.swap(*_other);
+			run(reclaiming, &reclaim);
+		}
+
+		/**
+		 * Worker copying the map, which no one writes while it runs, in key order into one block of the empty fresh map. An exception is recorded for swap_in() rather than let out of the thread.
+		 */
+		static void *build(void *arg) {
+			map_rebuild *self = static_cast<map_rebuild *>(arg);
+			const Map &map = self->_map;
+
+			try {
+				self->_other->insert_sorted_batch(map.begin(), map.end());
+			} catch (...) {
+				self->_failed = 1;
+			}
+			__atomic_store_n(&self->_done, 1, __ATOMIC_RELEASE);
+			return nullptr;
+		}
+
+		/**
+		 * Worker releasing the tree swapped out.
+		 */
+		static void *reclaim(void *arg) {
+			map_rebuild *self = static_cast<map_rebuild *>(arg);
+
+			self->_other->clear();
+			__atomic_store_n(&self->_done, 1, __ATOMIC_RELEASE);
+			return nullptr;
+		}
+
+		/**
+		 * Member objects
+		 */
+		Map &_map;
+		Map *_other;
+		pending_map _pending;
+		pthread_t _thread;
+		state _state;
+		int _done;
+		int _failed;
+	};
+
+}
+
+#endif //FT_CONTAINERS_MAP_REBUILD_HPP
@@ -0,0 +1,379 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   map_snapshot.hpp                                   :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: mmosca <mmosca@student.42lyon.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2022/07/29 15:03:22 by mmosca            #+#    #+#             */
+/*   Updated: 2022/07/29 15:03:22 by mmosca           ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef FT_CONTAINERS_MAP_SNAPSHOT_HPP
+#define FT_CONTAINERS_MAP_SNAPSHOT_HPP
+
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "utility.hpp"
+#include "iterator.hpp"
+
+namespace ft {
+
+	/**
+	 * ft::snapshot_traits writes and reads the keys and mapped values of a map snapshot. A type whose bytes are its value has a fixed size, and is copied as is.
+	 * Specialize it for other types, providing fixed_size (0 if the size varies), size(value), write(value, out) and read(in, end, value), write and read returning the position past the value. read must not read past end, and returns nullptr if the value does not fit before it.
+	 * @tparam T the type of the keys or of the mapped values
+	 */
+	template<class T>
+	struct snapshot_traits;
+
+#define FT_CONTAINERS_RAW_SNAPSHOT(type) \
+	template<> \
+	struct snapshot_traits<type> { \
+		static const size_t fixed_size = sizeof(type); \
+		static size_t size(const type &) { \
+			return sizeof(type); \
+		} \
+		static char *write(const type &value, char *out) { \
+			std::memcpy(out, &value, sizeof(type)); \
+			return out + sizeof(type); \
+		} \
+		static const char *read(const char *in, const char *end, type &value) { \
+			if (static_cast<size_t>(end - in) < sizeof(type)) { \
+				return nullptr; \
+			} \
+			std::memcpy(&value, in, sizeof(type)); \
+			return in + sizeof(type); \
+		} \
+	};
+
+	FT_CONTAINERS_RAW_SNAPSHOT(bool)
+	FT_CONTAINERS_RAW_SNAPSHOT(char)
+	FT_CONTAINERS_RAW_SNAPSHOT(signed char)
+	FT_CONTAINERS_RAW_SNAPSHOT(unsigned char)
+	FT_CONTAINERS_RAW_SNAPSHOT(wchar_t)
+	FT_CONTAINERS_RAW_SNAPSHOT(short)
+	FT_CONTAINERS_RAW_SNAPSHOT(unsigned short)
+	FT_CONTAINERS_RAW_SNAPSHOT(int)
+	FT_CONTAINERS_RAW_SNAPSHOT(unsigned int)
+	FT_CONTAINERS_RAW_SNAPSHOT(long)
+	FT_CONTAINERS_RAW_SNAPSHOT(unsigned long)
+	FT_CONTAINERS_RAW_SNAPSHOT(long long)
+	FT_CONTAINERS_RAW_SNAPSHOT(unsigned long long)
+	FT_CONTAINERS_RAW_SNAPSHOT(float)
+	FT_CONTAINERS_RAW_SNAPSHOT(double)
+
+#undef FT_CONTAINERS_RAW_SNAPSHOT
+
+	/**
+	 * Strings are written as their length on 8 bytes followed by their bytes.
+	 */
+	template<>
+	struct snapshot_traits<std::string> {
+		static const size_t fixed_size = 0;
+
+		static size_t size(const std::string &value) {
+			return sizeof(unsigned long long) + value.size();
+		}
+
+		static char *write(const std::string &value, char *out) {
+			unsigned long long length = value.size();
+
+			std::memcpy(out, &length, sizeof(length));
+			std::memcpy(out + sizeof(length), value.data(), value.size());
+			return out + sizeof(length) + value.size();
+		}
+
+		static const char *read(const char *in, const char *end, std::string &value) {
+			unsigned long long length;
+
+			if (static_cast<size_t>(end - in) < sizeof(length)) {
+				return nullptr;
+			}
+			std::memcpy(&length, in, sizeof(length));
+			in += sizeof(length);
+			if (length > static_cast<unsigned long long>(end - in)) {
+				return nullptr;
+			}
+			value.assign(in, static_cast<size_t>(length));
+			return in + length;
+		}
+	};
+
+	/**
+	 * Header of a snapshot file, followed by count records: a key then its mapped value, in key order.
+	 */
+	struct snapshot_header {
+		char magic[8];
+		unsigned int key_size;
+		unsigned int mapped_size;
+		unsigned long long count;
+		unsigned long long bytes;
+		unsigned long long checksum;
+	};
+
+	/**
+	 * Checksum of the records, mixing them 8 bytes at a time whatever the size of the pieces they are given in.
+	 */
+	class snapshot_checksum {
+	public:
+		snapshot_checksum() : _h(0x9E3779B97F4A7C15ULL), _tail_size(0) {}
+
+		void update(const char *data, size_t size) {
+			size_t i = 0;
+
+			while (_tail_size != 0 && i < size) {
+				_tail[_tail_size++] = data[i++];
+				if (_tail_size == sizeof(_tail)) {
+					mix(_tail);
+					_tail_size = 0;
+				}
+			}
+			for (; i + sizeof(_tail) <= size; i += sizeof(_tail)) {
+				mix(data + i);
+			}
+			for (; i < size; i++) {
+				_tail[_tail_size++] = data[i];
+			}
+		}
+
+		unsigned long long value() const {
+			snapshot_checksum last(*this);
+
+			std::memset(last._tail + last._tail_size, 0, sizeof(_tail) - last._tail_size);
+			last.mix(last._tail);
+			return last._h ^ _tail_size;
+		}
+
+	private:
+		void mix(const char *bytes) {
+			unsigned long long word;
+
+			std::memcpy(&word, bytes, sizeof(word));
+			_h = (_h ^ word) * 0x100000001B3ULL;
+			_h ^= _h >> 29;
+		}
+
+		unsigned long long _h;
+		char _tail[8];
+		size_t _tail_size;
+	};
+
+	/**
+	 * Forward iterator decoding the records of a snapshot in place, each only once it is dereferenced. The records must have been checked by snapshot_records().
+	 */
+	template<class Key, class T>
+	class snapshot_iterator {
+	public:
+		typedef ft::forward_iterator_tag iterator_category;
+		typedef ft::pair<Key, T> value_type;
+		typedef ptrdiff_t difference_type;
+		typedef const value_type *pointer;
+		typedef const value_type &reference;
+
+		explicit snapshot_iterator(const char *pos = nullptr, const char *end = nullptr) : _pos(pos), _end(end), _decoded(false) {}
+
+		reference operator*() const {
+			if (!_decoded) {
+				snapshot_traits<T>::read(snapshot_traits<Key>::read(_pos, _end, _value.first), _end, _value.second);
+				_decoded = true;
+			}
+			return _value;
+		}
+
+		pointer operator->() const {
+			return &operator*();
+		}
+
+		/**
+		 * Moves to the next record, without reading the records of fixed size. A record of varying size is decoded to find its end.
+		 */
+		snapshot_iterator &operator++() {
+			if (record_size != 0) {
+				_pos += record_size;
+			} else if (_decoded) {
+				_pos += snapshot_traits<Key>::size(_value.first) + snapshot_traits<T>::size(_value.second);
+			} else {
+				operator*();
+				_pos += snapshot_traits<Key>::size(_value.first) + snapshot_traits<T>::size(_value.second);
+			}
+			_decoded = false;
+			return *this;
+		}
+
+		snapshot_iterator operator++(int) {
+			snapshot_iterator tmp(*this);
+
+			++*this;
+			return tmp;
+		}
+
+		friend bool operator==(const snapshot_iterator &lhs, const snapshot_iterator &rhs) {
+			return lhs._pos == rhs._pos;
+		}
+
+		friend bool operator!=(const snapshot_iterator &lhs, const snapshot_iterator &rhs) {
+			return lhs._pos != rhs._pos;
+		}
+
+	private:
+		static const size_t record_size = (snapshot_traits<Key>::fixed_size && snapshot_traits<T>::fixed_size) ? snapshot_traits<Key>::fixed_size + snapshot_traits<T>::fixed_size : 0;
+
+		const char *_pos;
+		const char *_end;
+		mutable value_type _value;
+		mutable bool _decoded;
+	};
+
+	/**
+	 * Counts the records of varying size in [first, last), decoding each within the bounds of the range.
+	 * @return the number of records, or -1 if one does not fit before last
+	 */
+	template<class Key, class T>
+	unsigned long long snapshot_records(const char *first, const char *last) {
+		unsigned long long count = 0;
+		Key key;
+		T value;
+
+		while (first != last) {
+			first = snapshot_traits<Key>::read(first, last, key);
+			if (first != nullptr) {
+				first = snapshot_traits<T>::read(first, last, value);
+			}
+			if (first == nullptr) {
+				return static_cast<unsigned long long>(-1);
+			}
+			count++;
+		}
+		return count;
+	}
+
+	/**
+	 * Writes the elements of map to the snapshot file path, replacing it.
+	 * @param map the map to save
+	 * @param path the path of the snapshot file
+	 * @return false if the file could not be written
+	 */
+	template<class Map>
+	bool save_snapshot(const Map &map, const char *path) {
+		typedef typename Map::key_type key_type;
+		typedef typename Map::mapped_type mapped_type;
+		static const size_t chunk = 1 << 20;
+		std::ofstream file(path, std::ios::out | std::ios::binary | std::ios::trunc);
+		std::allocator<char> alloc;
+		char *buffer;
+		size_t used = 0;
+		snapshot_header header;
+		snapshot_checksum checksum;
+
+		if (!file) {
+			return false;
+		}
+		std::memset(&header, 0, sizeof(header));
+		std::memcpy(header.magic, "FTMAPSNP", sizeof(header.magic));
+		header.key_size = snapshot_traits<key_type>::fixed_size;
+		header.mapped_size = snapshot_traits<mapped_type>::fixed_size;
+		file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+		buffer = alloc.allocate(chunk);
+		for (typename Map::const_iterator it = map.begin(); it != map.end(); ++it) {
+			size_t size = snapshot_traits<key_type>::size((*it).first) + snapshot_traits<mapped_type>::size((*it).second);
+
+			if (used + size > chunk || size > chunk) {
+				checksum.update(buffer, used);
+				file.write(buffer, used);
+				header.bytes += used;
+				used = 0;
+			}
+			if (size > chunk) {
+				std::allocator<char> large;
+				char *record = large.allocate(size);
+
+				snapshot_traits<mapped_type>::write((*it).second, snapshot_traits<key_type>::write((*it).first, record));
+				checksum.update(record, size);
+				file.write(record, size);
+				header.bytes += size;
+				large.deallocate(record, size);
+			} else {
+				snapshot_traits<mapped_type>::write((*it).second, snapshot_traits<key_type>::write((*it).first, buffer + used));
+				used += size;
+			}
+			header.count++;
+		}
+		checksum.update(buffer, used);
+		file.write(buffer, used);
+		header.bytes += used;
+		header.checksum = checksum.value();
+		alloc.deallocate(buffer, chunk);
+		file.seekp(0);
+		file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+		file.close();
+		return !file.fail();
+	}
+
+	/**
+	 * Replaces the contents of map with the snapshot file path, mapped in memory. The records, already in key order, are linked into a balanced tree in O(n) by insert_sorted_batch(), those of fixed size copied without parsing.
+	 * The map must order the keys as the map that was saved. It is left unchanged if the file is not a valid snapshot of its types: records of varying size are first decoded within the bounds of the file, and their number must match the header.
+	 * @param map the map to load into
+	 * @param path the path of the snapshot file
+	 * @return false if the file could not be read, or is not a valid snapshot
+	 */
+	template<class Map>
+	bool load_snapshot(Map &map, const char *path) {
+		typedef typename Map::key_type key_type;
+		typedef typename Map::mapped_type mapped_type;
+		typedef ft::snapshot_iterator<key_type, mapped_type> iterator;
+		int fd = open(path, O_RDONLY);
+		struct stat info;
+		void *data;
+		const char *records;
+		snapshot_header header;
+		snapshot_checksum checksum;
+		bool valid;
+
+		if (fd < 0) {
+			return false;
+		}
+		if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(header)) {
+			close(fd);
+			return false;
+		}
+		data = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+		close(fd);
+		if (data == MAP_FAILED) {
+			return false;
+		}
+		madvise(data, info.st_size, MADV_SEQUENTIAL);
+		std::memcpy(&header, data, sizeof(header));
+		records = static_cast<const char *>(data) + sizeof(header);
+		valid = std::memcmp(header.magic, "FTMAPSNP", sizeof(header.magic)) == 0
+			&& header.key_size == snapshot_traits<key_type>::fixed_size
+			&& header.mapped_size == snapshot_traits<mapped_type>::fixed_size
+			&& header.bytes == static_cast<unsigned long long>(info.st_size) - sizeof(header)
+			&& (header.key_size == 0 || header.mapped_size == 0 || header.bytes == header.count * (header.key_size + header.mapped_size));
+		if (valid) {
+			checksum.update(records, header.bytes);
+			valid = checksum.value() == header.checksum;
+		}
+		if (valid && (header.key_size == 0 || header.mapped_size == 0)) {
+			valid = snapshot_records<key_type, mapped_type>(records, records + header.bytes) == header.count;
+		}
+		if (valid) {
+			Map loaded(map.key_comp());
+
+			loaded.insert_sorted_batch(iterator(records, records + header.bytes), iterator(records + header.bytes, records + header.bytes));
+			map.swap(loaded);
+		}
+		munmap(data, info.st_size);
+		return valid;
+	}
+
+}
+
+#endif //FT_CONTAINERS_MAP_SNAPSHOT_HPP
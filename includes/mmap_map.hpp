@@ -0,0 +1,470 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   mmap_map.hpp                                       :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: mmosca <mmosca@student.42lyon.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2022/07/30 10:12:47 by mmosca            #+#    #+#             */
+/*   Updated: 2022/07/30 10:12:47 by mmosca           ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef FT_CONTAINERS_MMAP_MAP_HPP
+#define FT_CONTAINERS_MMAP_MAP_HPP
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "utility.hpp"
+#include "arena_avl.hpp"
+
+namespace ft {
+
+	/**
+	 * Header at the start of an ft::mmap_map file. The arena follows it, at mmap_arena::data_offset.
+	 */
+	struct mmap_map_header {
+		char magic[8];
+		unsigned int node_size;
+		unsigned int key_size;
+		unsigned int mapped_size;
+		unsigned int dirty;
+		unsigned long long count;
+		unsigned long long capacity;
+		unsigned long long root;
+		unsigned long long free;
+		unsigned long long size;
+	};
+
+	/**
+	 * Arena of an ft::arena_avl_tree kept in a file mapped in memory, and used in place. The file grows by an eighth of its size, and by 1 MiB at least.
+	 * A closed arena holds nothing. Copies are closed arenas, the tree being constructed from a copy of one.
+	 * @tparam Node the node type, ft::ArenaNode
+	 */
+	template<class Node>
+	class mmap_arena {
+	public:
+		/**
+		 * Member types
+		 */
+		typedef Node value_type;
+		typedef size_t size_type;
+
+		/**
+		 * Offset of the first node in the file.
+		 */
+		static const size_t data_offset = 64;
+
+		mmap_arena() : _fd(-1), _data(nullptr), _mapped(0), _header(nullptr), _nodes(nullptr) {}
+
+		mmap_arena(const mmap_arena &) : _fd(-1), _data(nullptr), _mapped(0), _header(nullptr), _nodes(nullptr) {}
+
+		~mmap_arena() {
+			close();
+		}
+
+		/**
+		 * Maps the file path, created empty if it does not exist.
+		 * @param path the path of the file
+		 * @return false if the file could not be mapped, or is not an arena of Node that was checkpointed after its last change
+		 */
+		bool open(const char *path) {
+			struct stat info;
+			bool valid;
+
+			close();
+			_fd = ::open(path, O_RDWR | O_CREAT, 0644);
+			if (_fd < 0) {
+				return false;
+			}
+			if (fstat(_fd, &info) != 0) {
+				close();
+				return false;
+			}
+			if (info.st_size == 0) {
+				valid = resize(data_offset + chunk_bytes) && map(data_offset + chunk_bytes);
+				if (valid) {
+					std::memcpy(_header->magic, "FTMMAPMP", sizeof(_header->magic));
+					_header->node_size = sizeof(Node);
+					_header->key_size = sizeof(typename Node::value_type::first_type);
+					_header->mapped_size = sizeof(typename Node::value_type::second_type);
+					_header->capacity = chunk_bytes / sizeof(Node);
+				}
+			} else {
+				valid = static_cast<size_t>(info.st_size) >= data_offset && map(info.st_size) && check();
+			}
+			if (!valid) {
+				close();
+			}
+			return valid;
+		}
+
+		/**
+		 * Unmaps the file, without writing anything to it.
+		 */
+		void close() {
+			if (_data) {
+				munmap(_data, _mapped);
+			}
+			if (_fd >= 0) {
+				::close(_fd);
+			}
+			_fd = -1;
+			_data = nullptr;
+			_mapped = 0;
+			_header = nullptr;
+			_nodes = nullptr;
+		}
+
+		bool is_open() const {
+			return _header != nullptr;
+		}
+
+		const mmap_map_header &header() const {
+			return *_header;
+		}
+
+		/**
+		 * Marks the file as changed since its last checkpoint, on the disk, before a first change.
+		 */
+		void touch() {
+			if (_header && !_header->dirty) {
+				_header->dirty = 1;
+				msync(_data, data_offset, MS_SYNC);
+			}
+		}
+
+		/**
+		 * Records the tree in the header and flushes the file to the disk, then marks it unchanged.
+		 * @param root the index of the root of the tree
+		 * @param free the head of the free list of the tree
+		 * @param size the number of nodes in the tree
+		 * @return false if the file could not be written
+		 */
+		bool checkpoint(unsigned long long root, unsigned long long free, unsigned long long size) {
+			_header->root = root;
+			_header->free = free;
+			_header->size = size;
+			if (msync(_data, _mapped, MS_SYNC) != 0) {
+				return false;
+			}
+			_header->dirty = 0;
+			return msync(_data, data_offset, MS_SYNC) == 0;
+		}
+
+		size_type size() const {
+			return _header ? _header->count : 0;
+		}
+
+		size_type max_size() const {
+			return (static_cast<size_type>(-1) - data_offset) / sizeof(Node);
+		}
+
+		Node &operator[](size_type index) {
+			return _nodes[index];
+		}
+
+		const Node &operator[](size_type index) const {
+			return _nodes[index];
+		}
+
+		/**
+		 * Appends node, growing the file when it is full.
+		 * @throw std::bad_alloc if the file could not grow
+		 */
+		void push_back(const Node &node) {
+			if (_header->count == _header->capacity) {
+				grow(_header->count + 1);
+			}
+			std::allocator<Node>().construct(_nodes + _header->count, node);
+			_header->count++;
+		}
+
+		void reserve(size_type capacity) {
+			if (_header && capacity > _header->capacity) {
+				grow(capacity);
+			}
+		}
+
+		/**
+		 * Forgets the nodes, the file keeps its size.
+		 */
+		void clear() {
+			if (_header) {
+				_header->count = 0;
+			}
+		}
+
+		void swap(mmap_arena &other) {
+			std::swap(_fd, other._fd);
+			std::swap(_data, other._data);
+			std::swap(_mapped, other._mapped);
+			std::swap(_header, other._header);
+			std::swap(_nodes, other._nodes);
+		}
+
+	private:
+		static const size_t chunk_bytes = 1 << 20;
+
+		mmap_arena &operator=(const mmap_arena &);
+
+		bool map(size_t bytes) {
+			void *data = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, _fd, 0);
+
+			if (data == MAP_FAILED) {
+				return false;
+			}
+			attach(data, bytes);
+			return true;
+		}
+
+		void attach(void *data, size_t bytes) {
+			_data = static_cast<char *>(data);
+			_mapped = bytes;
+			_header = reinterpret_cast<mmap_map_header *>(_data);
+			_nodes = reinterpret_cast<Node *>(_data + data_offset);
+		}
+
+		/**
+		 * Extends the file to bytes. On Linux the blocks are allocated at once, so that a full disk fails here and not on a later write to the mapping.
+		 */
+		bool resize(size_t bytes) {
+#ifdef __linux__
+			return posix_fallocate(_fd, _mapped, bytes - _mapped) == 0;
+#else
+			return ftruncate(_fd, bytes) == 0;
+#endif
+		}
+
+		/**
+		 * Grows the file to hold capacity nodes at least, and maps it again. On Linux the mapping is extended in place or moved by mremap, keeping its pages.
+		 */
+		void grow(size_type capacity) {
+			size_type grown = _header->capacity + std::max<size_type>(_header->capacity / 8, chunk_bytes / sizeof(Node));
+			size_t bytes = data_offset + std::max(capacity, grown) * sizeof(Node);
+			void *data;
+
+			if (!resize(bytes)) {
+				throw std::bad_alloc();
+			}
+#ifdef __linux__
+			data = mremap(_data, _mapped, bytes, MREMAP_MAYMOVE);
+#else
+			data = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, _fd, 0);
+			if (data != MAP_FAILED) {
+				munmap(_data, _mapped);
+			}
+#endif
+			if (data == MAP_FAILED) {
+				throw std::bad_alloc();
+			}
+			attach(data, bytes);
+			_header->capacity = (bytes - data_offset) / sizeof(Node);
+		}
+
+		/**
+		 * Checks that the mapped file is an arena of Node, consistent with its size and unchanged since its last checkpoint.
+		 */
+		bool check() const {
+			return std::memcmp(_header->magic, "FTMMAPMP", sizeof(_header->magic)) == 0
+				&& _header->node_size == sizeof(Node)
+				&& _header->key_size == sizeof(typename Node::value_type::first_type)
+				&& _header->mapped_size == sizeof(typename Node::value_type::second_type)
+				&& _header->dirty == 0
+				&& _header->capacity <= (_mapped - data_offset) / sizeof(Node)
+				&& _header->count <= _header->capacity
+				&& _header->root <= _header->count
+				&& _header->free <= _header->count
+				&& _header->size <= _header->count;
+		}
+
+		/**
+		 * Member objects
+		 */
+		int _fd;
+		char *_data;
+		size_t _mapped;
+		mmap_map_header *_header;
+		Node *_nodes;
+	};
+
+	/**
+	 * ft::mmap_map is an ordered map kept in a file mapped in memory. Its ft::arena_avl_tree links the nodes by indices, so the file is the map as is, and opening it takes the same time whatever its size.
+	 * Changes reach the file through the page cache, checkpoint() makes them durable. A file changed after its last checkpoint is refused by open(): its pages may have reached the disk partially. For every change to be seen, values are only written through operator[] and insert(), iterators are const.
+	 * Keys are ordered by operator<, as in ft::arena_avl_tree. Key and T are stored as their bytes, so they must own no memory nor resource.
+	 * @tparam Key the type of the keys
+	 * @tparam T the type of the mapped values
+	 */
+	template<class Key, class T>
+	class mmap_map {
+	public:
+		/**
+		 * Member types
+		 */
+		typedef Key key_type;
+		typedef T mapped_type;
+		typedef ft::pair<Key, T> value_type;
+		typedef size_t size_type;
+		typedef ft::arena_avl_tree<Key, T, ft::mmap_arena<ft::ArenaNode<Key, T> > > tree_type;
+		typedef ft::arena_iterator<tree_type, const value_type> iterator;
+		typedef iterator const_iterator;
+
+		/**
+		 * Constructs a closed map, to open() before use.
+		 */
+		mmap_map() : _tree() {}
+
+		/**
+		 * Constructs the map held by the file path, see open().
+		 * @param path the path of the file
+		 */
+		explicit mmap_map(const char *path) : _tree() {
+			open(path);
+		}
+
+		/**
+		 * Checkpoints and closes the map.
+		 */
+		~mmap_map() {
+			close();
+		}
+
+		/**
+		 * Closes the map, then opens the one held by the file path, or a new empty one if the file does not exist.
+		 * @param path the path of the file
+		 * @return false if the file could not be mapped, is not a map of Key and T, or was changed after its last checkpoint
+		 */
+		bool open(const char *path) {
+			close();
+			if (!_tree.arena().open(path)) {
+				return false;
+			}
+			_tree.restore(_tree.arena().header().root, _tree.arena().header().free, _tree.arena().header().size);
+			return true;
+		}
+
+		bool is_open() const {
+			return _tree.arena().is_open();
+		}
+
+		/**
+		 * Writes the changes to the disk, msync returning once they are there.
+		 * @return false if the map is closed or the file could not be written
+		 */
+		bool checkpoint() {
+			return is_open() && _tree.arena().checkpoint(_tree.getRoot(), _tree.getFree(), _tree.getSize());
+		}
+
+		/**
+		 * Checkpoints and unmaps the file, leaving the map closed.
+		 * @return false if the last checkpoint failed
+		 */
+		bool close() {
+			bool synced = !is_open() || checkpoint();
+
+			_tree.arena().close();
+			_tree.restore(0, 0, 0);
+			return synced;
+		}
+
+		iterator begin() const {
+			return _tree.begin();
+		}
+
+		iterator end() const {
+			return _tree.end();
+		}
+
+		bool empty() const {
+			return _tree.isEmpty();
+		}
+
+		size_type size() const {
+			return _tree.getSize();
+		}
+
+		/**
+		 * Returns a reference to the value mapped to key, inserted if it did not exist.
+		 * @param key the key of the element to find
+		 * @return reference to the mapped value
+		 */
+		mapped_type &operator[](const key_type &key) {
+			value_type value(key, mapped_type());
+
+			_tree.arena().touch();
+			if (_tree.find(value) == 0) {
+				_tree.insert(value);
+			}
+			return _tree.node(_tree.find(value)).value.second;
+		}
+
+		/**
+		 * Inserts value if the map does not already contain its key.
+		 * @param value element value to insert
+		 * @return a pair of an iterator to the element with the key of value, and a bool true if value was inserted
+		 * @throw std::bad_alloc if the file could not grow
+		 */
+		ft::pair<iterator, bool> insert(const value_type &value) {
+			size_type previousSize = _tree.getSize();
+
+			_tree.arena().touch();
+			_tree.insert(value);
+			return ft::make_pair(find(value.first), previousSize != _tree.getSize());
+		}
+
+		/**
+		 * Removes the element with the key key, its slot is reused by the next insertion.
+		 * @param key key value of the element to remove
+		 * @return number of elements removed, 0 or 1
+		 */
+		size_type erase(const key_type &key) {
+			if (find(key) == end()) {
+				return 0;
+			}
+			_tree.arena().touch();
+			_tree.remove(ft::make_pair(key, mapped_type()));
+			return 1;
+		}
+
+		/**
+		 * Erases all elements, the file keeps its size.
+		 */
+		void clear() {
+			_tree.arena().touch();
+			_tree.clear_tree();
+		}
+
+		iterator find(const key_type &key) const {
+			return _tree.find_iterator(ft::make_pair(key, mapped_type()));
+		}
+
+		size_type count(const key_type &key) const {
+			return find(key) != end();
+		}
+
+		/**
+		 * Returns an iterator to the first element whose key is not less than key, in O(log n).
+		 */
+		iterator lower_bound(const key_type &key) const {
+			return _tree.make_iterator(_tree.lower_bound(ft::make_pair(key, mapped_type())));
+		}
+
+	private:
+		mmap_map(const mmap_map &);
+		mmap_map &operator=(const mmap_map &);
+
+		/**
+		 * Member objects
+		 */
+		tree_type _tree;
+	};
+
+}
+
+#endif //FT_CONTAINERS_MMAP_MAP_HPP
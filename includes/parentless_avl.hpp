@@ -0,0 +1,494 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   parentless_avl.hpp                                 :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: mmosca <mmosca@student.42lyon.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2022/07/19 15:02:44 by mmosca            #+#    #+#             */
+/*   Updated: 2022/07/19 15:02:44 by mmosca           ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef FT_CONTAINERS_PARENTLESS_AVL_HPP
+#define FT_CONTAINERS_PARENTLESS_AVL_HPP
+
+#include <memory>
+#include <algorithm>
+#include <stdexcept>
+#include "iterator.hpp"
+#include "utility.hpp"
+
+namespace ft {
+
+	/**
+	 * Tree node without a parent link: two children, the value and a 32 bit height.
+	 */
+	template<typename U, typename V>
+	class ParentlessNode {
+	public:
+		/**
+		 * Member types
+		 */
+		typedef ft::pair<U, V> value_type;
+
+		/**
+		 * Member objects
+		 */
+		ParentlessNode *left;
+		ParentlessNode *right;
+		value_type value;
+
+		/**
+		 * Constructor initialized value with value.
+		 * @param value value to initialized
+		 */
+		ParentlessNode(const value_type &value) : left(nullptr), right(nullptr), value(value), _height(1) {}
+
+		/**
+		 * Allows you to update the height of the tree.
+		 */
+		void updateHeight() {
+			_height = 1 + std::max(left ? left->_height : 0, right ? right->_height : 0);
+		}
+
+		/**
+		 * Returns the height of the tree.
+		 * @return the height of the tree
+		 */
+		int height() const {
+			return _height;
+		}
+
+		/**
+		 * Allows to know if the tree is balanced.
+		 * @return the result of the subtraction of the left and right height
+		 */
+		long balance() const {
+			return (left ? left->_height : 0) - (right ? right->_height : 0);
+		}
+
+	private:
+		/**
+		 * Member objects
+		 */
+		int _height;
+	};
+
+	/**
+	 * Bidirectional iterator over a parentless_avl_tree. It carries the path from the root to the current node, an empty path standing for end().
+	 * Since rotations change the paths, inserting or erasing invalidates every iterator of the tree; ft::map::erase(first, last) collects the keys first for that reason.
+	 */
+	template<typename T>
+	class stack_iterator : public ft::iterator<ft::bidirectional_iterator_tag, T> {
+	public:
+		/**
+		 * Member types
+		 */
+		typedef typename T::value_type value_type;
+		typedef typename ft::iterator<ft::bidirectional_iterator_tag, value_type>::iterator_category iterator_category;
+		typedef typename ft::iterator<ft::bidirectional_iterator_tag, value_type>::difference_type difference_type;
+		typedef typename ft::iterator<ft::bidirectional_iterator_tag, value_type>::pointer pointer;
+		typedef typename ft::iterator<ft::bidirectional_iterator_tag, value_type>::reference reference;
+
+		/**
+		 * Member constants: an AVL tree 65 levels deep has more than 2^45 nodes, beyond any address space, and parentless_avl_tree refuses to grow past this depth.
+		 */
+		static const size_t max_depth = 64;
+
+		/**
+		 * Member objects
+		 */
+		T *_root;
+		T *_path[max_depth];
+		size_t _depth;
+
+		stack_iterator() : _root(nullptr), _depth(0) {}
+
+		explicit stack_iterator(T *root) : _root(root), _depth(0) {}
+
+		/**
+		 * Only the used part of the path is copied.
+		 */
+		stack_iterator(const stack_iterator &other) : _root(other._root), _depth(other._depth) {
+			std::copy(other._path, other._path + _depth, _path);
+		}
+
+		template<typename U>
+		stack_iterator(const ft::stack_iterator<U> &other) : _root(other._root), _depth(other._depth) {
+			std::copy(other._path, other._path + _depth, _path);
+		}
+
+		stack_iterator &operator=(const stack_iterator &other) {
+			_root = other._root;
+			_depth = other._depth;
+			std::copy(other._path, other._path + _depth, _path);
+			return *this;
+		}
+
+		/**
+		 * Returns the current node, or nullptr at end().
+		 */
+		T *node() const {
+			return _depth ? _path[_depth - 1] : nullptr;
+		}
+
+		reference operator*() const {
+			return node()->value;
+		}
+
+		pointer operator->() const {
+			return &node()->value;
+		}
+
+		pointer base() const {
+			return &node()->value;
+		}
+
+		/**
+		 * Pushes node and its left spine.
+		 */
+		void push_leftmost(T *node) {
+			for (; node; node = node->left) {
+				_path[_depth++] = node;
+			}
+		}
+
+		/**
+		 * Pushes node and its right spine.
+		 */
+		void push_rightmost(T *node) {
+			for (; node; node = node->right) {
+				_path[_depth++] = node;
+			}
+		}
+
+		stack_iterator &operator++() {
+			T *current = node();
+
+			if (current->right) {
+				push_leftmost(current->right);
+				return *this;
+			}
+			_depth--;
+			while (_depth && _path[_depth - 1]->right == current) {
+				current = _path[--_depth];
+			}
+			return *this;
+		}
+
+		stack_iterator operator++(int) {
+			stack_iterator tmp(*this);
+			++*this;
+			return tmp;
+		}
+
+		stack_iterator &operator--() {
+			T *current = node();
+
+			if (current == nullptr) {
+				push_rightmost(_root);
+				return *this;
+			}
+			if (current->left) {
+				push_rightmost(current->left);
+				return *this;
+			}
+			_depth--;
+			while (_depth && _path[_depth - 1]->left == current) {
+				current = _path[--_depth];
+			}
+			return *this;
+		}
+
+		stack_iterator operator--(int) {
+			stack_iterator tmp(*this);
+			--*this;
+			return tmp;
+		}
+	};
+
+	template<typename U, typename V>
+	bool operator==(const ft::stack_iterator<U> &lhs, const ft::stack_iterator<V> &rhs) {
+		return lhs.node() == rhs.node();
+	}
+
+	template<typename U, typename V>
+	bool operator!=(const ft::stack_iterator<U> &lhs, const ft::stack_iterator<V> &rhs) {
+		return lhs.node() != rhs.node();
+	}
+
+	/**
+	 * AVL tree whose nodes have no parent link. Insert and remove rebalance on the way back up their recursive descent, and iterators carry their own ancestor stack.
+	 * It exposes the interface of ft::avl_tree and can be given to ft::map as its Tree.
+	 * @tparam U the type of the keys
+	 * @tparam V the type of the mapped values
+	 */
+	template<typename U, typename V, class Node = ParentlessNode<U, V>, class Allocator = std::allocator<Node> >
+	class parentless_avl_tree {
+	public:
+		/**
+		 * Member types
+		 */
+		typedef ft::pair<U, V> value_type;
+		typedef Node node_type;
+		typedef Node* node_pointer;
+		typedef Allocator node_allocator;
+		typedef typename ft::stack_iterator<Node> iterator;
+		typedef typename ft::stack_iterator<Node> const_iterator;
+		typedef typename node_allocator::size_type size_type;
+
+		/**
+		 * Constructor with allocator in parameter.
+		 * @param node_alloc allocator to set
+		 */
+		parentless_avl_tree(const node_allocator &node_alloc = node_allocator()) : _root(nullptr), _alloc(node_alloc), _size(0) {}
+
+		/**
+		 * Destructor.
+		 */
+		~parentless_avl_tree() {
+			clear_tree();
+		}
+
+		void clear_tree() {
+			clear_tree(_root);
+			_size = 0;
+			_root = nullptr;
+		}
+
+		/**
+		 * Inserts value unless its key is present.
+		 * @throw std::length_error if the tree would be deeper than the path of its iterators
+		 */
+		void insert(value_type value) {
+			_root = insert(value, _root);
+			if (static_cast<size_t>(_root->height()) > iterator::max_depth) {
+				_root = remove(value, _root);
+				throw std::length_error("parentless_avl_tree");
+			}
+		}
+
+		void remove(value_type value) {
+			_root = remove(value, _root);
+		}
+
+		bool isEmpty() const {
+			return _root == nullptr;
+		}
+
+		size_type getSize() const {
+			return _size;
+		}
+
+		size_type getMaxSize() const {
+			return _alloc.max_size();
+		}
+
+		node_pointer find(value_type value) const {
+			node_pointer node = _root;
+
+			while (node && !(node->value.first == value.first)) {
+				node = (node->value.first < value.first) ? node->right : node->left;
+			}
+			return node;
+		}
+
+		/**
+		 * Looks up every key of [first, last) and writes the node holding it, or nullptr, to out, interleaving the descents like avl_tree::find_many.
+		 * @param first the range of keys to look up, traversed once
+		 * @param last the range of keys to look up
+		 * @param out the destination of the nodes, in the order of the keys
+		 * @return out past the last node written
+		 */
+		template<class ForwardIt, class OutputIt>
+		OutputIt find_many(ForwardIt first, ForwardIt last, OutputIt out) const {
+			ForwardIt keys[batch_width];
+			node_pointer nodes[batch_width];
+
+			while (first != last) {
+				size_t count = 0;
+
+				for (; count < batch_width && first != last; ++count, ++first) {
+					keys[count] = first;
+					nodes[count] = _root;
+				}
+				for (bool moved = true; moved; ) {
+					moved = false;
+					for (size_t i = 0; i < count; i++) {
+						node_pointer node = nodes[i];
+
+						if (node == nullptr || node->value.first == *keys[i]) {
+							continue;
+						}
+						node = (node->value.first < *keys[i]) ? node->right : node->left;
+						if (node) {
+							__builtin_prefetch(node);
+							moved = true;
+						}
+						nodes[i] = node;
+					}
+				}
+				for (size_t i = 0; i < count; i++) {
+					*out++ = nodes[i];
+				}
+			}
+			return out;
+		}
+
+		node_pointer getRoot() const {
+			return _root;
+		}
+
+		iterator begin() const {
+			iterator it(_root);
+
+			it.push_leftmost(_root);
+			return it;
+		}
+
+		iterator end() const {
+			return iterator(_root);
+		}
+
+		/**
+		 * Returns an iterator to node, or end() for nullptr, by descending again from the root to rebuild its path.
+		 */
+		iterator make_iterator(node_pointer node) const {
+			return node ? find_iterator(node->value) : end();
+		}
+
+		/**
+		 * Returns an iterator to the node holding the key of value, or end(), recording the path while searching.
+		 */
+		iterator find_iterator(const value_type &value) const {
+			iterator it(_root);
+
+			for (node_pointer node = _root; node; node = (node->value.first < value.first) ? node->right : node->left) {
+				it._path[it._depth++] = node;
+				if (node->value.first == value.first) {
+					return it;
+				}
+			}
+			return end();
+		}
+
+		void swap(parentless_avl_tree &t) {
+			std::swap(_root, t._root);
+			std::swap(_alloc, t._alloc);
+			std::swap(_size, t._size);
+		}
+
+	private:
+		/**
+		 * Number of descents find_many interleaves.
+		 */
+		static const size_t batch_width = 16;
+
+		node_pointer insert(const value_type &value, node_pointer node) {
+			if (node == nullptr) {
+				node_pointer newNode = _alloc.allocate(1);
+				_alloc.construct(newNode, node_type(value));
+				_size++;
+				return newNode;
+			}
+			if (node->value.first == value.first) {
+				return node;
+			}
+			if (node->value.first < value.first) {
+				node->right = insert(value, node->right);
+			} else {
+				node->left = insert(value, node->left);
+			}
+			node->updateHeight();
+			return applyRotation(node);
+		}
+
+		node_pointer applyRotation(node_pointer node) {
+			long balance = node->balance();
+
+			if (balance < -1) {
+				if (node->right->balance() > 0) {
+					node->right = rightRotation(node->right);
+				}
+				return leftRotation(node);
+			} else if (balance > 1) {
+				if (node->left->balance() < 0) {
+					node->left = leftRotation(node->left);
+				}
+				return rightRotation(node);
+			}
+			return node;
+		}
+
+		node_pointer leftRotation(node_pointer node) {
+			node_pointer right = node->right;
+
+			node->right = right->left;
+			right->left = node;
+			node->updateHeight();
+			right->updateHeight();
+			return right;
+		}
+
+		node_pointer rightRotation(node_pointer node) {
+			node_pointer left = node->left;
+
+			node->left = left->right;
+			left->right = node;
+			node->updateHeight();
+			left->updateHeight();
+			return left;
+		}
+
+		node_pointer remove(const value_type &value, node_pointer node) {
+			if (node == nullptr) {
+				return nullptr;
+			}
+			if (node->value.first == value.first) {
+				if (node->left != nullptr && node->right != nullptr) {
+					node_pointer max = node->left;
+
+					while (max->right) {
+						max = max->right;
+					}
+					node->value = max->value;
+					node->left = remove(node->value, node->left);
+				} else {
+					node_pointer tmp = (node->left == nullptr) ? node->right : node->left;
+
+					_alloc.destroy(node);
+					_alloc.deallocate(node, 1);
+					_size--;
+					return tmp;
+				}
+			} else if (node->value.first < value.first) {
+				node->right = remove(value, node->right);
+			} else {
+				node->left = remove(value, node->left);
+			}
+			node->updateHeight();
+			return applyRotation(node);
+		}
+
+		void clear_tree(node_pointer node) {
+			if (node == nullptr) {
+				return;
+			}
+			clear_tree(node->left);
+			clear_tree(node->right);
+			_alloc.destroy(node);
+			_alloc.deallocate(node, 1);
+		}
+
+		/**
+		 * Member objects
+		 */
+		node_pointer _root;
+		node_allocator _alloc;
+		size_t _size;
+	};
+
+}
+
+#endif //FT_CONTAINERS_PARENTLESS_AVL_HPP
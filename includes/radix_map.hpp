@@ -0,0 +1,271 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   radix_map.hpp                                      :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: mmosca <mmosca@student.42lyon.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2022/07/25 10:05:52 by mmosca            #+#    #+#             */
+/*   Updated: 2022/07/25 10:05:52 by mmosca           ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef FT_CONTAINERS_RADIX_MAP_HPP
+#define FT_CONTAINERS_RADIX_MAP_HPP
+
+#include <memory>
+#include <stdexcept>
+#include "utility.hpp"
+#include "iterator.hpp"
+#include "art.hpp"
+
+namespace ft {
+
+	/**
+	 * Reads a string-like key, any type with size() and operator[] returning characters, byte by byte in the order of its operator<.
+	 */
+	template<class Key>
+	struct string_key_traits {
+		static size_t length(const Key &key) {
+			return key.size();
+		}
+
+		static unsigned char byte(const Key &key, size_t i) {
+			return static_cast<unsigned char>(key[i]);
+		}
+	};
+
+	/**
+	 * ft::radix_map is a sorted associative container of string-like keys, stored in an adaptive radix tree: a lookup reads each byte of the key once, instead of comparing whole keys from their first byte at every level of a binary tree.
+	 * Shared prefixes, as in URL paths or metric names, are stored once in the inner nodes. The elements are linked in key order, so iteration and prefix_range() are as cheap as in ft::map.
+	 * @tparam Key the type of the keys, std::string by default
+	 * @tparam T the type of the mapped values
+	 * @tparam Traits provides length(key) and byte(key, i), in the order of the keys
+	 * @tparam Allocator an allocator that is used for the elements and the inner nodes
+	 */
+	template<class Key, class T, class Traits = ft::string_key_traits<Key>, class Allocator = std::allocator<ft::pair<const Key, T> > >
+	class radix_map {
+	public:
+		/**
+		 * Member types
+		 */
+		typedef Key key_type;
+		typedef T mapped_type;
+		typedef ft::pair<const Key, T> value_type;
+		typedef ft::pair<Key, T> node_value_type;
+		typedef size_t size_type;
+		typedef ptrdiff_t difference_type;
+		typedef Allocator allocator_type;
+		typedef ft::art_tree<Key, T, Traits, Allocator> tree_type;
+		typedef typename tree_type::iterator iterator;
+		typedef typename tree_type::const_iterator const_iterator;
+		typedef typename ft::reverse_iterator<iterator> reverse_iterator;
+		typedef typename ft::reverse_iterator<const_iterator> const_reverse_iterator;
+
+		/**
+		 * Constructs an empty container.
+		 * @param alloc allocator to use for all memory allocations of this container
+		 */
+		explicit radix_map(const allocator_type &alloc = allocator_type()) : _tree(alloc) {}
+
+		/**
+		 * Copy constructor. Constructs the container with the copy of the contents of other.
+		 * @param other another container to be used as source to initialize the elements of the container with
+		 */
+		radix_map(const radix_map &other) {
+			insert(other.begin(), other.end());
+		}
+
+		/**
+		 * Copy assignment operator. Replaces the contents with a copy of the contents of other.
+		 * @param other another container to use as data source
+		 * @return *this
+		 */
+		radix_map &operator=(const radix_map &other) {
+			if (this != &other) {
+				clear();
+				insert(other.begin(), other.end());
+			}
+			return *this;
+		}
+
+		/**
+		 * Returns a reference to the value that is mapped to a key equivalent to key, performing an insertion if such key does not already exist.
+		 * @param key the key of the element to find
+		 * @return reference to the mapped value of the new element if no element with key key existed
+		 */
+		mapped_type &operator[](const key_type &key) {
+			return insert(value_type(key, mapped_type())).first->second;
+		}
+
+		/**
+		 * Returns a reference to the mapped value of the element with key equivalent to key.
+		 * @param key the key of the element to find
+		 * @return reference to the mapped value of the requested element
+		 */
+		mapped_type &at(const key_type &key) const {
+			iterator it = find(key);
+
+			if (it == end()) {
+				throw std::out_of_range("ft::radix_map::at: key not found");
+			}
+			return it->second;
+		}
+
+		iterator begin() const {
+			return iterator(&_tree, _tree.first());
+		}
+
+		iterator end() const {
+			return iterator(&_tree, nullptr);
+		}
+
+		reverse_iterator rbegin() const {
+			return reverse_iterator(end());
+		}
+
+		reverse_iterator rend() const {
+			return reverse_iterator(begin());
+		}
+
+		bool empty() const {
+			return _tree.size() == 0;
+		}
+
+		size_type size() const {
+			return _tree.size();
+		}
+
+		/**
+		 * Erases all elements from the container.
+		 */
+		void clear() {
+			_tree.clear();
+		}
+
+		/**
+		 * Inserts value if the container doesn't already contain an element with an equivalent key.
+		 * @param value element value to insert
+		 * @return Returns a pair consisting of an iterator to the inserted element and a bool denoting whether the insertion took place
+		 */
+		ft::pair<iterator, bool> insert(const value_type &value) {
+			ft::pair<typename tree_type::leaf *, bool> result = _tree.insert(node_value_type(value.first, value.second));
+
+			return ft::make_pair(iterator(&_tree, result.first), result.second);
+		}
+
+		/**
+		 * Inserts elements from range [first, last).
+		 * @param first range of elements to insert
+		 * @param last range of elements to insert
+		 */
+		template<class InputIt>
+		void insert(InputIt first, InputIt last) {
+			for (; first != last; ++first) {
+				insert(value_type((*first).first, (*first).second));
+			}
+		}
+
+		/**
+		 * Removes the element at pos.
+		 * @param pos iterator to the element to remove
+		 */
+		void erase(iterator pos) {
+			_tree.erase(pos->first);
+		}
+
+		/**
+		 * Removes the elements in the range [first, last).
+		 * @param first range of elements to remove
+		 * @param last range of elements to remove
+		 */
+		void erase(iterator first, iterator last) {
+			while (first != last) {
+				erase(first++);
+			}
+		}
+
+		/**
+		 * Removes the element (if one exists) with the key equivalent to key.
+		 * @param key key value of the elements to remove
+		 * @return Number of elements removed (0 or 1).
+		 */
+		size_type erase(const key_type &key) {
+			return _tree.erase(key) ? 1 : 0;
+		}
+
+		/**
+		 * Exchanges the contents of the container with those of other. Iterators keep pointing to the same elements, now in the other container.
+		 * @param other container to exchange the contents with
+		 */
+		void swap(radix_map &other) {
+			_tree.swap(other._tree);
+		}
+
+		size_type count(const key_type &key) const {
+			return _tree.find(key) ? 1 : 0;
+		}
+
+		/**
+		 * Finds an element with key equivalent to key.
+		 * @param key key value of the element to search for
+		 * @return iterator to an element with key equivalent to key, or end()
+		 */
+		iterator find(const key_type &key) const {
+			return iterator(&_tree, _tree.find(key));
+		}
+
+		/**
+		 * Returns an iterator pointing to the first element that is not less than key.
+		 * @param key key value to compare the elements to
+		 * @return iterator pointing to the first element that is not less than key
+		 */
+		iterator lower_bound(const key_type &key) const {
+			return iterator(&_tree, _tree.lower_bound(key));
+		}
+
+		/**
+		 * Returns an iterator pointing to the first element that is greater than key.
+		 * @param key key value to compare the elements to
+		 * @return iterator pointing to the first element that is greater than key
+		 */
+		iterator upper_bound(const key_type &key) const {
+			iterator it = lower_bound(key);
+
+			return (it != end() && it->first == key) ? ++it : it;
+		}
+
+		ft::pair<iterator, iterator> equal_range(const key_type &key) const {
+			return ft::make_pair(lower_bound(key), upper_bound(key));
+		}
+
+		/**
+		 * Returns the range of the elements whose keys start with prefix, in O(length of prefix).
+		 * @param prefix the common prefix of the keys, a key of the same type
+		 * @return a pair of iterators, the first not less than prefix, the second past the last key starting with prefix
+		 */
+		ft::pair<iterator, iterator> prefix_range(const key_type &prefix) const {
+			key_type next(prefix);
+			size_type length = Traits::length(prefix);
+
+			while (length > 0 && Traits::byte(prefix, length - 1) == 0xff) {
+				length--;
+			}
+			if (length == 0) {
+				return ft::make_pair(lower_bound(prefix), end());
+			}
+			next.resize(length);
+			next[length - 1] = static_cast<typename key_type::value_type>(Traits::byte(prefix, length - 1) + 1);
+			return ft::make_pair(lower_bound(prefix), lower_bound(next));
+		}
+
+	private:
+		/**
+		 * Member objects
+		 */
+		tree_type _tree;
+	};
+
+}
+
+#endif //FT_CONTAINERS_RADIX_MAP_HPP
@@ -0,0 +1,552 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   skiplist_map.hpp                                   :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: mmosca <mmosca@student.42lyon.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2022/07/15 09:12:40 by mmosca            #+#    #+#             */
+/*   Updated: 2022/07/15 09:12:40 by mmosca           ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef FT_CONTAINERS_SKIPLIST_MAP_HPP
+#define FT_CONTAINERS_SKIPLIST_MAP_HPP
+
+#include <functional>
+#include <memory>
+#include <new>
+#include "utility.hpp"
+#include "iterator.hpp"
+#include "epoch.hpp"
+
+namespace ft {
+
+	/**
+	 * ft::skiplist_map is an ordered associative container whose insert, find and erase are lock-free.
+	 * Elements are linked in a skip list, an element is erased by marking the low bit of each of its links before it is unlinked, and the unlinked towers are released through an ft::epoch_domain.
+	 * Iterators are only valid while the thread holding them is pinned, through a skiplist_map::guard.
+	 * @tparam Key the type of the keys
+	 * @tparam T the type of the mapped values
+	 * @tparam Compare comparison function object used to order the keys
+	 * @tparam Allocator an allocator that is used to acquire/release memory and to construct/destroy the elements in that memory
+	 */
+	template<class Key, class T, class Compare = std::less<Key>, class Allocator = std::allocator<ft::pair<const Key, T> > >
+	class skiplist_map {
+	private:
+		/**
+		 * Member classes
+		 */
+		struct node {
+			ft::pair<const Key, T> value;
+			int level;
+			int refs;
+			node *next[1];
+
+			node(const ft::pair<const Key, T> &value, int level) : value(value), level(level), refs(2) {}
+		};
+
+	public:
+		/**
+		 * Member types
+		 */
+		typedef Key key_type;
+		typedef T mapped_type;
+		typedef ft::pair<const Key, T> value_type;
+		typedef Compare key_compare;
+		typedef size_t size_type;
+		typedef ptrdiff_t difference_type;
+		typedef Allocator allocator_type;
+		typedef typename Allocator::template rebind<char>::other byte_allocator;
+
+		/**
+		 * Member constants
+		 */
+		static const int max_level = 32;
+
+		/**
+		 * Constant forward iterator following the bottom level of the list, skipping the elements being erased.
+		 */
+		class const_iterator : public ft::iterator<ft::forward_iterator_tag, const value_type> {
+		public:
+			typedef const value_type &reference;
+			typedef const value_type *pointer;
+
+			const_iterator() : _node(nullptr) {}
+
+			reference operator*() const {
+				return _node->value;
+			}
+
+			pointer operator->() const {
+				return &_node->value;
+			}
+
+			const_iterator &operator++() {
+				_node = skiplist_map::live(strip(load(_node->next[0])));
+				return *this;
+			}
+
+			const_iterator operator++(int) {
+				const_iterator tmp(*this);
+				++*this;
+				return tmp;
+			}
+
+			friend bool operator==(const const_iterator &lhs, const const_iterator &rhs) {
+				return lhs._node == rhs._node;
+			}
+
+			friend bool operator!=(const const_iterator &lhs, const const_iterator &rhs) {
+				return lhs._node != rhs._node;
+			}
+
+		private:
+			friend class skiplist_map;
+
+			explicit const_iterator(node *n) : _node(n) {}
+
+			node *_node;
+		};
+		typedef const_iterator iterator;
+
+		/**
+		 * Keeps the calling thread pinned, so that the elements it reaches through iterators are not released.
+		 */
+		class guard : public epoch_domain::guard {
+		public:
+			explicit guard(const skiplist_map &map) : epoch_domain::guard(map._domain) {}
+		};
+
+		/**
+		 * Constructs an empty container.
+		 * @param comp comparison function object to use for all comparisons of keys
+		 * @param alloc allocator to use for all memory allocations of this container
+		 */
+		skiplist_map(const key_compare &comp = key_compare(), const allocator_type &alloc = allocator_type()) : _alloc(alloc), _byte_alloc(alloc), _comp(comp), _domain(epoch_domain::shared()), _size(0), _seed(0) {
+			for (int i = 0; i < max_level; i++) {
+				_head[i] = nullptr;
+			}
+		}
+
+		/**
+		 * Constructs the container with the contents of the range [first, last).
+		 * @param first the range to copy the elements from
+		 * @param last the range to copy the elements from
+		 * @param comp comparison function object to use for all comparisons of keys
+		 * @param alloc allocator to use for all memory allocations of this container
+		 */
+		template<class InputIt>
+		skiplist_map(InputIt first, InputIt last, const key_compare &comp = key_compare(), const allocator_type &alloc = allocator_type()) : _alloc(alloc), _byte_alloc(alloc), _comp(comp), _domain(epoch_domain::shared()), _size(0), _seed(0) {
+			for (int i = 0; i < max_level; i++) {
+				_head[i] = nullptr;
+			}
+			insert(first, last);
+		}
+
+		/**
+		 * Destructs the map. No thread may use it concurrently anymore.
+		 */
+		~skiplist_map() {
+			_domain.reclaim(this);
+			clear();
+		}
+
+		/**
+		 * Returns the allocator associated with the container.
+		 * @return the associated allocator
+		 */
+		allocator_type get_allocator() const {
+			return _alloc;
+		}
+
+		/**
+		 * Returns an iterator to the first element of the map.
+		 * @return iterator to the first element
+		 */
+		const_iterator begin() const {
+			return const_iterator(live(strip(load(_head[0]))));
+		}
+
+		/**
+		 * Returns an iterator to the element following the last element of the map.
+		 * @return iterator to the element following the last element
+		 */
+		const_iterator end() const {
+			return const_iterator();
+		}
+
+		/**
+		 * Checks if the container has no elements.
+		 * @return true if the container is empty, false otherwise
+		 */
+		bool empty() const {
+			return size() == 0;
+		}
+
+		/**
+		 * Returns the number of elements in the container.
+		 * @return the number of elements in the container
+		 */
+		size_type size() const {
+			return __atomic_load_n(&_size, __ATOMIC_RELAXED);
+		}
+
+		/**
+		 * Returns the maximum number of elements the container is able to hold due to system or library implementation limitations.
+		 * @return maximum number of elements
+		 */
+		size_type max_size() const {
+			return _byte_alloc.max_size() / sizeof(node);
+		}
+
+		/**
+		 * Erases all elements from the container. Not safe against concurrent operations.
+		 */
+		void clear() {
+			node *n = strip(_head[0]);
+
+			while (n) {
+				node *next = strip(n->next[0]);
+
+				destroy(n);
+				n = next;
+			}
+			for (int i = 0; i < max_level; i++) {
+				_head[i] = nullptr;
+			}
+			_size = 0;
+		}
+
+		/**
+		 * Inserts value if the container doesn't already contain an element with an equivalent key.
+		 * @param value element value to insert
+		 * @return Returns a pair consisting of an iterator to the inserted element, or to the element that prevented the insertion, and a bool denoting whether the insertion took place
+		 */
+		ft::pair<iterator, bool> insert(const value_type &value) {
+			epoch_domain::guard guard(_domain);
+			node **preds[max_level];
+			node *succs[max_level];
+			node *n = nullptr;
+			int level = random_level();
+
+			while (true) {
+				if (search(value.first, preds, succs)) {
+					if (n) {
+						destroy(n);
+					}
+					return ft::make_pair(iterator(succs[0]), false);
+				}
+				if (!n) {
+					n = create(value, level);
+				}
+				for (int i = 0; i < level; i++) {
+					n->next[i] = succs[i];
+				}
+				if (__atomic_compare_exchange_n(&preds[0][0], &succs[0], n, false, __ATOMIC_RELEASE, __ATOMIC_RELAXED)) {
+					break;
+				}
+			}
+			__atomic_fetch_add(&_size, 1, __ATOMIC_RELAXED);
+			link_upper_levels(n, preds, succs);
+			if (marked(load(n->next[0]))) {
+				search(value.first, preds, succs);
+			}
+			release(n);
+			return ft::make_pair(iterator(n), true);
+		}
+
+		/**
+		 * Inserts elements from range [first, last).
+		 * @param first range of elements to insert
+		 * @param last range of elements to insert
+		 */
+		template<class InputIt>
+		void insert(InputIt first, InputIt last) {
+			for (; first != last; ++first) {
+				insert(value_type((*first).first, (*first).second));
+			}
+		}
+
+		/**
+		 * Removes the element (if one exists) with the key equivalent to key.
+		 * @param key key value of the elements to remove
+		 * @return Number of elements removed (0 or 1).
+		 */
+		size_type erase(const key_type &key) {
+			epoch_domain::guard guard(_domain);
+			node **preds[max_level];
+			node *succs[max_level];
+			node *n;
+			node *succ;
+
+			if (!search(key, preds, succs)) {
+				return 0;
+			}
+			n = succs[0];
+			for (int i = n->level - 1; i > 0; i--) {
+				succ = load(n->next[i]);
+				while (!marked(succ) && !__atomic_compare_exchange_n(&n->next[i], &succ, mark(succ), false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {}
+			}
+			succ = load(n->next[0]);
+			while (true) {
+				if (marked(succ)) {
+					return 0;
+				}
+				if (__atomic_compare_exchange_n(&n->next[0], &succ, mark(succ), false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+					break;
+				}
+			}
+			__atomic_fetch_sub(&_size, 1, __ATOMIC_RELAXED);
+			search(key, preds, succs);
+			release(n);
+			return 1;
+		}
+
+		/**
+		 * Removes the element at pos.
+		 * @param pos iterator to the element to remove
+		 */
+		void erase(iterator pos) {
+			erase(pos->first);
+		}
+
+		/**
+		 * Returns the number of elements with key that compares equivalent to key, which is either 1 or 0.
+		 * @param key key value of the elements to count
+		 * @return number of elements with key that compares equivalent to key
+		 */
+		size_type count(const key_type &key) const {
+			epoch_domain::guard guard(_domain);
+
+			return find(key) == end() ? 0 : 1;
+		}
+
+		/**
+		 * Finds an element with key equivalent to key.
+		 * @param key key value of the element to search for
+		 * @return iterator to an element with key equivalent to key, or end()
+		 */
+		const_iterator find(const key_type &key) const {
+			epoch_domain::guard guard(_domain);
+			node *n = lower(key);
+
+			if (n && !_comp(key, n->value.first)) {
+				return const_iterator(n);
+			}
+			return end();
+		}
+
+		/**
+		 * Returns an iterator pointing to the first element that is not less than key.
+		 * @param key key value to compare the elements to
+		 * @return iterator pointing to the first element that is not less than key
+		 */
+		const_iterator lower_bound(const key_type &key) const {
+			epoch_domain::guard guard(_domain);
+
+			return const_iterator(lower(key));
+		}
+
+		/**
+		 * Returns an iterator pointing to the first element that is greater than key.
+		 * @param key key value to compare the elements to
+		 * @return iterator pointing to the first element that is greater than key
+		 */
+		const_iterator upper_bound(const key_type &key) const {
+			epoch_domain::guard guard(_domain);
+			const_iterator it(lower(key));
+
+			if (it != end() && !_comp(key, it->first)) {
+				++it;
+			}
+			return it;
+		}
+
+		/**
+		 * Returns a range containing all elements with the given key in the container.
+		 * @param key key value to compare the elements to
+		 * @return ft::pair containing the lower bound and the upper bound of key
+		 */
+		ft::pair<const_iterator, const_iterator> equal_range(const key_type &key) const {
+			return ft::make_pair(lower_bound(key), upper_bound(key));
+		}
+
+		/**
+		 * Returns the function object that compares the keys.
+		 * @return the key comparison function object
+		 */
+		key_compare key_comp() const {
+			return _comp;
+		}
+
+	private:
+		skiplist_map(const skiplist_map &);
+		skiplist_map &operator=(const skiplist_map &);
+
+		static node *load(node *const &link) {
+			return __atomic_load_n(&link, __ATOMIC_ACQUIRE);
+		}
+
+		static bool marked(node *link) {
+			return reinterpret_cast<size_t>(link) & 1;
+		}
+
+		static node *mark(node *link) {
+			return reinterpret_cast<node *>(reinterpret_cast<size_t>(link) | 1);
+		}
+
+		static node *strip(node *link) {
+			return reinterpret_cast<node *>(reinterpret_cast<size_t>(link) & ~static_cast<size_t>(1));
+		}
+
+		/**
+		 * Returns the first element from n on which is not being erased.
+		 */
+		static node *live(node *n) {
+			while (n) {
+				node *next = load(n->next[0]);
+
+				if (!marked(next)) {
+					return n;
+				}
+				n = strip(next);
+			}
+			return nullptr;
+		}
+
+		/**
+		 * Draws a level with a geometric distribution of ratio 1/4.
+		 */
+		int random_level() {
+			size_t x = __atomic_add_fetch(&_seed, 1, __ATOMIC_RELAXED) * static_cast<size_t>(0x9E3779B97F4A7C15UL);
+			int level = 1;
+
+			x ^= x >> 31;
+			x *= static_cast<size_t>(0xBF58476D1CE4E5B9UL);
+			x ^= x >> 29;
+			while ((x & 3) == 0 && level < max_level) {
+				level++;
+				x >>= 2;
+			}
+			return level;
+		}
+
+		/**
+		 * Finds the links preceding key at every level and the elements following them, unlinking on the way the elements being erased.
+		 * @return true if succs[0] has a key equivalent to key
+		 */
+		bool search(const key_type &key, node **preds[], node *succs[]) const {
+		retry:
+			node **pred = _head;
+
+			for (int level = max_level - 1; level >= 0; level--) {
+				node *curr = strip(load(pred[level]));
+
+				while (curr) {
+					node *succ = load(curr->next[level]);
+
+					if (marked(succ)) {
+						if (!__atomic_compare_exchange_n(&pred[level], &curr, strip(succ), false, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED)) {
+							goto retry;
+						}
+						curr = strip(succ);
+					} else if (_comp(curr->value.first, key)) {
+						pred = curr->next;
+						curr = strip(succ);
+					} else {
+						break;
+					}
+				}
+				preds[level] = pred;
+				succs[level] = curr;
+			}
+			return succs[0] && !_comp(key, succs[0]->value.first);
+		}
+
+		/**
+		 * Returns the first element not less than key without unlinking anything.
+		 */
+		node *lower(const key_type &key) const {
+			node *const *pred = _head;
+			node *curr = nullptr;
+
+			for (int level = max_level - 1; level >= 0; level--) {
+				curr = strip(load(pred[level]));
+				while (curr && _comp(curr->value.first, key)) {
+					pred = curr->next;
+					curr = strip(load(pred[level]));
+				}
+			}
+			return live(curr);
+		}
+
+		/**
+		 * Links n above the bottom level, giving up as soon as n is being erased.
+		 */
+		void link_upper_levels(node *n, node **preds[], node *succs[]) {
+			for (int i = 1; i < n->level; i++) {
+				while (true) {
+					node *expected = load(n->next[i]);
+
+					if (marked(expected)) {
+						return;
+					}
+					if (expected != succs[i] && !__atomic_compare_exchange_n(&n->next[i], &expected, succs[i], false, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED)) {
+						return;
+					}
+					if (__atomic_compare_exchange_n(&preds[i][i], &succs[i], n, false, __ATOMIC_RELEASE, __ATOMIC_RELAXED)) {
+						break;
+					}
+					if (!search(n->value.first, preds, succs) || succs[0] != n) {
+						return;
+					}
+				}
+			}
+		}
+
+		node *create(const value_type &value, int level) {
+			char *bytes = _byte_alloc.allocate(bytes_for(level));
+
+			return new (bytes) node(value, level);
+		}
+
+		void destroy(node *n) {
+			size_type size = bytes_for(n->level);
+
+			n->~node();
+			_byte_alloc.deallocate(reinterpret_cast<char *>(n), size);
+		}
+
+		static size_type bytes_for(int level) {
+			return sizeof(node) + (level - 1) * sizeof(node *);
+		}
+
+		/**
+		 * Drops one of the two references of n, held by its insertion and by its erasure, and retires n with the last one.
+		 */
+		void release(node *n) {
+			if (__atomic_sub_fetch(&n->refs, 1, __ATOMIC_ACQ_REL) == 0) {
+				_domain.retire(n, &delete_node, this);
+			}
+		}
+
+		static void delete_node(void *context, void *ptr) {
+			static_cast<skiplist_map *>(context)->destroy(static_cast<node *>(ptr));
+		}
+
+		/**
+		 * Member objects
+		 */
+		allocator_type _alloc;
+		mutable byte_allocator _byte_alloc;
+		key_compare _comp;
+		epoch_domain &_domain;
+		mutable node *_head[max_level];
+		size_type _size;
+		size_t _seed;
+	};
+
+}
+
+#endif //FT_CONTAINERS_SKIPLIST_MAP_HPP
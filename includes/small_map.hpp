@@ -0,0 +1,469 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   small_map.hpp                                      :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: mmosca <mmosca@student.42lyon.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2022/07/23 10:37:12 by mmosca            #+#    #+#             */
+/*   Updated: 2022/07/23 10:37:12 by mmosca           ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef FT_CONTAINERS_SMALL_MAP_HPP
+#define FT_CONTAINERS_SMALL_MAP_HPP
+
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include "type_traits.hpp"
+#include "utility.hpp"
+#include "iterator.hpp"
+#include "map.hpp"
+
+namespace ft {
+
+	/**
+	 * Bidirectional iterator over an ft::small_map: a pointer into the inline array, or an iterator of the map it spilled into.
+	 */
+	template<class Map>
+	class small_map_iterator : public ft::iterator<ft::bidirectional_iterator_tag, typename Map::node_value_type> {
+	public:
+		/**
+		 * Member types
+		 */
+		typedef typename Map::node_value_type value_type;
+		typedef typename Map::map_type::iterator map_iterator;
+		typedef typename ft::iterator<ft::bidirectional_iterator_tag, value_type>::iterator_category iterator_category;
+		typedef typename ft::iterator<ft::bidirectional_iterator_tag, value_type>::difference_type difference_type;
+		typedef typename ft::iterator<ft::bidirectional_iterator_tag, value_type>::pointer pointer;
+		typedef typename ft::iterator<ft::bidirectional_iterator_tag, value_type>::reference reference;
+
+		/**
+		 * Member objects
+		 */
+		pointer _slot;
+		map_iterator _it;
+
+		small_map_iterator() : _slot(nullptr), _it() {}
+
+		explicit small_map_iterator(pointer slot) : _slot(slot), _it() {}
+
+		explicit small_map_iterator(map_iterator it) : _slot(nullptr), _it(it) {}
+
+		reference operator*() const {
+			return _slot ? *_slot : *_it;
+		}
+
+		pointer operator->() const {
+			return base();
+		}
+
+		pointer base() const {
+			return _slot ? _slot : _it.base();
+		}
+
+		small_map_iterator &operator++() {
+			if (_slot) {
+				++_slot;
+			} else {
+				++_it;
+			}
+			return *this;
+		}
+
+		small_map_iterator operator++(int) {
+			small_map_iterator tmp(*this);
+			++*this;
+			return tmp;
+		}
+
+		small_map_iterator &operator--() {
+			if (_slot) {
+				--_slot;
+			} else {
+				--_it;
+			}
+			return *this;
+		}
+
+		small_map_iterator operator--(int) {
+			small_map_iterator tmp(*this);
+			--*this;
+			return tmp;
+		}
+
+		friend bool operator==(const small_map_iterator &lhs, const small_map_iterator &rhs) {
+			return lhs._slot == rhs._slot && lhs._it == rhs._it;
+		}
+
+		friend bool operator!=(const small_map_iterator &lhs, const small_map_iterator &rhs) {
+			return !(lhs == rhs);
+		}
+	};
+
+	/**
+	 * ft::small_map is a sorted associative container keeping up to N elements inline, in a sorted array searched linearly, without any heap allocation.
+	 * Inserting past N elements moves them all into an ft::map, where the container stays until it is cleared. Iterators are invalidated by insertions and erasures while inline, and by the spill.
+	 * The spilled elements are ordered by the tree of ft::map, which uses operator< on the keys whatever its Compare: so that the order of iteration and the bounds stay the same across the spill, Compare can only be std::less<Key>.
+	 * @tparam Key the type of the keys
+	 * @tparam T the type of the mapped values
+	 * @tparam N the number of elements kept inline
+	 * @tparam Compare std::less<Key>, the order of the tree of ft::map
+	 * @tparam Allocator an allocator that is used to construct/destroy the inline elements and for the spilled map
+	 */
+	template<class Key, class T, size_t N, class Compare = std::less<Key>, class Allocator = std::allocator<ft::pair<const Key, T> >, class = typename ft::enable_if<ft::is_same<Compare, std::less<Key> >::value>::type>
+	class small_map {
+	public:
+		/**
+		 * Member types
+		 */
+		typedef Key key_type;
+		typedef T mapped_type;
+		typedef ft::pair<const Key, T> value_type;
+		typedef ft::pair<Key, T> node_value_type;
+		typedef size_t size_type;
+		typedef ptrdiff_t difference_type;
+		typedef Compare key_compare;
+		typedef Allocator allocator_type;
+		typedef ft::map<Key, T, Compare, Allocator> map_type;
+		typedef ft::small_map_iterator<small_map> iterator;
+		typedef iterator const_iterator;
+		typedef typename ft::reverse_iterator<iterator> reverse_iterator;
+		typedef typename ft::reverse_iterator<const_iterator> const_reverse_iterator;
+
+		/**
+		 * Constructs an empty container.
+		 * @param comp comparison function object to use for all comparisons of keys
+		 * @param alloc allocator to use for all memory allocations of this container
+		 */
+		explicit small_map(const key_compare &comp = key_compare(), const allocator_type &alloc = allocator_type()) : _alloc(alloc), _comp(comp), _size(0), _spilled(false), _map(comp, alloc) {}
+
+		/**
+		 * Copy constructor. Constructs the container with the copy of the contents of other.
+		 * @param other another container to be used as source to initialize the elements of the container with
+		 */
+		small_map(const small_map &other) : _alloc(other._alloc), _comp(other._comp), _size(0), _spilled(false), _map(other._comp) {
+			*this = other;
+		}
+
+		/**
+		 * Destructs the small_map.
+		 */
+		~small_map() {
+			clear();
+		}
+
+		/**
+		 * Copy assignment operator. Replaces the contents with a copy of the contents of other.
+		 * @param other another container to use as data source
+		 * @return *this
+		 */
+		small_map &operator=(const small_map &other) {
+			if (this != &other) {
+				clear();
+				if (other._spilled) {
+					_map = other._map;
+					_spilled = true;
+				} else {
+					for (; _size < other._size; _size++) {
+						_alloc.construct(slots() + _size, other.slots()[_size]);
+					}
+				}
+			}
+			return *this;
+		}
+
+		/**
+		 * Returns the allocator associated with the container.
+		 * @return the associated allocator
+		 */
+		allocator_type get_allocator() const {
+			return allocator_type(_alloc);
+		}
+
+		/**
+		 * Returns a reference to the value that is mapped to a key equivalent to key, performing an insertion if such key does not already exist.
+		 * @param key the key of the element to find
+		 * @return reference to the mapped value of the new element if no element with key key existed
+		 */
+		mapped_type &operator[](const key_type &key) {
+			return insert(ft::make_pair(key, mapped_type())).first->second;
+		}
+
+		/**
+		 * Returns a reference to the mapped value of the element with key equivalent to key.
+		 * @param key the key of the element to find
+		 * @return reference to the mapped value of the requested element
+		 */
+		mapped_type &at(const key_type &key) const {
+			iterator it = find(key);
+
+			if (it == end()) {
+				throw std::out_of_range("ft::small_map::at: key not found");
+			}
+			return it->second;
+		}
+
+		iterator begin() const {
+			return _spilled ? iterator(const_cast<map_type &>(_map).begin()) : iterator(slots());
+		}
+
+		iterator end() const {
+			return _spilled ? iterator(const_cast<map_type &>(_map).end()) : iterator(slots() + _size);
+		}
+
+		reverse_iterator rbegin() const {
+			return reverse_iterator(end());
+		}
+
+		reverse_iterator rend() const {
+			return reverse_iterator(begin());
+		}
+
+		bool empty() const {
+			return size() == 0;
+		}
+
+		size_type size() const {
+			return _spilled ? _map.size() : _size;
+		}
+
+		size_type max_size() const {
+			return _map.max_size();
+		}
+
+		/**
+		 * Checks if the elements are kept inline.
+		 * @return true until the container spills into its ft::map
+		 */
+		bool is_inline() const {
+			return !_spilled;
+		}
+
+		/**
+		 * Erases all elements from the container, which keeps them inline again.
+		 */
+		void clear() {
+			destroy_inline();
+			_map.clear();
+			_spilled = false;
+		}
+
+		/**
+		 * Inserts value if the container doesn't already contain an element with an equivalent key.
+		 * @param value element value to insert
+		 * @return Returns a pair consisting of an iterator to the inserted element and a bool denoting whether the insertion took place
+		 */
+		ft::pair<iterator, bool> insert(const value_type &value) {
+			size_type index;
+
+			if (_spilled) {
+				ft::pair<typename map_type::iterator, bool> result = _map.insert(value);
+
+				return ft::make_pair(iterator(result.first), result.second);
+			}
+			index = position(value.first);
+			if (index < _size && !_comp(value.first, slots()[index].first)) {
+				return ft::make_pair(iterator(slots() + index), false);
+			}
+			if (_size == N) {
+				spill();
+				return insert(value);
+			}
+			open(index);
+			_alloc.construct(slots() + index, node_value_type(value.first, value.second));
+			_size++;
+			return ft::make_pair(iterator(slots() + index), true);
+		}
+
+		/**
+		 * Inserts elements from range [first, last).
+		 * @param first range of elements to insert
+		 * @param last range of elements to insert
+		 */
+		template<class InputIt>
+		void insert(InputIt first, InputIt last) {
+			for (; first != last; ++first) {
+				insert(value_type((*first).first, (*first).second));
+			}
+		}
+
+		/**
+		 * Removes the element at pos.
+		 * @param pos iterator to the element to remove
+		 */
+		void erase(iterator pos) {
+			erase(pos->first);
+		}
+
+		/**
+		 * Removes the element (if one exists) with the key equivalent to key.
+		 * @param key key value of the elements to remove
+		 * @return Number of elements removed (0 or 1).
+		 */
+		size_type erase(const key_type &key) {
+			size_type index;
+
+			if (_spilled) {
+				return _map.erase(key);
+			}
+			index = position(key);
+			if (index == _size || _comp(key, slots()[index].first)) {
+				return 0;
+			}
+			for (_size--; index < _size; index++) {
+				slots()[index] = slots()[index + 1];
+			}
+			_alloc.destroy(slots() + _size);
+			return 1;
+		}
+
+		/**
+		 * Exchanges the contents of the container with those of other: the inline elements one by one, at most N, and the spilled maps in O(1).
+		 * @param other container to exchange the contents with
+		 */
+		void swap(small_map &other) {
+			small_map *shorter = _size < other._size ? this : &other;
+			small_map *longer = shorter == this ? &other : this;
+			size_type i = 0;
+
+			for (; i < shorter->_size; i++) {
+				ft::swap(slots()[i], other.slots()[i]);
+			}
+			for (; i < longer->_size; i++) {
+				shorter->_alloc.construct(shorter->slots() + i, longer->slots()[i]);
+				longer->_alloc.destroy(longer->slots() + i);
+			}
+			ft::swap(_size, other._size);
+			ft::swap(_spilled, other._spilled);
+			ft::swap(_comp, other._comp);
+			_map.swap(other._map);
+		}
+
+		size_type count(const key_type &key) const {
+			return find(key) == end() ? 0 : 1;
+		}
+
+		/**
+		 * Finds an element with key equivalent to key.
+		 * @param key key value of the element to search for
+		 * @return iterator to an element with key equivalent to key, or end()
+		 */
+		iterator find(const key_type &key) const {
+			size_type index;
+
+			if (_spilled) {
+				return iterator(const_cast<map_type &>(_map).find(key));
+			}
+			index = position(key);
+			if (index == _size || _comp(key, slots()[index].first)) {
+				return end();
+			}
+			return iterator(slots() + index);
+		}
+
+		/**
+		 * Returns an iterator pointing to the first element that is not less than key.
+		 * @param key key value to compare the elements to
+		 * @return iterator pointing to the first element that is not less than key
+		 */
+		iterator lower_bound(const key_type &key) const {
+			if (_spilled) {
+				return iterator(const_cast<map_type &>(_map).lower_bound(key));
+			}
+			return iterator(slots() + position(key));
+		}
+
+		/**
+		 * Returns an iterator pointing to the first element that is greater than key.
+		 * @param key key value to compare the elements to
+		 * @return iterator pointing to the first element that is greater than key
+		 */
+		iterator upper_bound(const key_type &key) const {
+			iterator it = lower_bound(key);
+
+			return (it != end() && !_comp(key, it->first)) ? ++it : it;
+		}
+
+		ft::pair<iterator, iterator> equal_range(const key_type &key) const {
+			return ft::make_pair(lower_bound(key), upper_bound(key));
+		}
+
+		key_compare key_comp() const {
+			return _comp;
+		}
+
+	private:
+		typedef typename Allocator::template rebind<node_value_type>::other slot_allocator;
+
+		/**
+		 * Raw inline storage, aligned for the usual scalar types.
+		 */
+		union storage {
+			char bytes[N * sizeof(node_value_type)];
+			long double align_float;
+			long long align_integer;
+			void *align_pointer;
+		};
+
+		node_value_type *slots() const {
+			return reinterpret_cast<node_value_type *>(const_cast<char *>(_storage.bytes));
+		}
+
+		/**
+		 * Returns the index of the first inline element not less than key. A linear search: at these sizes it beats a binary search, its branches being predictable.
+		 */
+		size_type position(const key_type &key) const {
+			size_type index = 0;
+
+			while (index < _size && _comp(slots()[index].first, key)) {
+				index++;
+			}
+			return index;
+		}
+
+		/**
+		 * Shifts the inline elements from index one slot to the right.
+		 */
+		void open(size_type index) {
+			if (index == _size) {
+				return;
+			}
+			_alloc.construct(slots() + _size, slots()[_size - 1]);
+			for (size_type i = _size - 1; i > index; i--) {
+				slots()[i] = slots()[i - 1];
+			}
+		}
+
+		/**
+		 * Moves the inline elements into the map.
+		 */
+		void spill() {
+			for (size_type i = 0; i < _size; i++) {
+				_map.insert(slots()[i]);
+			}
+			destroy_inline();
+			_spilled = true;
+		}
+
+		void destroy_inline() {
+			for (; _size > 0; _size--) {
+				_alloc.destroy(slots() + _size - 1);
+			}
+		}
+
+		/**
+		 * Member objects
+		 */
+		slot_allocator _alloc;
+		key_compare _comp;
+		storage _storage;
+		size_type _size;
+		bool _spilled;
+		map_type _map;
+	};
+
+}
+
+#endif //FT_CONTAINERS_SMALL_MAP_HPP
@@ -10,6 +10,20 @@
 # include "../includes/vector.hpp"
 # include "../includes/map.hpp"
 # include "../includes/stack.hpp"
+# include "../includes/concurrent_map.hpp"
+# include "../includes/skiplist_map.hpp"
+# include "../includes/unordered_map.hpp"
+# include "../includes/frozen_map.hpp"
+# include "../includes/map_rebuild.hpp"
+# include "../includes/aggregate_map.hpp"
+# include "../includes/interval_map.hpp"
+# include "../includes/small_map.hpp"
+# include "../includes/int_map.hpp"
+# include "../includes/radix_map.hpp"
+# include "../includes/map_filter.hpp"
+# include "../includes/map_diff.hpp"
+# include "../includes/map_snapshot.hpp"
+# include "../includes/mmap_map.hpp"
 
 # ifdef __linux__
 #  define RESET "\e[0m"
@@ -31,6 +45,20 @@
 void	test_vector(void);
 void	test_map(void);
 void	test_stack(void);
+void	test_concurrent_map(void);
+void	test_skiplist_map(void);
+void	test_unordered_map(void);
+void	test_frozen_map(void);
+void	test_aggregate_map(void);
+void	test_interval_map(void);
+void	test_small_map(void);
+void	test_int_map(void);
+void	test_radix_map(void);
+void	test_map_filter(void);
+void	test_map_diff(void);
+void	test_algorithm(void);
+void	test_map_snapshot(void);
+void	test_mmap_map(void);
 
 inline void print_header(std::string str)
 {
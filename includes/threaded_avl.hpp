@@ -0,0 +1,541 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   threaded_avl.hpp                                   :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: mmosca <mmosca@student.42lyon.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2022/07/18 09:41:12 by mmosca            #+#    #+#             */
+/*   Updated: 2022/07/18 09:41:12 by mmosca           ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef FT_CONTAINERS_THREADED_AVL_HPP
+#define FT_CONTAINERS_THREADED_AVL_HPP
+
+#include <memory>
+#include <algorithm>
+#include "iterator.hpp"
+#include "utility.hpp"
+
+namespace ft {
+
+	/**
+	 * Links of a threaded tree node. A missing child is replaced by a thread to the in-order predecessor (left) or successor (right), flagged by left_thread/right_thread.
+	 * The tree header is a bare ThreadedNodeBase: the whole tree is its left subtree and its right thread points to the leftmost node, so it is both end() and the target of the threads leaving the tree.
+	 */
+	class ThreadedNodeBase {
+	public:
+		/**
+		 * Member objects
+		 */
+		ThreadedNodeBase *left;
+		ThreadedNodeBase *right;
+		int height;
+		bool left_thread;
+		bool right_thread;
+
+		ThreadedNodeBase() : left(this), right(this), height(0), left_thread(true), right_thread(true) {}
+
+		/**
+		 * Returns the in-order successor, without ever climbing.
+		 * @return the next node, or the header after the last node
+		 */
+		ThreadedNodeBase *next() const {
+			ThreadedNodeBase *node = right;
+
+			if (!right_thread) {
+				while (!node->left_thread) {
+					node = node->left;
+				}
+			}
+			return node;
+		}
+
+		/**
+		 * Returns the in-order predecessor, without ever climbing.
+		 * @return the previous node, or the last node from the header
+		 */
+		ThreadedNodeBase *prev() const {
+			ThreadedNodeBase *node = left;
+
+			if (!left_thread) {
+				while (!node->right_thread) {
+					node = node->right;
+				}
+			}
+			return node;
+		}
+	};
+
+	template<typename U, typename V>
+	class ThreadedNode : public ThreadedNodeBase {
+	public:
+		/**
+		 * Member types
+		 */
+		typedef ft::pair<U, V> value_type;
+
+		/**
+		 * Member objects
+		 */
+		value_type value;
+
+		/**
+		 * Constructor initialized value with value.
+		 * @param value value to initialized
+		 */
+		ThreadedNode(const value_type &value) : ThreadedNodeBase(), value(value) {
+			height = 1;
+		}
+	};
+
+	/**
+	 * Bidirectional iterator over a threaded_avl_tree, a single node pointer stepping through the threads.
+	 */
+	template<typename T>
+	class threaded_iterator : public ft::iterator<ft::bidirectional_iterator_tag, T> {
+	public:
+		/**
+		 * Member types
+		 */
+		typedef typename T::value_type value_type;
+		typedef typename ft::iterator<ft::bidirectional_iterator_tag, value_type>::iterator_category iterator_category;
+		typedef typename ft::iterator<ft::bidirectional_iterator_tag, value_type>::difference_type difference_type;
+		typedef typename ft::iterator<ft::bidirectional_iterator_tag, value_type>::pointer pointer;
+		typedef typename ft::iterator<ft::bidirectional_iterator_tag, value_type>::reference reference;
+
+		/**
+		 * Member objects
+		 */
+		ThreadedNodeBase *_node;
+
+		threaded_iterator() : _node(nullptr) {}
+
+		explicit threaded_iterator(ThreadedNodeBase *node) : _node(node) {}
+
+		template<typename U>
+		threaded_iterator(const ft::threaded_iterator<U> &other) : _node(other._node) {}
+
+		reference operator*() const {
+			return static_cast<T *>(_node)->value;
+		}
+
+		pointer operator->() const {
+			return &static_cast<T *>(_node)->value;
+		}
+
+		/**
+		 * Returns a pointer to the element, as avl_iterator::base does for ft::reverse_iterator.
+		 */
+		pointer base() const {
+			return &static_cast<T *>(_node)->value;
+		}
+
+		threaded_iterator &operator++() {
+			_node = _node->next();
+			return *this;
+		}
+
+		threaded_iterator operator++(int) {
+			threaded_iterator tmp(*this);
+			_node = _node->next();
+			return tmp;
+		}
+
+		threaded_iterator &operator--() {
+			_node = _node->prev();
+			return *this;
+		}
+
+		threaded_iterator operator--(int) {
+			threaded_iterator tmp(*this);
+			_node = _node->prev();
+			return tmp;
+		}
+	};
+
+	template<typename U, typename V>
+	bool operator==(const ft::threaded_iterator<U> &lhs, const ft::threaded_iterator<V> &rhs) {
+		return lhs._node == rhs._node;
+	}
+
+	template<typename U, typename V>
+	bool operator!=(const ft::threaded_iterator<U> &lhs, const ft::threaded_iterator<V> &rhs) {
+		return lhs._node != rhs._node;
+	}
+
+	/**
+	 * AVL tree whose leaves thread to their in-order neighbours, so that iterating never climbs: a step follows one thread, or descends the left spine of a right subtree.
+	 * It exposes the interface of ft::avl_tree and can be given to ft::map as its Tree.
+	 * @tparam U the type of the keys
+	 * @tparam V the type of the mapped values
+	 */
+	template<typename U, typename V, class Node = ThreadedNode<U, V>, class Allocator = std::allocator<Node> >
+	class threaded_avl_tree {
+	public:
+		/**
+		 * Member types
+		 */
+		typedef ft::pair<U, V> value_type;
+		typedef Node node_type;
+		typedef Node* node_pointer;
+		typedef ThreadedNodeBase* base_pointer;
+		typedef Allocator node_allocator;
+		typedef typename ft::threaded_iterator<Node> iterator;
+		typedef typename ft::threaded_iterator<Node> const_iterator;
+		typedef typename node_allocator::size_type size_type;
+
+		/**
+		 * Constructor with allocator in parameter.
+		 * @param node_alloc allocator to set
+		 */
+		threaded_avl_tree(const node_allocator &node_alloc = node_allocator()) : _header(), _alloc(node_alloc), _size(0) {}
+
+		/**
+		 * Destructor.
+		 */
+		~threaded_avl_tree() {
+			clear_tree();
+		}
+
+		void clear_tree() {
+			clear_tree(root());
+			_size = 0;
+			reset_header();
+		}
+
+		void insert(value_type value) {
+			set_root(insert(value, root(), &_header, &_header));
+		}
+
+		void remove(value_type value) {
+			set_root(remove(value, root(), &_header, &_header));
+		}
+
+		bool isEmpty() const {
+			return _size == 0;
+		}
+
+		size_type getSize() const {
+			return _size;
+		}
+
+		size_type getMaxSize() const {
+			return _alloc.max_size();
+		}
+
+		node_pointer find(value_type value) const {
+			base_pointer node = root();
+
+			while (node) {
+				node_pointer current = static_cast<node_pointer>(node);
+
+				if (current->value.first == value.first) {
+					return current;
+				}
+				node = (current->value.first < value.first) ? right_child(node) : left_child(node);
+			}
+			return nullptr;
+		}
+
+		/**
+		 * Looks up every key of [first, last) and writes the node holding it, or nullptr, to out, interleaving the descents like avl_tree::find_many.
+		 * @param first the range of keys to look up, traversed once
+		 * @param last the range of keys to look up
+		 * @param out the destination of the nodes, in the order of the keys
+		 * @return out past the last node written
+		 */
+		template<class ForwardIt, class OutputIt>
+		OutputIt find_many(ForwardIt first, ForwardIt last, OutputIt out) const {
+			ForwardIt keys[batch_width];
+			base_pointer nodes[batch_width];
+
+			while (first != last) {
+				size_t count = 0;
+
+				for (; count < batch_width && first != last; ++count, ++first) {
+					keys[count] = first;
+					nodes[count] = root();
+				}
+				for (bool moved = true; moved; ) {
+					moved = false;
+					for (size_t i = 0; i < count; i++) {
+						base_pointer node = nodes[i];
+
+						if (node == nullptr || static_cast<node_pointer>(node)->value.first == *keys[i]) {
+							continue;
+						}
+						node = (static_cast<node_pointer>(node)->value.first < *keys[i]) ? right_child(node) : left_child(node);
+						if (node) {
+							__builtin_prefetch(node);
+							moved = true;
+						}
+						nodes[i] = node;
+					}
+				}
+				for (size_t i = 0; i < count; i++) {
+					*out++ = static_cast<node_pointer>(nodes[i]);
+				}
+			}
+			return out;
+		}
+
+		node_pointer getRoot() const {
+			return static_cast<node_pointer>(root());
+		}
+
+		iterator begin() const {
+			return iterator(_header.right);
+		}
+
+		iterator end() const {
+			return iterator(const_cast<base_pointer>(&_header));
+		}
+
+		/**
+		 * Returns an iterator to node, or end() for nullptr.
+		 */
+		iterator make_iterator(node_pointer node) const {
+			return node ? iterator(node) : end();
+		}
+
+		/**
+		 * Returns an iterator to the node holding the key of value, or end().
+		 */
+		iterator find_iterator(const value_type &value) const {
+			return make_iterator(find(value));
+		}
+
+		void swap(threaded_avl_tree &t) {
+			std::swap(_header, t._header);
+			std::swap(_alloc, t._alloc);
+			std::swap(_size, t._size);
+			relink_header();
+			t.relink_header();
+		}
+
+	private:
+		/**
+		 * Number of descents find_many interleaves.
+		 */
+		static const size_t batch_width = 16;
+
+		base_pointer root() const {
+			return _header.left_thread ? nullptr : _header.left;
+		}
+
+		static base_pointer left_child(base_pointer node) {
+			return node->left_thread ? nullptr : node->left;
+		}
+
+		static base_pointer right_child(base_pointer node) {
+			return node->right_thread ? nullptr : node->right;
+		}
+
+		static void set_left(base_pointer node, base_pointer child, base_pointer thread) {
+			node->left_thread = child == nullptr;
+			node->left = child ? child : thread;
+		}
+
+		static void set_right(base_pointer node, base_pointer child, base_pointer thread) {
+			node->right_thread = child == nullptr;
+			node->right = child ? child : thread;
+		}
+
+		/**
+		 * Hangs root under the header and points the header back to the leftmost node.
+		 */
+		void set_root(base_pointer root) {
+			set_left(&_header, root, &_header);
+			_header.right = root ? leftmost(root) : &_header;
+		}
+
+		/**
+		 * Points the header and the outer threads of the tree back to the header, after the header moved.
+		 */
+		void relink_header() {
+			base_pointer node = root();
+
+			if (node == nullptr) {
+				reset_header();
+				return;
+			}
+			_header.right = leftmost(node);
+			_header.right->left = &_header;
+			while (!node->right_thread) {
+				node = node->right;
+			}
+			node->right = &_header;
+		}
+
+		void reset_header() {
+			_header.left = &_header;
+			_header.right = &_header;
+			_header.left_thread = true;
+			_header.right_thread = true;
+		}
+
+		static base_pointer leftmost(base_pointer node) {
+			while (!node->left_thread) {
+				node = node->left;
+			}
+			return node;
+		}
+
+		static int height(base_pointer child, bool thread) {
+			return thread ? 0 : child->height;
+		}
+
+		static void updateHeight(base_pointer node) {
+			node->height = 1 + std::max(height(node->left, node->left_thread), height(node->right, node->right_thread));
+		}
+
+		static long balance(base_pointer node) {
+			return height(node->left, node->left_thread) - height(node->right, node->right_thread);
+		}
+
+		/**
+		 * Inserts value in the subtree node, nullptr standing for the empty spot between pred and succ, which the threads of a new leaf point to.
+		 */
+		base_pointer insert(const value_type &value, base_pointer node, base_pointer pred, base_pointer succ) {
+			if (node == nullptr) {
+				node_pointer newNode = _alloc.allocate(1);
+				_alloc.construct(newNode, node_type(value));
+				newNode->left = pred;
+				newNode->right = succ;
+				_size++;
+				return newNode;
+			}
+			node_pointer current = static_cast<node_pointer>(node);
+			if (current->value.first == value.first) {
+				return node;
+			}
+			if (current->value.first < value.first) {
+				set_right(node, insert(value, right_child(node), node, succ), succ);
+			} else {
+				set_left(node, insert(value, left_child(node), pred, node), pred);
+			}
+			updateHeight(node);
+			return applyRotation(node);
+		}
+
+		base_pointer applyRotation(base_pointer node) {
+			long nodeBalance = balance(node);
+
+			if (nodeBalance < -1) {
+				if (balance(node->right) > 0) {
+					node->right = rightRotation(node->right);
+				}
+				return leftRotation(node);
+			} else if (nodeBalance > 1) {
+				if (balance(node->left) < 0) {
+					node->left = leftRotation(node->left);
+				}
+				return rightRotation(node);
+			}
+			return node;
+		}
+
+		/**
+		 * Rotations keep the in-order sequence, only a thread moving across the rotated edge changes: when right had no left child, node now lacks a right child and threads to right.
+		 */
+		base_pointer leftRotation(base_pointer node) {
+			base_pointer right = node->right;
+
+			if (right->left_thread) {
+				node->right = right;
+				node->right_thread = true;
+			} else {
+				node->right = right->left;
+			}
+			right->left = node;
+			right->left_thread = false;
+			updateHeight(node);
+			updateHeight(right);
+			return right;
+		}
+
+		base_pointer rightRotation(base_pointer node) {
+			base_pointer left = node->left;
+
+			if (left->right_thread) {
+				node->left = left;
+				node->left_thread = true;
+			} else {
+				node->left = left->right;
+			}
+			left->right = node;
+			left->right_thread = false;
+			updateHeight(node);
+			updateHeight(left);
+			return left;
+		}
+
+		/**
+		 * Removes value from the subtree node, whose outer threads point to pred and succ. A removed node with a single subtree hands its outer thread over to the nearest node of that subtree.
+		 */
+		base_pointer remove(const value_type &value, base_pointer node, base_pointer pred, base_pointer succ) {
+			if (node == nullptr) {
+				return nullptr;
+			}
+			node_pointer current = static_cast<node_pointer>(node);
+			if (current->value.first == value.first) {
+				if (!node->left_thread && !node->right_thread) {
+					base_pointer max = node->left;
+
+					while (!max->right_thread) {
+						max = max->right;
+					}
+					current->value = static_cast<node_pointer>(max)->value;
+					set_left(node, remove(current->value, node->left, pred, node), pred);
+				} else {
+					base_pointer child = nullptr;
+
+					if (!node->right_thread) {
+						child = node->right;
+						leftmost(child)->left = node->left;
+					} else if (!node->left_thread) {
+						base_pointer max = node->left;
+
+						while (!max->right_thread) {
+							max = max->right;
+						}
+						max->right = node->right;
+						child = node->left;
+					}
+					_alloc.destroy(current);
+					_alloc.deallocate(current, 1);
+					_size--;
+					return child;
+				}
+			} else if (current->value.first < value.first) {
+				set_right(node, remove(value, right_child(node), node, succ), succ);
+			} else {
+				set_left(node, remove(value, left_child(node), pred, node), pred);
+			}
+			updateHeight(node);
+			return applyRotation(node);
+		}
+
+		void clear_tree(base_pointer node) {
+			if (node == nullptr) {
+				return;
+			}
+			clear_tree(left_child(node));
+			clear_tree(right_child(node));
+			_alloc.destroy(static_cast<node_pointer>(node));
+			_alloc.deallocate(static_cast<node_pointer>(node), 1);
+		}
+
+		/**
+		 * Member objects
+		 */
+		ThreadedNodeBase _header;
+		node_allocator _alloc;
+		size_t _size;
+	};
+
+}
+
+#endif //FT_CONTAINERS_THREADED_AVL_HPP
@@ -72,6 +72,19 @@ namespace ft {
 	template<class T>
 	struct is_integral : public is_integral_type<T> {};
 
+	/**
+	 * Checks whether T and U name the same type.
+	 */
+	template<class T, class U>
+	struct is_same {
+		static const bool value = false;
+	};
+
+	template<class T>
+	struct is_same<T, T> {
+		static const bool value = true;
+	};
+
 }
 
 #endif //FT_CONTAINERS_TYPE_TRAITS_HPP
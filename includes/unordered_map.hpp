@@ -0,0 +1,867 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   unordered_map.hpp                                  :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: mmosca <mmosca@student.42lyon.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2022/07/16 14:35:48 by mmosca            #+#    #+#             */
+/*   Updated: 2022/07/16 14:35:48 by mmosca           ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef FT_CONTAINERS_UNORDERED_MAP_HPP
+#define FT_CONTAINERS_UNORDERED_MAP_HPP
+
+#include <functional>
+#include <memory>
+#include <cstring>
+#include <stdexcept>
+#include "utility.hpp"
+#include "iterator.hpp"
+#include "functional.hpp"
+
+#ifdef __SSE2__
+# include <emmintrin.h>
+#endif
+
+namespace ft {
+
+	/**
+	 * ft::hash_group is a group of control bytes of an ft::unordered_map, probed all at once: 16 bytes with SSE2, 8 bytes in a word otherwise.
+	 * A control byte is empty, deleted, the sentinel ending the table, or the 7 low bits of the hash of a full slot.
+	 */
+	class hash_group {
+	public:
+		/**
+		 * Member types
+		 */
+		typedef signed char ctrl_type;
+
+		/**
+		 * Member constants
+		 */
+		enum {
+			empty = -128,
+			deleted = -2,
+			sentinel = -1
+		};
+
+#ifdef __SSE2__
+		typedef unsigned int mask_type;
+
+		static const size_t width = 16;
+
+		explicit hash_group(const ctrl_type *pos) : _ctrl(_mm_loadu_si128(reinterpret_cast<const __m128i *>(pos))) {}
+
+		/**
+		 * Returns the slots of the group whose control byte is h2.
+		 */
+		mask_type match(ctrl_type h2) const {
+			return _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), _ctrl));
+		}
+
+		mask_type match_empty() const {
+			return _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(static_cast<char>(empty)), _ctrl));
+		}
+
+		mask_type match_empty_or_deleted() const {
+			return _mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(static_cast<char>(sentinel)), _ctrl));
+		}
+
+		/**
+		 * Returns the position of the lowest slot of a non-empty mask.
+		 */
+		static size_t lowest(mask_type mask) {
+			return __builtin_ctz(mask);
+		}
+
+	private:
+		__m128i _ctrl;
+#else
+		typedef unsigned long long mask_type;
+
+		static const size_t width = 8;
+
+		explicit hash_group(const ctrl_type *pos) {
+			std::memcpy(&_ctrl, pos, sizeof(_ctrl));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+			_ctrl = __builtin_bswap64(_ctrl);
+#endif
+		}
+
+		/**
+		 * Returns the slots of the group whose control byte is h2, with rare false positives on full slots.
+		 */
+		mask_type match(ctrl_type h2) const {
+			mask_type x = _ctrl ^ (lsbs * static_cast<unsigned char>(h2));
+
+			return (x - lsbs) & ~x & msbs;
+		}
+
+		mask_type match_empty() const {
+			return _ctrl & (~_ctrl << 6) & msbs;
+		}
+
+		mask_type match_empty_or_deleted() const {
+			return _ctrl & (~_ctrl << 7) & msbs;
+		}
+
+		/**
+		 * Returns the position of the lowest slot of a non-empty mask.
+		 */
+		static size_t lowest(mask_type mask) {
+			return __builtin_ctzll(mask) >> 3;
+		}
+
+	private:
+		static const mask_type lsbs = 0x0101010101010101ULL;
+		static const mask_type msbs = 0x8080808080808080ULL;
+
+		mask_type _ctrl;
+#endif
+	};
+
+	/**
+	 * Forward iterator over the full slots of an ft::unordered_map, the sentinel control byte ends the walk.
+	 */
+	template<typename T>
+	class hash_iterator : public ft::iterator<ft::forward_iterator_tag, T> {
+	public:
+		/**
+		 * Member types
+		 */
+		typedef typename ft::iterator<ft::forward_iterator_tag, T>::pointer pointer;
+		typedef typename ft::iterator<ft::forward_iterator_tag, T>::reference reference;
+		typedef hash_group::ctrl_type ctrl_type;
+
+		/**
+		 * Member objects
+		 */
+		const ctrl_type *_ctrl;
+		T *_slot;
+
+		hash_iterator() : _ctrl(nullptr), _slot(nullptr) {}
+
+		hash_iterator(const ctrl_type *ctrl, T *slot) : _ctrl(ctrl), _slot(slot) {}
+
+		template<typename U>
+		hash_iterator(const hash_iterator<U> &other) : _ctrl(other._ctrl), _slot(other._slot) {}
+
+		reference operator*() const {
+			return *_slot;
+		}
+
+		pointer operator->() const {
+			return _slot;
+		}
+
+		hash_iterator &operator++() {
+			++_ctrl;
+			++_slot;
+			skip();
+			return *this;
+		}
+
+		hash_iterator operator++(int) {
+			hash_iterator tmp(*this);
+			++*this;
+			return tmp;
+		}
+
+		/**
+		 * Moves forward to the next full slot or to the sentinel.
+		 */
+		void skip() {
+			while (*_ctrl < hash_group::sentinel) {
+				++_ctrl;
+				++_slot;
+			}
+		}
+	};
+
+	template<typename U, typename V>
+	bool operator==(const hash_iterator<U> &lhs, const hash_iterator<V> &rhs) {
+		return lhs._ctrl == rhs._ctrl;
+	}
+
+	template<typename U, typename V>
+	bool operator!=(const hash_iterator<U> &lhs, const hash_iterator<V> &rhs) {
+		return lhs._ctrl != rhs._ctrl;
+	}
+
+	/**
+	 * ft::unordered_map is an associative container using open addressing: the elements are stored in one flat array of slots, next to an array of control bytes probed one group at a time.
+	 * @tparam Key the type of the keys
+	 * @tparam T the type of the mapped values
+	 * @tparam Hash function object hashing the keys
+	 * @tparam KeyEqual function object comparing the keys for equality
+	 * @tparam Allocator an allocator that is used to acquire/release memory and to construct/destroy the elements in that memory
+	 */
+	template<class Key, class T, class Hash = ft::hash<Key>, class KeyEqual = std::equal_to<Key>, class Allocator = std::allocator<ft::pair<const Key, T> > >
+	class unordered_map {
+	public:
+		/**
+		 * Member types
+		 */
+		typedef Key key_type;
+		typedef T mapped_type;
+		typedef ft::pair<const Key, T> value_type;
+		typedef size_t size_type;
+		typedef ptrdiff_t difference_type;
+		typedef Hash hasher;
+		typedef KeyEqual key_equal;
+		typedef Allocator allocator_type;
+		typedef typename Allocator::reference reference;
+		typedef typename Allocator::const_reference const_reference;
+		typedef typename Allocator::pointer pointer;
+		typedef typename Allocator::const_pointer const_pointer;
+		typedef ft::hash_iterator<value_type> iterator;
+		typedef ft::hash_iterator<const value_type> const_iterator;
+		typedef hash_group::ctrl_type ctrl_type;
+		typedef typename Allocator::template rebind<ctrl_type>::other ctrl_allocator;
+
+		/**
+		 * Constructs an empty container.
+		 * @param bucket_count minimal number of slots to use on initialization
+		 * @param hash hash function to use
+		 * @param equal comparison function to use for all key comparisons of this container
+		 * @param alloc allocator to use for all memory allocations of this container
+		 */
+		explicit unordered_map(size_type bucket_count = 0, const hasher &hash = hasher(), const key_equal &equal = key_equal(), const allocator_type &alloc = allocator_type()) : _alloc(alloc), _ctrl_alloc(alloc), _hash(hash), _equal(equal), _ctrl(nullptr), _slots(nullptr), _capacity(0), _size(0), _growth_left(0) {
+			rehash(bucket_count);
+		}
+
+		/**
+		 * Constructs the container with the contents of the range [first, last).
+		 * @param first the range to copy the elements from
+		 * @param last the range to copy the elements from
+		 * @param bucket_count minimal number of slots to use on initialization
+		 * @param hash hash function to use
+		 * @param equal comparison function to use for all key comparisons of this container
+		 * @param alloc allocator to use for all memory allocations of this container
+		 */
+		template<class InputIt>
+		unordered_map(InputIt first, InputIt last, size_type bucket_count = 0, const hasher &hash = hasher(), const key_equal &equal = key_equal(), const allocator_type &alloc = allocator_type()) : _alloc(alloc), _ctrl_alloc(alloc), _hash(hash), _equal(equal), _ctrl(nullptr), _slots(nullptr), _capacity(0), _size(0), _growth_left(0) {
+			rehash(bucket_count);
+			insert(first, last);
+		}
+
+		/**
+		 * Copy constructor. Constructs the container with the copy of the contents of other.
+		 * @param other another container to be used as source to initialize the elements of the container with
+		 */
+		unordered_map(const unordered_map &other) : _alloc(other._alloc), _ctrl_alloc(other._ctrl_alloc), _hash(other._hash), _equal(other._equal), _ctrl(nullptr), _slots(nullptr), _capacity(0), _size(0), _growth_left(0) {
+			reserve(other.size());
+			insert(other.begin(), other.end());
+		}
+
+		/**
+		 * Destructs the unordered_map.
+		 */
+		~unordered_map() {
+			clear();
+			release(_ctrl, _slots, _capacity);
+		}
+
+		/**
+		 * Copy assignment operator. Replaces the contents with a copy of the contents of other.
+		 * @param other another container to use as data source
+		 * @return *this
+		 */
+		unordered_map &operator=(const unordered_map &other) {
+			if (this != &other) {
+				clear();
+				reserve(other.size());
+				insert(other.begin(), other.end());
+			}
+			return *this;
+		}
+
+		/**
+		 * Returns the allocator associated with the container.
+		 * @return the associated allocator
+		 */
+		allocator_type get_allocator() const {
+			return _alloc;
+		}
+
+		/**
+		 * Returns an iterator to the first element of the unordered_map.
+		 * @return iterator to the first element
+		 */
+		iterator begin() {
+			iterator it(_ctrl, _slots);
+
+			if (_capacity) {
+				it.skip();
+			}
+			return it;
+		}
+
+		/**
+		 * Returns a const iterator to the first element of the unordered_map.
+		 * @return const iterator to the first element
+		 */
+		const_iterator begin() const {
+			const_iterator it(_ctrl, _slots);
+
+			if (_capacity) {
+				it.skip();
+			}
+			return it;
+		}
+
+		/**
+		 * Returns an iterator to the element following the last element of the unordered_map.
+		 * @return iterator to the element following the last element
+		 */
+		iterator end() {
+			return iterator(_ctrl + _capacity, _slots + _capacity);
+		}
+
+		/**
+		 * Returns a const iterator to the element following the last element of the unordered_map.
+		 * @return const iterator to the element following the last element
+		 */
+		const_iterator end() const {
+			return const_iterator(_ctrl + _capacity, _slots + _capacity);
+		}
+
+		/**
+		 * Checks if the container has no elements.
+		 * @return true if the container is empty, false otherwise
+		 */
+		bool empty() const {
+			return _size == 0;
+		}
+
+		/**
+		 * Returns the number of elements in the container.
+		 * @return the number of elements in the container
+		 */
+		size_type size() const {
+			return _size;
+		}
+
+		/**
+		 * Returns the maximum number of elements the container is able to hold due to system or library implementation limitations.
+		 * @return maximum number of elements
+		 */
+		size_type max_size() const {
+			return _alloc.max_size();
+		}
+
+		/**
+		 * Erases all elements from the container, keeping the slots allocated.
+		 */
+		void clear() {
+			for (size_type i = 0; i < _capacity; i++) {
+				if (_ctrl[i] >= 0) {
+					_alloc.destroy(_slots + i);
+				}
+				_ctrl[i] = hash_group::empty;
+			}
+			_size = 0;
+			_growth_left = growth(_capacity);
+		}
+
+		/**
+		 * Inserts value if the container doesn't already contain an element with an equivalent key.
+		 * @param value element value to insert
+		 * @return Returns a pair consisting of an iterator to the inserted element, or to the element that prevented the insertion, and a bool denoting whether the insertion took place
+		 */
+		ft::pair<iterator, bool> insert(const value_type &value) {
+			size_t h = hash_of(value.first);
+			size_type i = find_index(value.first, h);
+
+			if (i != npos) {
+				return ft::make_pair(at_index(i), false);
+			}
+			i = prepare_insert(h);
+			_alloc.construct(_slots + i, value);
+			publish(i, h);
+			return ft::make_pair(at_index(i), true);
+		}
+
+		/**
+		 * Inserts value, hint is ignored since the position of an element only depends on its hash.
+		 * @param hint unused
+		 * @param value element value to insert
+		 * @return returns an iterator to the inserted element, or to the element that prevented the insertion
+		 */
+		iterator insert(const_iterator hint, const value_type &value) {
+			(void) hint;
+			return insert(value).first;
+		}
+
+		/**
+		 * Inserts elements from range [first, last).
+		 * @param first range of elements to insert
+		 * @param last range of elements to insert
+		 */
+		template<class InputIt>
+		void insert(InputIt first, InputIt last) {
+			for (; first != last; ++first) {
+				insert(value_type((*first).first, (*first).second));
+			}
+		}
+
+		/**
+		 * Removes the element at pos.
+		 * @param pos iterator to the element to remove
+		 */
+		void erase(const_iterator pos) {
+			erase_index(pos._ctrl - _ctrl);
+		}
+
+		/**
+		 * Removes the elements in the range [first; last), which must be a valid range in *this.
+		 * @param first range of elements to remove
+		 * @param last range of elements to remove
+		 */
+		void erase(const_iterator first, const_iterator last) {
+			while (first != last) {
+				const_iterator next = first;
+				++next;
+				erase(first);
+				first = next;
+			}
+		}
+
+		/**
+		 * Removes the element (if one exists) with the key equivalent to key.
+		 * @param key key value of the elements to remove
+		 * @return Number of elements removed (0 or 1).
+		 */
+		size_type erase(const key_type &key) {
+			size_type i = find_index(key, hash_of(key));
+
+			if (i == npos) {
+				return 0;
+			}
+			erase_index(i);
+			return 1;
+		}
+
+		/**
+		 * Exchanges the contents of the container with those of other.
+		 * @param other container to exchange the contents with
+		 */
+		void swap(unordered_map &other) {
+			std::swap(_alloc, other._alloc);
+			std::swap(_ctrl_alloc, other._ctrl_alloc);
+			std::swap(_hash, other._hash);
+			std::swap(_equal, other._equal);
+			std::swap(_ctrl, other._ctrl);
+			std::swap(_slots, other._slots);
+			std::swap(_capacity, other._capacity);
+			std::swap(_size, other._size);
+			std::swap(_growth_left, other._growth_left);
+		}
+
+		/**
+		 * Returns a reference to the value that is mapped to a key equivalent to key, performing an insertion if such key does not already exist.
+		 * @param key the key of the element to find
+		 * @return reference to the mapped value of the new element if no element with key key existed
+		 */
+		mapped_type &operator[](const key_type &key) {
+			return insert(value_type(key, mapped_type())).first->second;
+		}
+
+		/**
+		 * Returns a reference to the mapped value of the element with key equivalent to key.
+		 * @param key the key of the element to find
+		 * @return reference to the mapped value of the requested element
+		 */
+		mapped_type &at(const key_type &key) {
+			size_type i = find_index(key, hash_of(key));
+
+			if (i == npos) {
+				throw std::out_of_range("ft::unordered_map::at: key not found");
+			}
+			return _slots[i].second;
+		}
+
+		/**
+		 * Returns a const reference to the mapped value of the element with key equivalent to key.
+		 * @param key the key of the element to find
+		 * @return const reference to the mapped value of the requested element
+		 */
+		const mapped_type &at(const key_type &key) const {
+			size_type i = find_index(key, hash_of(key));
+
+			if (i == npos) {
+				throw std::out_of_range("ft::unordered_map::at: key not found");
+			}
+			return _slots[i].second;
+		}
+
+		/**
+		 * Returns the number of elements with key that compares equal to key, which is either 1 or 0.
+		 * @param key key value of the elements to count
+		 * @return number of elements with key key
+		 */
+		size_type count(const key_type &key) const {
+			return find_index(key, hash_of(key)) == npos ? 0 : 1;
+		}
+
+		/**
+		 * Finds an element with key equivalent to key.
+		 * @param key key value of the element to search for
+		 * @return iterator to an element with key equivalent to key, or end()
+		 */
+		iterator find(const key_type &key) {
+			size_type i = find_index(key, hash_of(key));
+
+			return i == npos ? end() : at_index(i);
+		}
+
+		/**
+		 * Finds an element with key equivalent to key.
+		 * @param key key value of the element to search for
+		 * @return const iterator to an element with key equivalent to key, or end()
+		 */
+		const_iterator find(const key_type &key) const {
+			size_type i = find_index(key, hash_of(key));
+
+			return i == npos ? end() : const_iterator(_ctrl + i, _slots + i);
+		}
+
+		/**
+		 * Returns a range containing all elements with key key in the container.
+		 * @param key key value to compare the elements to
+		 * @return ft::pair containing a pair of iterators defining the wanted range
+		 */
+		ft::pair<iterator, iterator> equal_range(const key_type &key) {
+			iterator first = find(key);
+			iterator last = first;
+
+			if (last != end()) {
+				++last;
+			}
+			return ft::make_pair(first, last);
+		}
+
+		/**
+		 * Returns a range containing all elements with key key in the container.
+		 * @param key key value to compare the elements to
+		 * @return ft::pair containing a pair of const iterators defining the wanted range
+		 */
+		ft::pair<const_iterator, const_iterator> equal_range(const key_type &key) const {
+			const_iterator first = find(key);
+			const_iterator last = first;
+
+			if (last != end()) {
+				++last;
+			}
+			return ft::make_pair(first, last);
+		}
+
+		/**
+		 * Returns the number of slots of the container.
+		 * @return the number of slots
+		 */
+		size_type bucket_count() const {
+			return _capacity;
+		}
+
+		/**
+		 * Returns the average number of elements per slot.
+		 * @return the current load factor
+		 */
+		float load_factor() const {
+			return _capacity ? static_cast<float>(_size) / _capacity : 0.0f;
+		}
+
+		/**
+		 * Returns the load factor over which the container grows, fixed to 7/8 to keep the probe sequences short.
+		 * @return the maximum load factor
+		 */
+		float max_load_factor() const {
+			return 0.875f;
+		}
+
+		/**
+		 * Sets the number of slots to at least count and rehashes the container.
+		 * @param count the lower bound of the new number of slots
+		 */
+		void rehash(size_type count) {
+			size_type capacity = hash_group::width;
+
+			if (count == 0 && _size == 0) {
+				return;
+			}
+			while (capacity < count || growth(capacity) < _size) {
+				capacity *= 2;
+			}
+			if (capacity != _capacity) {
+				resize(capacity);
+			}
+		}
+
+		/**
+		 * Sets the number of slots so that count elements fit without growing again.
+		 * @param count the number of elements to make room for
+		 */
+		void reserve(size_type count) {
+			size_type capacity = hash_group::width;
+
+			while (growth(capacity) < count) {
+				capacity *= 2;
+			}
+			if (capacity > _capacity) {
+				resize(capacity);
+			}
+		}
+
+		/**
+		 * Returns the function that hashes the keys.
+		 * @return the hash function
+		 */
+		hasher hash_function() const {
+			return _hash;
+		}
+
+		/**
+		 * Returns the function that compares keys for equality.
+		 * @return the key comparison function
+		 */
+		key_equal key_eq() const {
+			return _equal;
+		}
+
+		/**
+		 * Checks if lhs and rhs hold the same elements, in any order.
+		 * @param lhs unordered_maps whose contents to compare
+		 * @param rhs unordered_maps whose contents to compare
+		 * @return true if the contents of the unordered_maps are equal, false otherwise
+		 */
+		friend bool operator==(const unordered_map &lhs, const unordered_map &rhs) {
+			if (lhs.size() != rhs.size()) {
+				return false;
+			}
+			for (const_iterator it = lhs.begin(); it != lhs.end(); ++it) {
+				const_iterator other = rhs.find(it->first);
+
+				if (other == rhs.end() || !(other->second == it->second)) {
+					return false;
+				}
+			}
+			return true;
+		}
+
+		/**
+		 * Checks if lhs and rhs hold different elements.
+		 * @param lhs unordered_maps whose contents to compare
+		 * @param rhs unordered_maps whose contents to compare
+		 * @return true if the contents of the unordered_maps are not equal, false otherwise
+		 */
+		friend bool operator!=(const unordered_map &lhs, const unordered_map &rhs) {
+			return !(lhs == rhs);
+		}
+
+		/**
+		 * Specializes the ft::swap algorithm for ft::unordered_map.
+		 * @param lhs containers whose contents to swap
+		 * @param rhs containers whose contents to swap
+		 */
+		friend void swap(unordered_map &lhs, unordered_map &rhs) {
+			lhs.swap(rhs);
+		}
+
+	private:
+		static const size_type npos = static_cast<size_type>(-1);
+
+		/**
+		 * Returns the number of elements capacity slots hold before the container grows.
+		 */
+		static size_type growth(size_type capacity) {
+			return capacity - capacity / 8;
+		}
+
+		/**
+		 * Mixes the user hash so that both the 7 bits kept in the control bytes and the bits choosing the first group are well distributed.
+		 */
+		size_t hash_of(const key_type &key) const {
+			size_t h = _hash(key) * static_cast<size_t>(0x9E3779B97F4A7C15UL);
+
+			return h ^ (h >> (sizeof(size_t) * 4));
+		}
+
+		static ctrl_type h2(size_t h) {
+			return static_cast<ctrl_type>(h & 0x7F);
+		}
+
+		/**
+		 * Returns the first group of the probe sequence of h, in slots.
+		 */
+		size_type probe_start(size_t h) const {
+			return ((h >> 7) * hash_group::width) & (_capacity - 1);
+		}
+
+		/**
+		 * Returns the slot holding key, or npos.
+		 */
+		size_type find_index(const key_type &key, size_t h) const {
+			size_type pos;
+
+			if (_capacity == 0) {
+				return npos;
+			}
+			pos = probe_start(h);
+			for (size_type step = hash_group::width; ; step += hash_group::width) {
+				hash_group group(_ctrl + pos);
+
+				for (hash_group::mask_type mask = group.match(h2(h)); mask; mask &= mask - 1) {
+					size_type i = pos + hash_group::lowest(mask);
+
+					if (_equal(_slots[i].first, key)) {
+						return i;
+					}
+				}
+				if (group.match_empty()) {
+					return npos;
+				}
+				pos = (pos + step) & (_capacity - 1);
+			}
+		}
+
+		/**
+		 * Returns the first empty or deleted slot of the probe sequence of h.
+		 */
+		size_type find_first_non_full(size_t h) const {
+			size_type pos = probe_start(h);
+
+			for (size_type step = hash_group::width; ; step += hash_group::width) {
+				hash_group::mask_type mask = hash_group(_ctrl + pos).match_empty_or_deleted();
+
+				if (mask) {
+					return pos + hash_group::lowest(mask);
+				}
+				pos = (pos + step) & (_capacity - 1);
+			}
+		}
+
+		/**
+		 * Finds the slot where an element of hash h is constructed, growing the table first if needed. The slot is only taken by publish(), once the element is constructed.
+		 */
+		size_type prepare_insert(size_t h) {
+			size_type i;
+
+			if (_capacity == 0) {
+				resize(hash_group::width);
+			}
+			i = find_first_non_full(h);
+			if (_growth_left == 0 && _ctrl[i] != hash_group::deleted) {
+				resize(_size * 32 <= _capacity * 25 ? _capacity : _capacity * 2);
+				i = find_first_non_full(h);
+			}
+			return i;
+		}
+
+		/**
+		 * Marks slot i, where an element of hash h was just constructed, as full.
+		 */
+		void publish(size_type i, size_t h) {
+			if (_ctrl[i] == hash_group::empty) {
+				_growth_left--;
+			}
+			_ctrl[i] = h2(h);
+			_size++;
+		}
+
+		/**
+		 * Destroys the element of slot i. The slot becomes empty again when its group still has an empty slot, since no probe sequence can have gone past such a group, and deleted otherwise.
+		 */
+		void erase_index(size_type i) {
+			_alloc.destroy(_slots + i);
+			_size--;
+			if (hash_group(_ctrl + (i & ~(hash_group::width - 1))).match_empty()) {
+				_ctrl[i] = hash_group::empty;
+				_growth_left++;
+			} else {
+				_ctrl[i] = hash_group::deleted;
+			}
+		}
+
+		iterator at_index(size_type i) {
+			return iterator(_ctrl + i, _slots + i);
+		}
+
+		/**
+		 * Copies every element to new arrays of capacity slots, dropping the deleted slots, then destroys the old ones. If a copy throws, the table is left as it was.
+		 */
+		void resize(size_type capacity) {
+			ctrl_type *old_ctrl = _ctrl;
+			pointer old_slots = _slots;
+			size_type old_capacity = _capacity;
+			ctrl_type *ctrl = _ctrl_alloc.allocate(capacity + 1);
+			pointer slots;
+
+			try {
+				slots = _alloc.allocate(capacity);
+			} catch (...) {
+				_ctrl_alloc.deallocate(ctrl, capacity + 1);
+				throw;
+			}
+			_ctrl = ctrl;
+			_slots = slots;
+			_capacity = capacity;
+			std::memset(_ctrl, hash_group::empty, capacity);
+			_ctrl[capacity] = hash_group::sentinel;
+			try {
+				for (size_type i = 0; i < old_capacity; i++) {
+					if (old_ctrl[i] >= 0) {
+						size_t h = hash_of(old_slots[i].first);
+						size_type j = find_first_non_full(h);
+
+						_alloc.construct(_slots + j, old_slots[i]);
+						_ctrl[j] = h2(h);
+					}
+				}
+			} catch (...) {
+				for (size_type j = 0; j < capacity; j++) {
+					if (_ctrl[j] >= 0) {
+						_alloc.destroy(_slots + j);
+					}
+				}
+				release(_ctrl, _slots, capacity);
+				_ctrl = old_ctrl;
+				_slots = old_slots;
+				_capacity = old_capacity;
+				throw;
+			}
+			for (size_type i = 0; i < old_capacity; i++) {
+				if (old_ctrl[i] >= 0) {
+					_alloc.destroy(old_slots + i);
+				}
+			}
+			_growth_left = growth(capacity) - _size;
+			release(old_ctrl, old_slots, old_capacity);
+		}
+
+		void release(ctrl_type *ctrl, pointer slots, size_type capacity) {
+			if (capacity) {
+				_ctrl_alloc.deallocate(ctrl, capacity + 1);
+				_alloc.deallocate(slots, capacity);
+			}
+		}
+
+		/**
+		 * Member objects
+		 */
+		allocator_type _alloc;
+		ctrl_allocator _ctrl_alloc;
+		hasher _hash;
+		key_equal _equal;
+		ctrl_type *_ctrl;
+		pointer _slots;
+		size_type _capacity;
+		size_type _size;
+		size_type _growth_left;
+	};
+
+}
+
+#endif //FT_CONTAINERS_UNORDERED_MAP_HPP
@@ -502,7 +502,7 @@ namespace ft {
 			if (lhs.size() != rhs.size()) {
 				return false;
 			}
-			return ft::equal(lhs.begin(), lhs.end(), rhs.begin());
+			return ft::equal(lhs.begin().base(), lhs.end().base(), rhs.begin().base());
 		}
 
 		/**
@@ -522,7 +522,7 @@ namespace ft {
 		 * @return true if the contents of the lhs are lexicographically less than the contents of rhs, false otherwise
 		 */
 		friend bool operator<(const ft::vector<T, Allocator> &lhs, const ft::vector<T, Allocator> &rhs) {
-			return ft::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+			return ft::lexicographical_compare(lhs.begin().base(), lhs.end().base(), rhs.begin().base(), rhs.end().base());
 		}
 
 		/**
@@ -0,0 +1,91 @@
+#include "tests.hpp"
+#include <algorithm>
+
+/*
+** Minimum of two values, to check an operation other than a sum.
+*/
+struct minimum
+{
+	int operator()(const int &a, const int &b) const
+	{
+		return (std::min(a, b));
+	}
+};
+
+/*
+** Concatenation, to check that the operands keep the key order.
+*/
+struct concatenate
+{
+	std::string operator()(const std::string &a, const std::string &b) const
+	{
+		return (a + b);
+	}
+};
+
+static int sum_range(const std::map<int, int> &m, int lo, int hi)
+{
+	int sum = 0;
+
+	for (std::map<int, int>::const_iterator it = m.lower_bound(lo); it != m.end() && it->first <= hi; ++it)
+		sum += it->second;
+	return (sum);
+}
+
+static void sums(void)
+{
+	print_header("Range sums");
+	ft::aggregate_map<int, int> a;
+	std::map<int, int> m;
+	check("empty aggregate() == 0", a.aggregate(), 0);
+	bool same = true;
+	for (int i = 0; i < 4000; i++)
+	{
+		int key = (i * 7919) % 3001;
+		if (i % 4 == 3)
+		{
+			same = same && a.erase(key) == m.erase(key);
+			continue;
+		}
+		same = same && a.assign(ft::make_pair(key, i)) == (m.count(key) == 0);
+		m[key] = i;
+	}
+	check("assign() and erase()", same && a.size() == m.size());
+	check("aggregate() == total", a.aggregate(), sum_range(m, 0, 3001));
+	same = true;
+	for (int lo = -5; lo < 3010; lo += 37)
+		for (int hi = lo - 3; hi < 3010; hi += 211)
+			same = same && a.aggregate(lo, hi) == sum_range(m, lo, hi);
+	check("aggregate(lo, hi) == m2 sums", same);
+	check("aggregate(k, k) == value", a.aggregate(m.begin()->first, m.begin()->first), m.begin()->second);
+	check("find()", a.find(m.begin()->first)->second == m.begin()->second && a.find(-1) == a.end());
+	check("iterators are const", ft::is_same<ft::aggregate_map<int, int>::iterator::reference, const ft::pair<int, int> &>::value);
+	ft::aggregate_map<int, int> b(a);
+	a.clear();
+	check("copy keeps aggregates", b.aggregate(100, 2000), sum_range(m, 100, 2000));
+	check("clear()", a.empty() && a.aggregate() == 0);
+}
+
+static void operations(void)
+{
+	print_header("Operations");
+	ft::aggregate_map<int, int, minimum> a(1000000);
+	for (int i = 0; i < 1000; i++)
+		a.insert(ft::make_pair(i, (i * 37) % 1009));
+	check("min over [100, 200]", a.aggregate(100, 200), 4);
+	a.assign(ft::make_pair(150, -1));
+	check("assign() updates ancestors", a.aggregate(100, 200), -1);
+	check("empty range == identity", a.aggregate(2000, 3000), 1000000);
+	ft::aggregate_map<int, std::string, concatenate> c;
+	for (int i = 25; i >= 0; i--)
+		c.insert(ft::make_pair(i, std::string(1, static_cast<char>('a' + i))));
+	check("operands in key order", c.aggregate(3, 9), std::string("defghij"));
+	check("whole concatenation", c.aggregate(), std::string("abcdefghijklmnopqrstuvwxyz"));
+}
+
+void test_aggregate_map(void)
+{
+	print_header("aggregate_map");
+	sums();
+	operations();
+}
@@ -0,0 +1,99 @@
+#include "tests.hpp"
+#include <algorithm>
+
+/*
+** Compares ft::equal and ft::lexicographical_compare with std on prefixes
+** of a and b, of size elements.
+*/
+template <typename T>
+static bool same_as_std(const T *a, const T *b, size_t size)
+{
+	for (size_t i = 0; i <= size; i += 7)
+	{
+		for (size_t j = 0; j <= size; j += 7)
+		{
+			if (ft::lexicographical_compare(a, a + i, b, b + j) != std::lexicographical_compare(a, a + i, b, b + j))
+				return (false);
+		}
+		if (ft::equal(a, a + i, b) != std::equal(a, a + i, b))
+			return (false);
+	}
+	return (true);
+}
+
+/*
+** Ranges of low and high values, equal, then different in the middle and
+** on the last element, longer than the blocks the kernels skip.
+*/
+template <typename T>
+static bool kernel(T low, T high)
+{
+	T a[600];
+	T b[600];
+
+	for (size_t i = 0; i < 600; i++)
+	{
+		a[i] = i % 3 ? low : high;
+		b[i] = a[i];
+	}
+	if (!same_as_std(a, b, 600))
+		return (false);
+	b[300] = low;
+	a[300] = high;
+	if (!same_as_std(a, b, 600) || !same_as_std(b, a, 600))
+		return (false);
+	b[300] = a[300];
+	b[599] = low;
+	a[599] = high;
+	return (same_as_std(a, b, 600) && same_as_std(b, a, 600));
+}
+
+static void memcmp_kernels(void)
+{
+	print_header("Comparison kernels");
+	check("unsigned char", kernel<unsigned char>(1, 200));
+	check("char", kernel<char>(-100, 100));
+	check("signed char", kernel<signed char>(-100, 100));
+	check("int", kernel<int>(-70000, 70000));
+	check("unsigned int", kernel<unsigned int>(1, 0x80000001U));
+	check("long", kernel<long>(-1, 1L << 40));
+	check("bool", kernel<bool>(false, true));
+	check("double", kernel<double>(-0.5, 0.25));
+	int values[4] = {1, 2, 3, 4};
+	int copy[4] = {1, 2, 3, 4};
+	check("int * against const int *", ft::equal(values, values + 4, static_cast<const int *>(copy)) && !ft::lexicographical_compare(values, values + 4, static_cast<const int *>(copy), static_cast<const int *>(copy) + 4));
+	check("empty ranges", ft::equal(values, values, copy) && !ft::lexicographical_compare(values, values, copy, copy) && ft::lexicographical_compare(values, values, copy, copy + 1));
+}
+
+static void containers(void)
+{
+	print_header("Container comparisons");
+	ft::vector<int> v1;
+	ft::vector<int> v2;
+	check("empty vectors", v1 == v2 && !(v1 < v2) && v1 <= v2);
+	for (int i = 0; i < 1000; i++)
+	{
+		v1.push_back(i - 500);
+		v2.push_back(i - 500);
+	}
+	check("equal vectors", v1 == v2 && !(v1 < v2) && !(v2 < v1));
+	v2[999] = -1000;
+	check("last element differs", v1 != v2 && v2 < v1 && !(v1 < v2));
+	v2.pop_back();
+	check("prefix", v1 != v2 && v2 < v1);
+	ft::map<int, int> m;
+	for (int i = 0; i < 100; i++)
+		m[i] = i;
+	ft::map<int, int> &alias = m;
+	check("map against itself", m == alias && !(m < alias) && m <= alias);
+	ft::map<int, int> copy(m);
+	copy[50] = -1;
+	check("map against a changed copy", m != copy && !(copy == m));
+}
+
+void test_algorithm(void)
+{
+	print_header("algorithm");
+	memcmp_kernels();
+	containers();
+}
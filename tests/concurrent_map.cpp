@@ -0,0 +1,132 @@
+#include "tests.hpp"
+#include <pthread.h>
+
+static void insert_find(void)
+{
+	print_header("Insert / Find / Erase");
+	ft::concurrent_map<int, int> m1;
+	std::map<int, int> m2;
+	for (int i = 0; i < 100; i++)
+	{
+		m1.insert(ft::make_pair((i * 37) % 101, i));
+		m2.insert(std::make_pair((i * 37) % 101, i));
+	}
+	check("m1.size() == m2.size()", m1.size(), m2.size());
+	int value = 0;
+	check("m1.find(37) == m2.find(37)", m1.find(37, value) && value == m2.find(37)->second);
+	check("m1.find(100) == m2.find(100)", m1.find(100, value), m2.find(100) != m2.end());
+	check("m1.insert(37) == false", m1.insert(ft::make_pair(37, 0)) == false);
+	check("m1.insert_or_assign(37)", !m1.insert_or_assign(ft::make_pair(37, -1)) && m1.find(37, value) && value == -1);
+	m2[37] = -1;
+	for (int i = 0; i < 101; i += 3)
+	{
+		m1.erase(i);
+		m2.erase(i);
+	}
+	check("m1.size() == m2.size()", m1.size(), m2.size());
+	check("m1.count(3) == m2.count(3)", m1.count(3), m2.count(3));
+	check("m1.count(4) == m2.count(4)", m1.count(4), m2.count(4));
+	ft::concurrent_map<int, int>::snapshot s = m1.get_snapshot();
+	bool same = s.size() == m2.size();
+	std::map<int, int>::iterator it2 = m2.begin();
+	for (ft::concurrent_map<int, int>::const_iterator it = s.begin(); same && it != s.end(); ++it, ++it2)
+		same = it->first == it2->first && it->second == it2->second;
+	check("snapshot == m2", same);
+}
+
+static void bounds(void)
+{
+	print_header("Bounds");
+	ft::concurrent_map<std::string, int> m1;
+	std::map<std::string, int> m2;
+	m1.insert(ft::make_pair(std::string("a"), 1));
+	m1.insert(ft::make_pair(std::string("c"), 3));
+	m1.insert(ft::make_pair(std::string("e"), 5));
+	m2["a"] = 1;
+	m2["c"] = 3;
+	m2["e"] = 5;
+	ft::concurrent_map<std::string, int>::snapshot s = m1.get_snapshot();
+	check("lower_bound('b')", s.lower_bound("b")->first, m2.lower_bound("b")->first);
+	check("lower_bound('c')", s.lower_bound("c")->first, m2.lower_bound("c")->first);
+	check("upper_bound('c')", s.upper_bound("c")->first, m2.upper_bound("c")->first);
+	check("s.upper_bound('e') == end()", s.upper_bound("e") == s.end());
+	m1.erase("a");
+	check("snapshot is isolated", s.size() == 3 && s.begin()->first == "a" && m1.size() == 2);
+}
+
+static void *reader(void *arg)
+{
+	ft::concurrent_map<int, int> *m = static_cast<ft::concurrent_map<int, int> *>(arg);
+	long errors = 0;
+	for (int round = 0; round < 200; round++)
+	{
+		ft::concurrent_map<int, int>::snapshot s = m->get_snapshot();
+		size_t n = 0;
+		int previous = -1;
+		for (ft::concurrent_map<int, int>::const_iterator it = s.begin(); it != s.end(); ++it, ++n)
+		{
+			if (it->first <= previous || it->second != it->first * 2)
+				errors++;
+			previous = it->first;
+		}
+		if (n != s.size())
+			errors++;
+	}
+	return reinterpret_cast<void *>(errors);
+}
+
+static void threads(void)
+{
+	print_header("Threads");
+	ft::concurrent_map<int, int> m;
+	pthread_t readers[4];
+	for (int i = 0; i < 4; i++)
+		pthread_create(&readers[i], NULL, &reader, &m);
+	for (int i = 0; i < 20000; i++)
+	{
+		m.insert(ft::make_pair(i % 1000, (i % 1000) * 2));
+		if (i % 3 == 0)
+			m.erase((i * 7) % 1000);
+	}
+	long errors = 0;
+	for (int i = 0; i < 4; i++)
+	{
+		void *result;
+		pthread_join(readers[i], &result);
+		errors += reinterpret_cast<long>(result);
+	}
+	check("readers saw consistent versions", errors == 0);
+}
+
+/*
+** More maps alive at once than a process has thread-specific keys, each with
+** elements retired and still pending when it is destroyed.
+*/
+static void many_maps(void)
+{
+	print_header("Many maps");
+	ft::concurrent_map<int, int> *maps = new ft::concurrent_map<int, int>[2000];
+	bool found = true;
+	for (int i = 0; i < 2000; i++)
+	{
+		maps[i].insert(ft::make_pair(i, i));
+		maps[i].insert(ft::make_pair(i + 1, i));
+		maps[i].erase(i);
+	}
+	for (int i = 0; i < 2000; i++)
+	{
+		int value = -1;
+		found = found && maps[i].size() == 1 && maps[i].find(i + 1, value) && value == i;
+	}
+	delete[] maps;
+	check("2000 maps", found);
+}
+
+void test_concurrent_map(void)
+{
+	print_header("concurrent_map");
+	insert_find();
+	bounds();
+	threads();
+	many_maps();
+}
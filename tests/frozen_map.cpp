@@ -0,0 +1,94 @@
+#include "tests.hpp"
+#include <stdexcept>
+#include <sstream>
+
+static void find(void)
+{
+	print_header("Find");
+	for (int n = 0; n < 70; n++)
+	{
+		ft::map<int, int> m1;
+		std::map<int, int> m2;
+		for (int i = 0; i < n; i++)
+		{
+			m1[i * 2] = i;
+			m2[i * 2] = i;
+		}
+		ft::frozen_map<int, int> f = ft::freeze(m1);
+		bool same = f.size() == m2.size();
+		for (int key = -1; same && key <= n * 2; key++)
+		{
+			same = f.count(key) == m2.count(key);
+			if (f.lower_bound(key) == f.end())
+				same = same && m2.lower_bound(key) == m2.end();
+			else
+				same = same && f.lower_bound(key)->first == m2.lower_bound(key)->first;
+			if (f.upper_bound(key) == f.end())
+				same = same && m2.upper_bound(key) == m2.end();
+			else
+				same = same && f.upper_bound(key)->first == m2.upper_bound(key)->first;
+		}
+		if (n == 0 || n == 1 || n == 31 || n == 69)
+		{
+			std::ostringstream label;
+			label << "f == m2, " << n << " keys";
+			check(label.str(), same);
+		}
+	}
+}
+
+static void iterate(void)
+{
+	print_header("Iterate");
+	std::map<std::string, int> m;
+	for (int i = 0; i < 100; i++)
+	{
+		std::ostringstream key;
+		key << "key" << i;
+		m[key.str()] = i;
+	}
+	ft::frozen_map<std::string, int> f(m.begin(), m.end());
+	bool same = true;
+	std::map<std::string, int>::iterator it2 = m.begin();
+	for (ft::frozen_map<std::string, int>::const_iterator it = f.begin(); same && it != f.end(); ++it, ++it2)
+		same = it->first == it2->first && (*it).second == it2->second;
+	check("in order == m", same && it2 == m.end());
+	check("f.at('key42') == 42", f.at("key42"), 42);
+	try
+	{
+		f.at("missing");
+		check("at() throws", false);
+	}
+	catch (const std::out_of_range &)
+	{
+		check("at() throws", true);
+	}
+	ft::frozen_map<std::string, int> copy(f);
+	check("copy.find('key7')", copy.find("key7").value() == 7 && copy.size() == 100);
+}
+
+static void comparator(void)
+{
+	print_header("Custom comparator");
+	ft::map<int, int, std::greater<int> > m;
+	for (int i = 0; i < 20; i++)
+		m[(i * 7) % 20] = i;
+	ft::frozen_map<int, int, std::greater<int> > f = ft::freeze(m);
+	bool found = true;
+	for (int i = 0; i < 20; i++)
+		found = found && f.count(i) == 1 && f.find(i)->second == m[i];
+	check("find() every key", found && f.count(20) == 0 && f.count(-1) == 0);
+	int expected = 19;
+	bool ordered = true;
+	for (ft::frozen_map<int, int, std::greater<int> >::const_iterator it = f.begin(); it != f.end(); ++it)
+		ordered = ordered && it->first == expected--;
+	check("in Compare order", ordered && expected == -1 && f.lower_bound(25)->first == 19 && f.upper_bound(5)->first == 4);
+}
+
+void test_frozen_map(void)
+{
+	print_header("frozen_map");
+	find();
+	iterate();
+	comparator();
+}
@@ -0,0 +1,101 @@
+#include "tests.hpp"
+
+typedef ft::int_map<long, long> long_map;
+
+static bool same_contents(const long_map &m, const std::map<long, long> &ref)
+{
+	std::map<long, long>::const_iterator it2 = ref.begin();
+
+	if (m.size() != ref.size())
+		return (false);
+	for (long_map::const_iterator it = m.begin(); it != m.end(); ++it, ++it2)
+		if (it->first != it2->first || it->second != it2->second)
+			return (false);
+	return (true);
+}
+
+static bool same_bounds(const long_map &m, const std::map<long, long> &ref, long key)
+{
+	long_map::iterator lo = m.lower_bound(key);
+	long_map::iterator hi = m.upper_bound(key);
+	std::map<long, long>::const_iterator lo2 = ref.lower_bound(key);
+	std::map<long, long>::const_iterator hi2 = ref.upper_bound(key);
+
+	if ((lo == m.end()) != (lo2 == ref.end()) || (hi == m.end()) != (hi2 == ref.end()))
+		return (false);
+	return ((lo == m.end() || lo->first == lo2->first) && (hi == m.end() || hi->first == hi2->first));
+}
+
+/*
+** Sparse, dense and negative keys, so every node kind grows and shrinks back.
+*/
+static void mixed_keys(void)
+{
+	print_header("Mixed keys");
+	long_map m;
+	std::map<long, long> ref;
+	unsigned long x = 88172645463325252UL;
+	bool ok = true;
+	for (long i = 0; i < 20000; i++)
+	{
+		x ^= x << 13;
+		x ^= x >> 7;
+		x ^= x << 17;
+		long key = (i % 3 == 0) ? static_cast<long>(x) : (i % 3 == 1) ? i - 5000 : static_cast<long>(x % 300) << 20;
+		ok = ok && m.insert(ft::make_pair(key, i)).second == ref.insert(std::make_pair(key, i)).second;
+	}
+	check("insert() matches std::map", ok && same_contents(m, ref));
+	check("find() and count()", m.find(-4999)->second == ref[-4999] && m.find(1L << 60) == m.end() && m.count(-1) == 1 && m.count(-5000) == 0);
+	ok = true;
+	for (long key = -6000; key < 16000; key += 7)
+		ok = ok && same_bounds(m, ref, key);
+	for (std::map<long, long>::iterator it = ref.begin(); it != ref.end(); ++it)
+		ok = ok && same_bounds(m, ref, it->first) && same_bounds(m, ref, it->first + 1);
+	check("lower_bound() / upper_bound()", ok);
+	check("reverse scan", m.rbegin()->first == ref.rbegin()->first && (--m.end())->first == ref.rbegin()->first);
+	for (long key = -5000; key < 15000; key += 2)
+		ok = ok && m.erase(key) == ref.erase(key);
+	for (long key = 0; key < 300; key += 3)
+		ok = ok && m.erase(key << 20) == ref.erase(key << 20);
+	check("erase() matches std::map", ok && same_contents(m, ref));
+	long_map copy(m);
+	check("copy", same_contents(copy, ref));
+	m.erase(m.begin(), m.end());
+	check("erase() everything", m.empty() && m.begin() == m.end() && same_contents(copy, ref));
+}
+
+static void small_keys(void)
+{
+	print_header("Small keys");
+	ft::int_map<signed char, int> m;
+	for (int i = 127; i >= -128; i--)
+		m[static_cast<signed char>(i)] = i;
+	bool ok = m.size() == 256;
+	int expected = -128;
+	for (ft::int_map<signed char, int>::iterator it = m.begin(); it != m.end(); ++it, ++expected)
+		ok = ok && it->first == expected && it->second == expected;
+	check("negative keys sort first", ok);
+	for (int i = -128; i < 128; i += 2)
+		m.erase(static_cast<signed char>(i));
+	check("shrinks back", m.size() == 128 && m.begin()->first == -127 && m.lower_bound(0)->first == 1);
+	ft::int_map<signed char, int> other;
+	other[1] = 1;
+	other.swap(m);
+	check("swap()", m.size() == 1 && other.size() == 128);
+	try
+	{
+		m.at(2);
+		check("at() throws", false);
+	}
+	catch (const std::out_of_range &e)
+	{
+		check("at() throws", true);
+	}
+}
+
+void test_int_map(void)
+{
+	print_header("int_map");
+	mixed_keys();
+	small_keys();
+}
@@ -0,0 +1,102 @@
+#include "tests.hpp"
+#include <vector>
+#include <iterator>
+
+typedef ft::interval_map<int, int> intervals;
+
+/*
+** Intervals of the brute force list overlapping [lo, hi), or containing lo
+** when closed, sorted like the map returns them.
+*/
+static std::vector<std::pair<int, int> > brute_force(const std::map<std::pair<int, int>, int> &all, int lo, int hi, bool closed)
+{
+	std::vector<std::pair<int, int> > found;
+
+	for (std::map<std::pair<int, int>, int>::const_iterator it = all.begin(); it != all.end(); ++it)
+		if (it->first.second > lo && (closed ? it->first.first <= lo : it->first.first < hi))
+			found.push_back(it->first);
+	return (found);
+}
+
+static bool same_intervals(const std::vector<intervals::iterator> &found, const std::vector<std::pair<int, int> > &expected)
+{
+	if (found.size() != expected.size())
+		return (false);
+	for (size_t i = 0; i < found.size(); i++)
+		if (found[i]->first.lo != expected[i].first || found[i]->first.hi != expected[i].second)
+			return (false);
+	return (true);
+}
+
+static void queries(void)
+{
+	print_header("Queries");
+	intervals m;
+	std::map<std::pair<int, int>, int> all;
+	bool same = true;
+	for (int i = 0; i < 3000; i++)
+	{
+		int lo = (i * 7919) % 5003;
+		int hi = lo + 1 + (i * 31) % (i % 10 == 0 ? 800 : 40);
+		same = same && m.insert(lo, hi, i) == all.insert(std::make_pair(std::make_pair(lo, hi), i)).second;
+		if (i % 5 == 4)
+		{
+			int victim = ((i - 2) * 7919) % 5003;
+			int end = victim + 1 + ((i - 2) * 31) % ((i - 2) % 10 == 0 ? 800 : 40);
+			same = same && m.erase(victim, end) == all.erase(std::make_pair(victim, end));
+		}
+	}
+	check("insert() and erase()", same && m.size() == all.size());
+	same = true;
+	for (int lo = -10; lo < 5900; lo += 13)
+	{
+		std::vector<intervals::iterator> found;
+		m.overlapping(lo, lo + (lo % 7) * 20, std::back_inserter(found));
+		same = same && same_intervals(found, brute_force(all, lo, lo + (lo % 7) * 20, false));
+	}
+	check("overlapping() == brute force", same);
+	same = true;
+	for (int point = -10; point < 5900; point += 7)
+	{
+		std::vector<intervals::iterator> found;
+		m.containing(point, std::back_inserter(found));
+		same = same && same_intervals(found, brute_force(all, point, point, true));
+	}
+	check("containing() == brute force", same);
+	check("find()", m.find(all.begin()->first.first, all.begin()->first.second)->second == all.begin()->second && m.find(0, -1) == m.end());
+	const intervals &c = m;
+	intervals::const_iterator it = c.find(all.begin()->first.first, all.begin()->first.second);
+	check("const find()", it == c.begin() && it->second == all.begin()->second && c.find(0, -1) == c.end());
+	check("const iterators are const", ft::is_same<intervals::const_iterator::reference, const intervals::value_type &>::value);
+}
+
+static void bounds(void)
+{
+	print_header("Bounds");
+	intervals m;
+	std::vector<intervals::iterator> found;
+	m.insert(10, 20, 1);
+	m.insert(20, 30, 2);
+	m.insert(10, 15, 3);
+	m.overlapping(20, 25, std::back_inserter(found));
+	check("[10, 20) ends before 20", found.size() == 1 && found[0]->second == 2);
+	found.clear();
+	m.overlapping(5, 11, std::back_inserter(found));
+	check("same starts, ordered by end", found.size() == 2 && found[0]->second == 3 && found[1]->second == 1);
+	found.clear();
+	m.containing(20, std::back_inserter(found));
+	check("containing(20)", found.size() == 1 && found[0]->second == 2);
+	found.clear();
+	m.overlapping(30, 40, std::back_inserter(found));
+	check("nothing after the last end", found.empty());
+	intervals copy(m);
+	m.clear();
+	check("copy and clear()", copy.size() == 3 && m.empty() && m.begin() == m.end());
+}
+
+void test_interval_map(void)
+{
+	print_header("interval_map");
+	queries();
+	bounds();
+}
@@ -24,11 +24,53 @@ int main(int argc, char **argv)
 		test_map();
 	else if (choice == "stack")
 		test_stack();
+	else if (choice == "concurrent_map")
+		test_concurrent_map();
+	else if (choice == "skiplist_map")
+		test_skiplist_map();
+	else if (choice == "unordered_map")
+		test_unordered_map();
+	else if (choice == "frozen_map")
+		test_frozen_map();
+	else if (choice == "aggregate_map")
+		test_aggregate_map();
+	else if (choice == "interval_map")
+		test_interval_map();
+	else if (choice == "small_map")
+		test_small_map();
+	else if (choice == "int_map")
+		test_int_map();
+	else if (choice == "radix_map")
+		test_radix_map();
+	else if (choice == "map_filter")
+		test_map_filter();
+	else if (choice == "map_diff")
+		test_map_diff();
+	else if (choice == "algorithm")
+		test_algorithm();
+	else if (choice == "map_snapshot")
+		test_map_snapshot();
+	else if (choice == "mmap_map")
+		test_mmap_map();
 	else if (choice == "all")
 	{
 		test_vector();
 		test_map();
 		test_stack();
+		test_concurrent_map();
+		test_skiplist_map();
+		test_unordered_map();
+		test_frozen_map();
+		test_aggregate_map();
+		test_interval_map();
+		test_small_map();
+		test_int_map();
+		test_radix_map();
+		test_map_filter();
+		test_map_diff();
+		test_algorithm();
+		test_map_snapshot();
+		test_mmap_map();
 	}
 	else
 		std::cout << "No test for " << choice << std::endl;
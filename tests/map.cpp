@@ -1,6 +1,9 @@
 #include "tests.hpp"
 #include <map>
 #include <utility>
+#include <iterator>
+#include <sstream>
+#include <string>
 
 template <class T>
 static void print_map(T &map)
@@ -174,6 +177,31 @@ static void find(void)
 	check("m1.find('z') == m2.find('z')", m1.find("a")->second, m2.find("a")->second);
 }
 
+static void find_many(void)
+{
+	print_header("Find many");
+	ft::map<int, int> m1;
+	std::map<int, int> m2;
+	std::vector<int> keys;
+	for (int i = 0; i < 1000; i++)
+	{
+		m1[i * 3] = i;
+		m2[i * 3] = i;
+	}
+	for (int i = 0; i < 200; i++)
+		keys.push_back((i * 7919) % 3001);
+	std::vector<ft::map<int, int>::iterator> found;
+	m1.find_many(keys.begin(), keys.end(), std::back_inserter(found));
+	bool same = found.size() == keys.size();
+	for (size_t i = 0; same && i < keys.size(); i++)
+		same = (found[i] == m1.end()) == (m2.find(keys[i]) == m2.end()) && (found[i] == m1.end() || found[i]->second == m2[keys[i]]);
+	check("find_many() == find()", same);
+	ft::map<int, int> m3;
+	found.clear();
+	m3.find_many(keys.begin(), keys.begin() + 3, std::back_inserter(found));
+	check("find_many() on empty map", found.size() == 3 && found[0] == m3.end());
+}
+
 static void count(void)
 {
 	print_header("Count");
@@ -271,6 +299,606 @@ static void operators_comp(void)
 	check("m1 <= m2", (m1 <= m3), (m2 <= m4));
 }
 
+static void iterators(void)
+{
+	print_header("Iterators");
+	ft::map<int, int> m1;
+	std::map<int, int> m2;
+	for (int i = 0; i < 500; i++)
+	{
+		m1[(i * 37) % 503] = i;
+		m2[(i * 37) % 503] = i;
+	}
+	bool same = true;
+	std::map<int, int>::reverse_iterator rit2 = m2.rbegin();
+	for (ft::map<int, int>::reverse_iterator rit = m1.rbegin(); same && rit != m1.rend(); ++rit, ++rit2)
+		same = rit->first == rit2->first && rit->second == rit2->second;
+	check("reverse scan == m2", same && rit2 == m2.rend());
+	check("--end() == last", (--m1.end())->first, (--m2.end())->first);
+	ft::map<int, int>::iterator it = m1.find(100);
+	ft::map<int, int>::const_iterator cit = it;
+	check("iterator is one pointer", sizeof(it) == sizeof(void *) && cit == it);
+	ft::map<int, int> m3;
+	check("empty begin() == end()", m3.begin() == m3.end() && m3.rbegin() == m3.rend());
+}
+
+template <typename Map>
+static void tree_policy(std::string name)
+{
+	print_header(name);
+	Map m1;
+	std::map<int, int> m2;
+	for (int i = 0; i < 3000; i++)
+	{
+		int key = (i * 7919) % 1031;
+		if (i % 3 == 2)
+		{
+			m1.erase(key);
+			m2.erase(key);
+		}
+		else
+		{
+			m1[key] = i;
+			m2[key] = i;
+		}
+	}
+	check("m1.size() == m2.size()", m1.size(), m2.size());
+	bool same = true;
+	std::map<int, int>::iterator it2 = m2.begin();
+	for (typename Map::iterator it = m1.begin(); same && it != m1.end(); ++it, ++it2)
+		same = it->first == it2->first && it->second == it2->second;
+	check("forward scan == m2", same && it2 == m2.end());
+	same = true;
+	std::map<int, int>::reverse_iterator rit2 = m2.rbegin();
+	for (typename Map::reverse_iterator rit = m1.rbegin(); same && rit != m1.rend(); ++rit, ++rit2)
+		same = rit->first == rit2->first;
+	check("reverse scan == m2", same && rit2 == m2.rend());
+	check("find() == m2.find()", m1.find(m2.begin()->first)->second == m2.begin()->second && m1.find(-1) == m1.end());
+	typename Map::iterator first = m1.begin();
+	std::map<int, int>::iterator first2 = m2.begin();
+	for (int i = 0; i < 10; i++, ++first, ++first2)
+		;
+	m1.erase(first, --m1.end());
+	m2.erase(first2, --m2.end());
+	check("erase(first, last)", m1.size() == m2.size() && m1.begin()->first == m2.begin()->first && (--m1.end())->first == (--m2.end())->first);
+	Map m3;
+	m3[1] = 1;
+	m3.swap(m1);
+	check("swap()", m1.size() == 1 && (--m1.end())->first == 1 && m3.size() == m2.size() && m3.begin()->first == m2.begin()->first);
+	m3.clear();
+	check("clear()", m3.empty() && m3.begin() == m3.end());
+}
+
+template <typename Map>
+static void compaction(std::string name)
+{
+	print_header(name);
+	Map m1;
+	std::map<int, int> m2;
+	for (int i = 0; i < 2000; i++)
+	{
+		int key = (i * 7919) % 1031;
+		m1[key] = i;
+		m2[key] = i;
+		if (i % 4 == 3)
+		{
+			m1.erase((key * 3) % 1031);
+			m2.erase((key * 3) % 1031);
+		}
+	}
+	m1.compact();
+	bool same = true;
+	bool ordered = true;
+	std::map<int, int>::iterator it2 = m2.begin();
+	for (typename Map::iterator it = m1.begin(); same && it != m1.end(); ++it, ++it2)
+	{
+		same = it->first == it2->first && it->second == it2->second;
+		if (it != m1.begin())
+		{
+			typename Map::iterator prev = it;
+			--prev;
+			ordered = ordered && &*prev < &*it;
+		}
+	}
+	check("compact() keeps contents", same && it2 == m2.end() && m1.size() == m2.size());
+	check("compact() lays out in order", ordered);
+	check("find() after compact()", m1.find(m2.rbegin()->first)->second == m2.rbegin()->second && m1.find(-1) == m1.end());
+	for (int i = 0; i < 1031; i += 2)
+	{
+		m1.erase(i);
+		m2.erase(i);
+	}
+	for (int i = 2000; i < 2100; i++)
+	{
+		m1[i] = i;
+		m2[i] = i;
+	}
+	m1.compact();
+	same = m1.size() == m2.size();
+	it2 = m2.begin();
+	for (typename Map::iterator it = m1.begin(); same && it != m1.end(); ++it, ++it2)
+		same = it->first == it2->first && it->second == it2->second;
+	check("churn, compact() again", same);
+	m1.clear();
+	m1.compact();
+	check("compact() empty map", m1.empty() && m1.begin() == m1.end());
+}
+
+static void rebuild(void)
+{
+	print_header("Background rebuild");
+	ft::map<int, int> m1;
+	std::map<int, int> m2;
+	for (int i = 0; i < 20000; i++)
+	{
+		m1[(i * 7919) % 20011] = i;
+		m2[(i * 7919) % 20011] = i;
+	}
+	ft::map_rebuild<ft::map<int, int> > r(m1);
+	check("start()", r.start() && r.running() && !r.start());
+	bool same = true;
+	for (int i = 0; i < 3000; i++)
+	{
+		int key = (i * 31) % 25000;
+		if (i % 3 == 0)
+			same = same && r.erase(key) == m2.erase(key);
+		else
+		{
+			same = same && r.insert_or_assign(ft::make_pair(key, -i)) == (m2.count(key) == 0);
+			m2[key] = -i;
+		}
+	}
+	check("writes during rebuild", same);
+	int value = 0;
+	same = true;
+	for (int key = 0; key < 25000; key += 7)
+		same = same && r.find(key, value) == (m2.count(key) == 1) && (m2.count(key) == 0 || value == m2[key]);
+	check("reads see pending writes", same);
+	r.finish();
+	check("finish() swaps in", !r.running() && m1.size() == m2.size());
+	same = true;
+	std::map<int, int>::iterator it2 = m2.begin();
+	for (ft::map<int, int>::iterator it = m1.begin(); same && it != m1.end(); ++it, ++it2)
+		same = it->first == it2->first && it->second == it2->second;
+	check("rebuilt map == m2", same);
+	r.start();
+	while (!r.poll())
+		r.insert_or_assign(ft::make_pair(1, 1));
+	check("poll() swaps in", !r.running() && m1[1] == 1 && m1.size() == m2.size() + (m2.count(1) == 0));
+	r.erase(1);
+	check("writes when idle", m1.count(1) == 0);
+}
+
+/*
+** Arena node linked by 8 bit indices, to run out of them.
+*/
+struct tiny_arena_node
+{
+	typedef ft::pair<int, int> value_type;
+	typedef unsigned char index_type;
+
+	value_type value;
+	index_type parent;
+	index_type left;
+	index_type right;
+	int height;
+
+	tiny_arena_node(const value_type &value) : value(value), parent(0), left(0), right(0), height(1) {}
+};
+
+static void arena_limits(void)
+{
+	print_header("Arena limits");
+	ft::arena_avl_tree<int, int, ft::vector<tiny_arena_node> > tree;
+	for (int i = 0; i < 255; i++)
+		tree.insert(ft::make_pair(i, i));
+	bool thrown = false;
+	try
+	{
+		tree.insert(ft::make_pair(255, 255));
+	}
+	catch (const std::length_error &e)
+	{
+		thrown = true;
+	}
+	check("full arena throws", thrown && tree.getSize() == 255 && tree.find(ft::make_pair(255, 0)) == 0 && tree.find(ft::make_pair(254, 0)) != 0);
+	tree.remove(ft::make_pair(7, 0));
+	tree.insert(ft::make_pair(255, 255));
+	check("erased index reused", tree.getSize() == 255 && tree.find(ft::make_pair(255, 0)) != 0 && tree.find(ft::make_pair(7, 0)) == 0);
+	ft::arena_avl_tree<int, std::string> strings;
+	for (int i = 0; i < 10; i++)
+		strings.insert(ft::make_pair(i, std::string(100, 'a' + i)));
+	unsigned int index = strings.find(ft::make_pair(4, std::string()));
+	strings.remove(ft::make_pair(4, std::string()));
+	check("erased value released", strings.node(index).value.second.empty() && strings.getSize() == 9);
+	strings.insert(ft::make_pair(42, std::string("reused")));
+	check("released slot reused", strings.find(ft::make_pair(42, std::string())) == index && strings.node(index).value.second == "reused");
+}
+
+/*
+** String keys, some shorter than the cached prefix, most equal on it, so
+** that both the prefix and the fallback comparison decide.
+*/
+static void prefix_nodes(void)
+{
+	print_header("Prefix nodes");
+	typedef ft::map<std::string, int, std::less<std::string>, std::allocator<ft::pair<const std::string, int> >, ft::avl_tree<std::string, int, ft::PrefixNode<std::string, int> > > string_map;
+	string_map m1;
+	std::map<std::string, int> m2;
+	std::string heads[5] = {"", "a", "tenant/0001/metrics/", "tenant/0002/metrics/", std::string("ab\0\0", 4)};
+	for (int i = 0; i < 3000; i++)
+	{
+		int n = (i * 7919) % 1031;
+		std::ostringstream key;
+		key << heads[n % 5] << n % 7 << "/" << n;
+		if (i % 3 == 2)
+		{
+			m1.erase(key.str());
+			m2.erase(key.str());
+		}
+		else
+		{
+			m1[key.str()] = i;
+			m2[key.str()] = i;
+		}
+	}
+	bool same = m1.size() == m2.size();
+	std::map<std::string, int>::iterator it2 = m2.begin();
+	for (string_map::iterator it = m1.begin(); same && it != m1.end(); ++it, ++it2)
+		same = it->first == it2->first && it->second == it2->second;
+	check("insert() and erase() == m2", same);
+	same = true;
+	for (it2 = m2.begin(); it2 != m2.end(); ++it2)
+		same = same && m1.find(it2->first)->second == it2->second && m1.count(it2->first + "x") == 0;
+	check("find() == m2.find()", same && m1.find("tenant/0001/metrics/") == m1.end());
+	for (it2 = m2.begin(); it2 != m2.end(); )
+	{
+		m1.erase(it2->first);
+		m2.erase(it2++);
+		if (it2 != m2.end())
+			++it2;
+	}
+	same = m1.size() == m2.size();
+	it2 = m2.begin();
+	for (string_map::iterator it = m1.begin(); same && it != m1.end(); ++it, ++it2)
+		same = it->first == it2->first && m1.find(it->first) == it;
+	check("erase every other key", same);
+}
+
+/*
+** Searches from hints near and far from the key, present or missing.
+*/
+static void finger_search(void)
+{
+	print_header("Finger search");
+	ft::map<int, int> m1;
+	std::map<int, int> m2;
+	for (int i = 0; i < 2000; i++)
+	{
+		int key = (i * 7919) % 4001;
+		m1[key] = i;
+		m2[key] = i;
+	}
+	bool same = true;
+	ft::map<int, int>::iterator hint = m1.end();
+	for (int key = -5; key < 4010; key += 3)
+	{
+		ft::map<int, int>::iterator it = m1.find(hint, key);
+		same = same && (it == m1.end() ? m2.count(key) == 0 : it->first == key && it->second == m2[key]);
+		if (it != m1.end())
+			hint = it;
+	}
+	check("find(hint) walking forward", same);
+	same = true;
+	for (int key = 4010; key > -5; key -= 5)
+	{
+		ft::map<int, int>::iterator it = m1.lower_bound(hint, key);
+		std::map<int, int>::iterator it2 = m2.lower_bound(key);
+		same = same && (it == m1.end() ? it2 == m2.end() : it->first == it2->first);
+		if (it != m1.end())
+			hint = it;
+	}
+	check("lower_bound(hint) walking back", same);
+	same = true;
+	for (int i = 0; i < 500; i++)
+	{
+		int from = (i * 131) % 4001;
+		int key = (i * 577) % 4001;
+		ft::map<int, int>::iterator start = m1.lower_bound(m1.begin(), from);
+		std::map<int, int>::iterator it2 = m2.lower_bound(key);
+		same = same && m1.find(start, key) == m1.find(key);
+		same = same && (it2 == m2.end() ? m1.lower_bound(start, key) == m1.end() : m1.lower_bound(start, key)->first == it2->first);
+	}
+	check("hints far from the key", same);
+	ft::map<int, int> empty;
+	check("empty map", empty.find(empty.end(), 1) == empty.end() && empty.lower_bound(empty.begin(), 1) == empty.end());
+}
+
+/*
+** Value whose copies throw once a shared budget is spent.
+*/
+struct fragile
+{
+	static int budget;
+	int value;
+
+	fragile(int value = 0) : value(value) {}
+
+	fragile(const fragile &other) : value(other.value)
+	{
+		if (budget-- == 0)
+			throw std::runtime_error("fragile");
+	}
+};
+
+int fragile::budget = -1;
+
+/*
+** Batches small and large against the map, with keys already present and
+** repeated keys, then writes on the relinked tree.
+*/
+static void batch_insert(void)
+{
+	print_header("Batch insert");
+	ft::map<int, int> m1;
+	std::map<int, int> m2;
+	for (int i = 0; i < 1000; i++)
+	{
+		m1[i * 3] = i;
+		m2[i * 3] = i;
+	}
+	ft::vector<ft::pair<int, int> > small;
+	for (int i = 100; i < 110; i++)
+		small.push_back(ft::make_pair(i, -i));
+	check("small sorted batch", m1.insert_sorted_batch(small.begin(), small.end()) == 7 && m1[101] == -101 && m1[102] == 34);
+	for (int i = 100; i < 110; i++)
+		m2.insert(std::make_pair(i, -i));
+	ft::vector<ft::pair<int, int> > large;
+	for (int i = -50; i < 4000; i += 2)
+	{
+		large.push_back(ft::make_pair(i, i));
+		if (i % 10 == 0)
+			large.push_back(ft::make_pair(i, -1));
+	}
+	size_t before = m2.size();
+	for (size_t i = 0; i < large.size(); i++)
+		m2.insert(std::make_pair(large[i].first, large[i].second));
+	check("large sorted batch", m1.insert_sorted_batch(large.begin(), large.end()) == m2.size() - before);
+	bool same = m1.size() == m2.size();
+	std::map<int, int>::iterator it2 = m2.begin();
+	for (ft::map<int, int>::iterator it = m1.begin(); same && it != m1.end(); ++it, ++it2)
+		same = it->first == it2->first && it->second == it2->second;
+	std::map<int, int>::reverse_iterator rit2 = m2.rbegin();
+	for (ft::map<int, int>::reverse_iterator rit = m1.rbegin(); same && rit != m1.rend(); ++rit, ++rit2)
+		same = rit->first == rit2->first;
+	check("contents == m2", same);
+	for (int i = 0; i < 4000; i += 7)
+	{
+		m1.erase(i);
+		m2.erase(i);
+		m1[-i - 100] = i;
+		m2[-i - 100] = i;
+	}
+	same = m1.size() == m2.size();
+	it2 = m2.begin();
+	for (ft::map<int, int>::iterator it = m1.begin(); same && it != m1.end(); ++it, ++it2)
+		same = it->first == it2->first && it->second == it2->second && m1.find(it->first) == it;
+	check("writes after the batch", same);
+	int unsorted[8] = {9000, 5, 9001, 9000, 8999, 5, -9000, 9001};
+	ft::vector<ft::pair<int, int> > shuffled;
+	for (int i = 0; i < 8; i++)
+		shuffled.push_back(ft::make_pair(unsorted[i], i));
+	before = m1.size();
+	check("unsorted batch", m1.insert_batch(shuffled.begin(), shuffled.end()) == 5 && m1.size() == before + 5 && m1[9000] == 0 && m1[9001] == 2 && m1[5] == 1);
+	ft::map<int, int> empty;
+	check("batch into an empty map", empty.insert_batch(shuffled.begin(), shuffled.end()) == 5 && empty.begin()->first == -9000);
+	ft::map<int, int, std::greater<int> > greater;
+	ft::vector<ft::pair<int, int> > keys;
+	for (int i = 0; i < 1000; i++)
+		keys.push_back(ft::make_pair((i * 7919) % 1000, i));
+	greater[-1] = -1;
+	same = greater.insert_batch(keys.begin(), keys.end()) == 1000 && greater.size() == 1001;
+	int previous = -2;
+	for (ft::map<int, int, std::greater<int> >::iterator it = greater.begin(); same && it != greater.end(); ++it)
+	{
+		same = it->first > previous && greater.find(it->first) == it;
+		previous = it->first;
+	}
+	check("batch with a custom comparator", same && previous == 999);
+	ft::vector<ft::pair<int, fragile> > values;
+	for (int i = 0; i < 100; i++)
+		values.push_back(ft::make_pair(i, fragile(i)));
+	ft::map<int, fragile> failed;
+	bool thrown = false;
+	fragile::budget = 150;
+	try
+	{
+		failed.insert_sorted_batch(values.begin(), values.end());
+	}
+	catch (const std::runtime_error &e)
+	{
+		thrown = true;
+	}
+	fragile::budget = -1;
+	check("throwing batch into an empty map", thrown && failed.empty() && failed.insert_sorted_batch(values.begin(), values.end()) == 100);
+	ft::vector<ft::pair<int, fragile> > merged;
+	for (int i = 0; i < 1000; i++)
+		merged.push_back(ft::make_pair(i * 2 - 500, fragile(i)));
+	thrown = false;
+	fragile::budget = 300;
+	try
+	{
+		failed.insert_sorted_batch(merged.begin(), merged.end());
+	}
+	catch (const std::runtime_error &e)
+	{
+		thrown = true;
+	}
+	fragile::budget = -1;
+	same = failed.size() == 100;
+	int key = 0;
+	for (ft::map<int, fragile>::iterator it = failed.begin(); same && it != failed.end(); ++it, ++key)
+		same = it->first == key && it->second.value == key && failed.find(key) == it;
+	check("throwing batch merged into a map", thrown && same && key == 100 && failed.insert_sorted_batch(merged.begin(), merged.end()) == 950);
+}
+
+/*
+** compact() whose copies throw midway keeps the tree it had.
+*/
+static void throwing_compact(void)
+{
+	print_header("Throwing compact");
+	ft::map<int, fragile> m;
+	for (int i = 0; i < 100; i++)
+		m.insert(ft::make_pair(i, fragile(i)));
+	bool thrown = false;
+	fragile::budget = 50;
+	try
+	{
+		m.compact();
+	}
+	catch (const std::runtime_error &e)
+	{
+		thrown = true;
+	}
+	fragile::budget = -1;
+	bool same = m.size() == 100;
+	int key = 0;
+	for (ft::map<int, fragile>::iterator it = m.begin(); same && it != m.end(); ++it, ++key)
+		same = it->first == key && it->second.value == key && m.find(key) == it;
+	check("throwing compact() keeps the tree", thrown && same && key == 100);
+	m.compact();
+	check("compact() afterwards", m.size() == 100 && m.find(99)->second.value == 99);
+}
+
+/*
+** A rebuild whose copies throw keeps the map and reports it.
+*/
+static void failed_rebuild(void)
+{
+	print_header("Failed rebuild");
+	ft::map<int, fragile> m;
+	for (int i = 0; i < 100; i++)
+		m.insert(ft::make_pair(i, fragile(i)));
+	ft::map_rebuild<ft::map<int, fragile> > r(m);
+	bool thrown = false;
+	fragile::budget = 50;
+	r.start();
+	try
+	{
+		r.finish();
+	}
+	catch (const std::runtime_error &e)
+	{
+		thrown = true;
+	}
+	fragile::budget = -1;
+	bool same = m.size() == 100;
+	int key = 0;
+	for (ft::map<int, fragile>::iterator it = m.begin(); same && it != m.end(); ++it, ++key)
+		same = it->first == key && it->second.value == key;
+	check("finish() throws, the map is kept", thrown && same && key == 100 && !r.running());
+	r.start();
+	r.finish();
+	r.insert_or_assign(ft::make_pair(100, fragile(100)));
+	check("rebuild afterwards", m.size() == 101 && m.find(99)->second.value == 99 && m.find(100)->second.value == 100);
+}
+
+static bool is_multiple_of_100(const ft::pair<int, int> &value)
+{
+	return value.first % 100 == 0;
+}
+
+static bool has_odd_value(const ft::pair<int, int> &value)
+{
+	return value.second % 2 != 0;
+}
+
+static bool any_element(const ft::pair<int, int> &)
+{
+	return true;
+}
+
+/*
+** Chooses the odd keys, and throws once it has been called budget times.
+*/
+static int odd_key_budget;
+
+static bool has_odd_key_or_throws(const ft::pair<int, int> &value)
+{
+	if (odd_key_budget-- == 0)
+		throw std::runtime_error("has_odd_key_or_throws");
+	return value.first % 2 != 0;
+}
+
+static void bulk_erase(void)
+{
+	print_header("Bulk erase");
+	ft::map<int, int> m1;
+	std::map<int, int> m2;
+	for (int i = 0; i < 3000; i++)
+	{
+		m1[(i * 7919) % 3000] = i;
+		m2[(i * 7919) % 3000] = i;
+	}
+	check("few removed", ft::erase_if(m1, is_multiple_of_100) == 30 && m1.size() == 2970 && m1.count(200) == 0 && m1.count(201) == 1);
+	for (int i = 0; i < 3000; i += 100)
+		m2.erase(i);
+	size_t before = m2.size();
+	for (std::map<int, int>::iterator it = m2.begin(); it != m2.end();)
+	{
+		if (it->second % 2 != 0)
+			m2.erase(it++);
+		else
+			++it;
+	}
+	check("many removed", ft::erase_if(m1, has_odd_value) == before - m2.size());
+	bool same = m1.size() == m2.size();
+	std::map<int, int>::iterator it2 = m2.begin();
+	for (ft::map<int, int>::iterator it = m1.begin(); same && it != m1.end(); ++it, ++it2)
+		same = it->first == it2->first && it->second == it2->second && m1.find(it->first) == it;
+	std::map<int, int>::reverse_iterator rit2 = m2.rbegin();
+	for (ft::map<int, int>::reverse_iterator rit = m1.rbegin(); same && rit != m1.rend(); ++rit, ++rit2)
+		same = rit->first == rit2->first;
+	check("contents == m2", same);
+	for (int i = 0; i < 3000; i += 3)
+	{
+		m1[i] = 2;
+		m2[i] = 2;
+		m1.erase(i + 1);
+		m2.erase(i + 1);
+	}
+	same = m1.size() == m2.size();
+	it2 = m2.begin();
+	for (ft::map<int, int>::iterator it = m1.begin(); same && it != m1.end(); ++it, ++it2)
+		same = it->first == it2->first && it->second == it2->second;
+	check("writes after the erase", same);
+	check("none removed", ft::erase_if(m1, has_odd_value) == 0 && m1.size() == m2.size());
+	check("all removed", ft::erase_if(m1, any_element) == m2.size() && m1.empty() && m1.begin() == m1.end());
+	check("empty map", ft::erase_if(m1, any_element) == 0);
+	for (int budget = 10; budget <= 2500; budget += 2490)
+	{
+		for (int i = 0; i < 3000; i++)
+			m1[i] = i;
+		bool thrown = false;
+		odd_key_budget = budget;
+		try
+		{
+			ft::erase_if(m1, has_odd_key_or_throws);
+		}
+		catch (const std::runtime_error &e)
+		{
+			thrown = true;
+		}
+		same = m1.size() == static_cast<size_t>(3000 - budget / 2);
+		int key = 0;
+		for (ft::map<int, int>::iterator it = m1.begin(); same && it != m1.end(); ++it, key += key < budget ? 2 : 1)
+			same = it->first == key && m1.find(key) == it;
+		check(budget == 10 ? "throwing pred, few removed" : "throwing pred, many removed", thrown && same && key == 3000);
+		m1.clear();
+	}
+}
+
 void test_map(void)
 {
 	print_header("map");
@@ -282,8 +910,23 @@ void test_map(void)
 	swap();
 	clear();
 	find();
+	find_many();
 	count();
 	bounds();
 	range();
 	operators_comp();
+	iterators();
+	tree_policy<ft::map<int, int, std::less<int>, std::allocator<ft::pair<const int, int> >, ft::threaded_avl_tree<int, int> > >("Threaded tree");
+	tree_policy<ft::map<int, int, std::less<int>, std::allocator<ft::pair<const int, int> >, ft::parentless_avl_tree<int, int> > >("Parentless tree");
+	tree_policy<ft::map<int, int, std::less<int>, std::allocator<ft::pair<const int, int> >, ft::arena_avl_tree<int, int> > >("Arena tree");
+	compaction<ft::map<int, int> >("Compact");
+	rebuild();
+	compaction<ft::map<int, int, std::less<int>, std::allocator<ft::pair<const int, int> >, ft::arena_avl_tree<int, int> > >("Compact arena tree");
+	arena_limits();
+	prefix_nodes();
+	finger_search();
+	batch_insert();
+	throwing_compact();
+	failed_rebuild();
+	bulk_erase();
 }
\ No newline at end of file
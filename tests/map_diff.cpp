@@ -0,0 +1,80 @@
+#include "tests.hpp"
+
+typedef ft::map<int, int> int_map;
+
+/*
+** Records the keys reported by map_diff, in the order they come.
+*/
+struct changelog
+{
+	std::vector<int> added_keys;
+	std::vector<int> removed_keys;
+	std::vector<int> changed_keys;
+	bool values_ok;
+
+	changelog() : values_ok(true) {}
+
+	void added(const ft::pair<int, int> &value)
+	{
+		added_keys.push_back(value.first);
+		values_ok = values_ok && value.second == value.first;
+	}
+
+	void removed(const ft::pair<int, int> &value)
+	{
+		removed_keys.push_back(value.first);
+	}
+
+	void changed(const ft::pair<int, int> &before, const ft::pair<int, int> &after)
+	{
+		changed_keys.push_back(before.first);
+		values_ok = values_ok && before.first == after.first && before.second != after.second;
+	}
+};
+
+static bool sorted(const std::vector<int> &keys)
+{
+	for (size_t i = 1; i < keys.size(); i++)
+	{
+		if (!(keys[i - 1] < keys[i]))
+			return (false);
+	}
+	return (true);
+}
+
+static void diff(void)
+{
+	print_header("Diff");
+	int_map before;
+	for (int i = 0; i < 1000; i++)
+		before[i * 2] = i * 2;
+	int_map after(before);
+	changelog log = ft::map_diff(before, after, changelog());
+	check("equal maps", log.added_keys.empty() && log.removed_keys.empty() && log.changed_keys.empty());
+	for (int i = 0; i < 1000; i += 10)
+	{
+		after.erase(i * 2);
+		after[i * 2 + 1] = i * 2 + 1;
+		after[i * 2 + 6] = -1;
+	}
+	after[-5] = -5;
+	after[5000] = 5000;
+	log = ft::map_diff(before, after, changelog());
+	check("added", log.added_keys.size() == 102 && log.added_keys.front() == -5 && log.added_keys.back() == 5000);
+	check("removed", log.removed_keys.size() == 100 && log.removed_keys[1] == 20);
+	check("changed", log.changed_keys.size() == 100 && log.changed_keys[0] == 6);
+	check("in key order, values", log.values_ok && sorted(log.added_keys) && sorted(log.removed_keys) && sorted(log.changed_keys));
+	log = ft::map_diff(after, before, changelog());
+	check("reversed", log.added_keys.size() == 100 && log.removed_keys.size() == 102 && log.changed_keys.size() == 100);
+	int_map empty;
+	log = ft::map_diff(empty, before, changelog());
+	check("from an empty map", log.added_keys.size() == before.size() && log.removed_keys.empty());
+	log = ft::map_diff(before, empty, changelog());
+	check("to an empty map", log.removed_keys.size() == before.size() && log.added_keys.empty());
+}
+
+void test_map_diff(void)
+{
+	print_header("map_diff");
+	diff();
+}
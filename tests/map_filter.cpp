@@ -0,0 +1,53 @@
+#include "tests.hpp"
+
+typedef ft::map<long, long> long_map;
+
+static void bloom(void)
+{
+	print_header("Bloom filter");
+	ft::bloom_filter<long> filter(10000);
+	bool ok = true;
+	for (long i = 0; i < 10000; i++)
+		filter.insert(i * 3);
+	for (long i = 0; i < 10000; i++)
+		ok = ok && filter.may_contain(i * 3);
+	check("no false negatives", ok);
+	size_t positives = 0;
+	for (long i = 0; i < 100000; i++)
+		positives += filter.may_contain(i * 3 + 1 + 1000000);
+	check("false positives under 2%", positives < 2000);
+	filter.reset(10000);
+	check("reset() empties", !filter.may_contain(0) && !filter.may_contain(3));
+}
+
+static void filtered(void)
+{
+	print_header("Filtered map");
+	long_map m;
+	for (long i = 0; i < 1000; i++)
+		m[i * 2] = i;
+	ft::map_filter<long_map> f(m);
+	bool ok = true;
+	for (long i = 0; i < 2000; i++)
+		ok = ok && (f.find(i) == m.find(i)) && f.count(i) == m.count(i);
+	check("find() and count() == map", ok);
+	for (long i = 0; i < 20000; i++)
+		ok = ok && f.insert(ft::make_pair(i * 2 + 1, i)).second;
+	check("insert() grows the filter", ok && m.size() == 21000 && f.count(39999) == 1 && f.find(39999)->second == 19999);
+	for (long i = 0; i < 20000; i++)
+		ok = ok && f.erase(i * 2 + 1) == 1 && f.erase(i * 2 + 1) == 0;
+	check("erase()", ok && m.size() == 1000);
+	ok = true;
+	for (long i = 0; i < 2000; i++)
+		ok = ok && (f.find(i) == m.find(i)) && f.count(i) == m.count(i);
+	check("find() after erase()", ok && f.count(3) == 0);
+	f.clear();
+	check("clear()", m.empty() && f.find(0) == m.end());
+}
+
+void test_map_filter(void)
+{
+	print_header("map_filter");
+	bloom();
+	filtered();
+}
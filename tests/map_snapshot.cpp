@@ -0,0 +1,96 @@
+#include "tests.hpp"
+#include <cstdio>
+
+#define SNAPSHOT_PATH "map_snapshot.test"
+
+/*
+** Overwrites size bytes of the snapshot at offset with data, then updates
+** its checksum, as another writer would produce the file.
+*/
+static bool rewrite(long offset, const void *data, size_t size)
+{
+	std::FILE *file = std::fopen(SNAPSHOT_PATH, "r+b");
+	ft::snapshot_header header;
+	ft::snapshot_checksum checksum;
+	std::string records;
+	int c;
+
+	if (file == NULL)
+		return (false);
+	std::fseek(file, offset, SEEK_SET);
+	std::fwrite(data, 1, size, file);
+	std::fseek(file, 0, SEEK_SET);
+	if (std::fread(&header, sizeof(header), 1, file) != 1)
+		return (std::fclose(file), false);
+	while ((c = std::fgetc(file)) != EOF)
+		records += static_cast<char>(c);
+	checksum.update(records.data(), records.size());
+	header.checksum = checksum.value();
+	std::fseek(file, 0, SEEK_SET);
+	std::fwrite(&header, sizeof(header), 1, file);
+	return (std::fclose(file) == 0);
+}
+
+static void raw_records(void)
+{
+	print_header("Raw records");
+	ft::map<long, int> m;
+	for (long i = 0; i < 5000; i++)
+		m[(i * 7919) % 5000 - 2500] = static_cast<int>(i);
+	check("save", ft::save_snapshot(m, SNAPSHOT_PATH));
+	ft::map<long, int> loaded;
+	loaded[123456] = 1;
+	check("load", ft::load_snapshot(loaded, SNAPSHOT_PATH));
+	check("loaded == saved", loaded == m && loaded.size() == 5000 && loaded.count(123456) == 0);
+	bool ok = true;
+	for (long i = -2500; i < 2500; i += 13)
+		ok = ok && loaded.find(i) != loaded.end() && loaded.find(i)->second == m[i];
+	check("find() after load", ok);
+	loaded[9999] = 1;
+	loaded.erase(-2500);
+	check("writes after load", loaded.size() == 5000 && loaded.begin()->first == -2499 && (--loaded.end())->first == 9999);
+	ft::map<long, long> other;
+	check("other types rejected", !ft::load_snapshot(other, SNAPSHOT_PATH) && other.empty());
+	std::FILE *file = std::fopen(SNAPSHOT_PATH, "r+b");
+	std::fseek(file, 1000, SEEK_SET);
+	std::fputc(std::fgetc(file) ^ 0x10, file);
+	std::fclose(file);
+	check("corruption rejected", !ft::load_snapshot(loaded, SNAPSHOT_PATH) && loaded.size() == 5000 && loaded.count(9999) == 1);
+	std::remove(SNAPSHOT_PATH);
+	check("missing file", !ft::load_snapshot(loaded, SNAPSHOT_PATH) && loaded.size() == 5000);
+}
+
+static void string_records(void)
+{
+	print_header("String records");
+	ft::map<std::string, std::string> m;
+	for (int i = 0; i < 2000; i++)
+		m[std::string(i % 17, 'k') + static_cast<char>('a' + i % 26) + std::string(1, static_cast<char>('0' + i % 10))] = std::string(i % 7 * 100, 'v');
+	m[""] = "empty key";
+	check("save", ft::save_snapshot(m, SNAPSHOT_PATH));
+	ft::map<std::string, std::string> loaded;
+	check("load", ft::load_snapshot(loaded, SNAPSHOT_PATH));
+	check("loaded == saved", loaded == m && loaded[""] == "empty key");
+	ft::map<std::string, std::string> empty;
+	check("empty map", ft::save_snapshot(empty, SNAPSHOT_PATH) && ft::load_snapshot(loaded, SNAPSHOT_PATH) && loaded.empty());
+	ft::map<std::string, std::string> one;
+	one["key"] = "value";
+	ft::save_snapshot(one, SNAPSHOT_PATH);
+	unsigned long long length = 1ULL << 40;
+	check("length past the end rejected", rewrite(sizeof(ft::snapshot_header), &length, sizeof(length)) && !ft::load_snapshot(loaded, SNAPSHOT_PATH) && loaded.empty());
+	ft::save_snapshot(one, SNAPSHOT_PATH);
+	ft::snapshot_header header;
+	std::FILE *file = std::fopen(SNAPSHOT_PATH, "rb");
+	check("header read", std::fread(&header, sizeof(header), 1, file) == 1);
+	std::fclose(file);
+	header.count++;
+	check("wrong count rejected", rewrite(0, &header, sizeof(header)) && !ft::load_snapshot(loaded, SNAPSHOT_PATH) && loaded.empty());
+	std::remove(SNAPSHOT_PATH);
+}
+
+void test_map_snapshot(void)
+{
+	print_header("map_snapshot");
+	raw_records();
+	string_records();
+}
@@ -0,0 +1,92 @@
+#include "tests.hpp"
+#include <cstdio>
+
+#define MMAP_PATH "mmap_map.test"
+
+typedef ft::mmap_map<long, int> long_mmap;
+
+/*
+** Compares the contents of m, in order, with those of reference.
+*/
+static bool same(const long_mmap &m, const std::map<long, int> &reference)
+{
+	long_mmap::const_iterator it = m.begin();
+
+	if (m.size() != reference.size())
+		return (false);
+	for (std::map<long, int>::const_iterator ref = reference.begin(); ref != reference.end(); ++ref, ++it)
+	{
+		if (it == m.end() || it->first != ref->first || it->second != ref->second)
+			return (false);
+	}
+	return (it == m.end());
+}
+
+static void persistence(void)
+{
+	print_header("Persistence");
+	std::remove(MMAP_PATH);
+	std::map<long, int> reference;
+	long_mmap m(MMAP_PATH);
+	check("open a new file", m.is_open() && m.empty());
+	for (long i = 0; i < 100000; i++)
+	{
+		long key = (i * 7919) % 100000 - 50000;
+		m[key] = static_cast<int>(i);
+		reference[key] = static_cast<int>(i);
+	}
+	for (long i = -50000; i < 50000; i += 3)
+	{
+		m.erase(i);
+		reference.erase(i);
+	}
+	for (long i = 0; i < 1000; i++)
+	{
+		m.insert(ft::make_pair(i * 1000 + 7, -1));
+		reference.insert(std::make_pair(i * 1000 + 7, -1));
+	}
+	check("grows past its first chunks", same(m, reference));
+	check("checkpoint", m.checkpoint() && m.close() && !m.is_open() && m.empty());
+	long_mmap reopened(MMAP_PATH);
+	check("reopen", reopened.is_open() && same(reopened, reference));
+	check("find() after reopen", reopened.find(-49999)->second == reference[-49999] && reopened.count(-50000) == 0 && reopened.find(-50000) == reopened.end());
+	check("lower_bound()", reopened.lower_bound(-50000)->first == -49999 && reopened.lower_bound(999007)->first == 999007 && reopened.lower_bound(999008) == reopened.end());
+	reopened.clear();
+	reopened[42] = 42;
+	reopened.close();
+	check("clear() and reopen", reopened.open(MMAP_PATH) && reopened.size() == 1 && reopened.begin()->second == 42);
+}
+
+static void refused_files(void)
+{
+	print_header("Refused files");
+	long_mmap writer(MMAP_PATH);
+	long_mmap reader;
+	writer[7] = 7;
+	check("changed after its checkpoint", !reader.open(MMAP_PATH) && !reader.is_open());
+	writer.checkpoint();
+	check("checkpointed again", reader.open(MMAP_PATH) && reader.size() == 2 && reader.find(7)->second == 7);
+	reader.close();
+	long sum = writer.find(7)->second + writer.begin()->second + writer.lower_bound(8)->second;
+	check("lookups leave it unchanged", sum == 56 && reader.open(MMAP_PATH));
+	reader.close();
+	writer[42] = 0;
+	check("assigned after its checkpoint", !reader.open(MMAP_PATH));
+	writer.checkpoint();
+	writer.close();
+	ft::mmap_map<long, long> other;
+	check("other types", !other.open(MMAP_PATH) && !other.is_open());
+	std::FILE *file = std::fopen(MMAP_PATH, "r+b");
+	std::fputc('X', file);
+	std::fclose(file);
+	check("bad magic", !reader.open(MMAP_PATH));
+	std::remove(MMAP_PATH);
+	check("missing directory", !reader.open("missing/" MMAP_PATH));
+}
+
+void test_mmap_map(void)
+{
+	print_header("mmap_map");
+	persistence();
+	refused_files();
+}
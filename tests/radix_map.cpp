@@ -0,0 +1,110 @@
+#include "tests.hpp"
+#include <string>
+
+typedef ft::radix_map<std::string, int> string_map;
+
+static bool same_contents(const string_map &m, const std::map<std::string, int> &ref)
+{
+	std::map<std::string, int>::const_iterator it2 = ref.begin();
+
+	if (m.size() != ref.size())
+		return (false);
+	for (string_map::const_iterator it = m.begin(); it != m.end(); ++it, ++it2)
+		if (it->first != it2->first || it->second != it2->second)
+			return (false);
+	return (true);
+}
+
+static bool same_bound(const string_map &m, const std::map<std::string, int> &ref, const std::string &key)
+{
+	string_map::iterator it = m.lower_bound(key);
+	std::map<std::string, int>::const_iterator it2 = ref.lower_bound(key);
+
+	if ((it == m.end()) != (it2 == ref.end()))
+		return (false);
+	return (it == m.end() || it->first == it2->first);
+}
+
+/*
+** Paths sharing long prefixes, keys that are prefixes of other keys, the
+** empty key and bytes above 0x7f.
+*/
+static std::string path(unsigned long x)
+{
+	static const char *segments[6] = {"api/v1/", "api/v2/", "static/", "metrics.cpu.", "metrics.cpu.user.", "\xff\xfe"};
+	std::string result(segments[x % 6]);
+
+	x /= 6;
+	while (x % 4)
+	{
+		result += static_cast<char>('a' + x % 5);
+		result += (x % 7 == 0) ? "/very/long/shared/segment/" : "/";
+		x /= 4;
+	}
+	if (x % 3 == 0)
+		result.erase(result.size() - 1);
+	return (result);
+}
+
+static void paths(void)
+{
+	print_header("Paths");
+	string_map m;
+	std::map<std::string, int> ref;
+	unsigned long x = 88172645463325252UL;
+	bool ok = true;
+	for (int i = 0; i < 20000; i++)
+	{
+		x ^= x << 13;
+		x ^= x >> 7;
+		x ^= x << 17;
+		std::string key = path(x % 100000);
+		ok = ok && m.insert(ft::make_pair(key, i)).second == ref.insert(std::make_pair(key, i)).second;
+	}
+	m[""] = -1;
+	ref[""] = -1;
+	check("insert() matches std::map", ok && same_contents(m, ref));
+	check("find() and count()", m.find("api/v1")->second == ref["api/v1"] && m.find("api/v1/zz") == m.end() && m.count("") == 1);
+	ok = true;
+	for (std::map<std::string, int>::iterator it = ref.begin(); it != ref.end(); ++it)
+		ok = ok && same_bound(m, ref, it->first) && same_bound(m, ref, it->first + "0") && same_bound(m, ref, it->first.substr(0, it->first.size() / 2));
+	check("lower_bound()", ok && same_bound(m, ref, "\xff\xff") && same_bound(m, ref, "metrics.cpu.zz"));
+	std::string prefixes[5] = {"api/v1/", "metrics.cpu.", "metrics.cpu.user.b/very/", "\xff", "nothing"};
+	for (int p = 0; p < 5; p++)
+	{
+		ft::pair<string_map::iterator, string_map::iterator> range = m.prefix_range(prefixes[p]);
+		size_t expected = 0;
+		size_t found = 0;
+		for (std::map<std::string, int>::iterator it = ref.begin(); it != ref.end(); ++it)
+			expected += it->first.compare(0, prefixes[p].size(), prefixes[p]) == 0;
+		for (; range.first != range.second; ++range.first)
+			found += range.first->first.compare(0, prefixes[p].size(), prefixes[p]) == 0 ? 1 : 1000000;
+		ok = ok && found == expected;
+	}
+	check("prefix_range()", ok && m.prefix_range("").first == m.begin() && m.prefix_range("").second == m.end());
+	size_t i = 0;
+	for (std::map<std::string, int>::iterator it = ref.begin(); it != ref.end(); i++)
+	{
+		if (i % 3)
+		{
+			++it;
+			continue;
+		}
+		ok = ok && m.erase(it->first) == 1;
+		ref.erase(it++);
+	}
+	check("erase() matches std::map", ok && m.erase("api/v1/zz") == 0 && same_contents(m, ref));
+	ok = true;
+	for (std::map<std::string, int>::iterator it = ref.begin(); it != ref.end(); ++it)
+		ok = ok && m.find(it->first)->second == it->second && same_bound(m, ref, it->first + "0");
+	check("find() after erase()", ok);
+	string_map copy(m);
+	m.clear();
+	check("copy and clear()", m.empty() && m.begin() == m.end() && same_contents(copy, ref));
+}
+
+void test_radix_map(void)
+{
+	print_header("radix_map");
+	paths();
+}
@@ -0,0 +1,120 @@
+#include "tests.hpp"
+#include <pthread.h>
+
+static void insert_find(void)
+{
+	print_header("Insert / Find / Erase");
+	ft::skiplist_map<int, int> m1;
+	std::map<int, int> m2;
+	for (int i = 0; i < 100; i++)
+	{
+		m1.insert(ft::make_pair((i * 37) % 101, i));
+		m2.insert(std::make_pair((i * 37) % 101, i));
+	}
+	check("m1.size() == m2.size()", m1.size(), m2.size());
+	check("m1.find(37) == m2.find(37)", m1.find(37)->second, m2.find(37)->second);
+	check("m1.find(101) == end()", m1.find(101) == m1.end());
+	check("m1.insert(37).second == false", m1.insert(ft::make_pair(37, 0)).second == false);
+	for (int i = 0; i < 101; i += 3)
+	{
+		m1.erase(i);
+		m2.erase(i);
+	}
+	check("m1.size() == m2.size()", m1.size(), m2.size());
+	check("m1.count(3) == m2.count(3)", m1.count(3), m2.count(3));
+	check("m1.count(4) == m2.count(4)", m1.count(4), m2.count(4));
+	bool same = true;
+	std::map<int, int>::iterator it2 = m2.begin();
+	for (ft::skiplist_map<int, int>::iterator it = m1.begin(); same && it != m1.end(); ++it, ++it2)
+		same = it2 != m2.end() && it->first == it2->first && it->second == it2->second;
+	check("ordered iteration == m2", same && it2 == m2.end());
+}
+
+static void bounds(void)
+{
+	print_header("Bounds");
+	ft::skiplist_map<std::string, int> m1;
+	std::map<std::string, int> m2;
+	m1.insert(ft::make_pair(std::string("a"), 1));
+	m1.insert(ft::make_pair(std::string("c"), 3));
+	m1.insert(ft::make_pair(std::string("e"), 5));
+	m2["a"] = 1;
+	m2["c"] = 3;
+	m2["e"] = 5;
+	check("lower_bound('b')", m1.lower_bound("b")->first, m2.lower_bound("b")->first);
+	check("lower_bound('c')", m1.lower_bound("c")->first, m2.lower_bound("c")->first);
+	check("upper_bound('c')", m1.upper_bound("c")->first, m2.upper_bound("c")->first);
+	check("upper_bound('e') == end()", m1.upper_bound("e") == m1.end());
+}
+
+struct writer_args
+{
+	ft::skiplist_map<int, int> *map;
+	int first;
+};
+
+static void *writer(void *arg)
+{
+	writer_args *w = static_cast<writer_args *>(arg);
+	for (int i = 0; i < 5000; i++)
+		w->map->insert(ft::make_pair(w->first + i * 4, i));
+	for (int i = 0; i < 5000; i += 2)
+		w->map->erase(w->first + i * 4);
+	return (NULL);
+}
+
+static void threads(void)
+{
+	print_header("Threads");
+	ft::skiplist_map<int, int> m;
+	pthread_t ids[4];
+	writer_args args[4];
+	for (int i = 0; i < 4; i++)
+	{
+		args[i].map = &m;
+		args[i].first = i;
+		pthread_create(&ids[i], NULL, &writer, &args[i]);
+	}
+	for (int i = 0; i < 4; i++)
+		pthread_join(ids[i], NULL);
+	size_t n = 0;
+	int previous = -1;
+	bool sorted = true;
+	for (ft::skiplist_map<int, int>::iterator it = m.begin(); it != m.end(); ++it, ++n)
+	{
+		sorted = sorted && it->first > previous && (it->first / 4) % 2 == 1;
+		previous = it->first;
+	}
+	check("concurrent writers: size", m.size() == 10000 && n == 10000);
+	check("concurrent writers: order", sorted);
+}
+
+/*
+** More maps alive at once than a process has thread-specific keys, each with
+** elements retired and still pending when it is destroyed.
+*/
+static void many_maps(void)
+{
+	print_header("Many maps");
+	ft::skiplist_map<int, int> *maps = new ft::skiplist_map<int, int>[2000];
+	bool found = true;
+	for (int i = 0; i < 2000; i++)
+	{
+		maps[i].insert(ft::make_pair(i, i));
+		maps[i].insert(ft::make_pair(i + 1, i));
+		maps[i].erase(i);
+	}
+	for (int i = 0; i < 2000; i++)
+		found = found && maps[i].size() == 1 && maps[i].find(i + 1)->second == i;
+	delete[] maps;
+	check("2000 maps", found);
+}
+
+void test_skiplist_map(void)
+{
+	print_header("skiplist_map");
+	insert_find();
+	bounds();
+	threads();
+	many_maps();
+}
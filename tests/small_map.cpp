@@ -0,0 +1,104 @@
+#include "tests.hpp"
+#include <string>
+
+typedef ft::small_map<int, std::string, 8> small;
+
+static bool same_contents(const small &s, const std::map<int, std::string> &m)
+{
+	std::map<int, std::string>::const_iterator it2 = m.begin();
+
+	if (s.size() != m.size())
+		return (false);
+	for (small::const_iterator it = s.begin(); it != s.end(); ++it, ++it2)
+		if (it->first != it2->first || it->second != it2->second)
+			return (false);
+	return (true);
+}
+
+static void inline_storage(void)
+{
+	print_header("Inline");
+	small s;
+	std::map<int, std::string> m;
+	int keys[8] = {5, 1, 7, 3, 8, 2, 6, 4};
+	for (int i = 0; i < 8; i++)
+	{
+		s[keys[i]] = std::string(i + 1, 'a');
+		m[keys[i]] = std::string(i + 1, 'a');
+	}
+	check("8 keys stay inline", s.is_inline() && same_contents(s, m));
+	check("insert() existing key", s.insert(ft::make_pair(3, std::string("x"))).second == false && s.at(3) == m[3]);
+	check("find() and count()", s.find(6)->second == m[6] && s.find(9) == s.end() && s.count(1) == 1);
+	check("lower_bound() / upper_bound()", s.lower_bound(4)->first == 4 && s.upper_bound(4)->first == 5 && s.upper_bound(8) == s.end());
+	check("erase()", s.erase(3) == 1 && s.erase(3) == 0 && m.erase(3) == 1 && same_contents(s, m));
+	check("reverse scan", s.rbegin()->first == 8 && (--s.rend())->first == 1);
+	small copy(s);
+	check("copy", copy.is_inline() && same_contents(copy, m));
+}
+
+static void spill(void)
+{
+	print_header("Spill");
+	small s;
+	std::map<int, std::string> m;
+	for (int i = 0; i < 40; i++)
+	{
+		int key = (i * 17) % 41;
+		s[key] = std::string(i % 5 + 1, 'b');
+		m[key] = std::string(i % 5 + 1, 'b');
+	}
+	check("spills past N", !s.is_inline() && same_contents(s, m));
+	check("find() after spill", s.find(17)->second == m[17] && s.find(-1) == s.end());
+	for (int i = 0; i < 41; i += 2)
+	{
+		s.erase(i);
+		m.erase(i);
+	}
+	check("erase() after spill", same_contents(s, m));
+	small other;
+	other[100] = "c";
+	other.swap(s);
+	check("swap()", s.size() == 1 && s.is_inline() && same_contents(other, m));
+	small inline_other;
+	inline_other[1] = "d";
+	inline_other[2] = "e";
+	inline_other[3] = "f";
+	s.swap(inline_other);
+	check("swap() inline", s.size() == 3 && s.at(2) == "e" && inline_other.size() == 1 && inline_other.at(100) == "c");
+	inline_other.swap(s);
+	check("swap() back", s.size() == 1 && s.at(100) == "c" && inline_other.size() == 3 && inline_other.begin()->second == "d");
+	other.clear();
+	check("clear() goes back inline", other.empty() && other.is_inline() && other.begin() == other.end());
+	try
+	{
+		other.at(1);
+		check("at() throws", false);
+	}
+	catch (const std::out_of_range &e)
+	{
+		check("at() throws", true);
+	}
+}
+
+static void bounds(void)
+{
+	print_header("Bounds");
+	ft::small_map<int, int, 4> s;
+	for (int i = 0; i < 4; i++)
+		s[i * 2] = i;
+	check("inline bounds", s.is_inline() && s.lower_bound(3)->first == 4 && s.upper_bound(4)->first == 6 && s.lower_bound(7) == s.end() && s.equal_range(2).first->first == 2);
+	s[8] = 4;
+	check("spilled bounds", !s.is_inline() && s.begin()->first == 0 && s.lower_bound(3)->first == 4 && s.upper_bound(4)->first == 6 && s.upper_bound(8) == s.end() && s.equal_range(2).second->first == 4);
+	ft::small_map<int, int, 4> other;
+	other[9] = 9;
+	other.swap(s);
+	check("swap() keeps the bounds", s.is_inline() && s.lower_bound(1)->first == 9 && other.size() == 5 && other.lower_bound(5)->first == 6 && other.lower_bound(-1) == other.begin());
+}
+
+void test_small_map(void)
+{
+	print_header("small_map");
+	inline_storage();
+	spill();
+	bounds();
+}
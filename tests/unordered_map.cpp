@@ -0,0 +1,158 @@
+#include "tests.hpp"
+#include <sstream>
+#include <stdexcept>
+
+static void insert_find(void)
+{
+	print_header("Insert / Find / Erase");
+	ft::unordered_map<int, int> m1;
+	std::map<int, int> m2;
+	for (int i = 0; i < 1000; i++)
+	{
+		m1.insert(ft::make_pair((i * 37) % 1009, i));
+		m2.insert(std::make_pair((i * 37) % 1009, i));
+	}
+	check("m1.size() == m2.size()", m1.size(), m2.size());
+	check("m1.find(37) == m2.find(37)", m1.find(37)->second, m2.find(37)->second);
+	check("m1.find(1008) == end()", m1.find(1008) == m1.end(), m2.find(1008) == m2.end());
+	check("m1.insert(37).second == false", m1.insert(ft::make_pair(37, 0)).second == false);
+	m1[37] = -1;
+	m2[37] = -1;
+	check("m1[37] == m2[37]", m1[37], m2[37]);
+	check("m1.at(37) == m2.at(37)", m1.at(37), m2.at(37));
+	for (int i = 0; i < 1009; i += 3)
+	{
+		m1.erase(i);
+		m2.erase(i);
+	}
+	check("m1.size() == m2.size()", m1.size(), m2.size());
+	check("m1.count(3) == m2.count(3)", m1.count(3), m2.count(3));
+	check("m1.count(4) == m2.count(4)", m1.count(4), m2.count(4));
+	bool same = true;
+	size_t n = 0;
+	for (ft::unordered_map<int, int>::iterator it = m1.begin(); it != m1.end(); ++it, ++n)
+		same = same && m2.count(it->first) && m2[it->first] == it->second;
+	check("iteration matches m2", same && n == m2.size());
+	check("load_factor() <= 7/8", m1.load_factor() <= m1.max_load_factor());
+}
+
+static void churn(void)
+{
+	print_header("Churn");
+	ft::unordered_map<std::string, int> m1;
+	std::map<std::string, int> m2;
+	for (int i = 0; i < 20000; i++)
+	{
+		std::ostringstream key;
+		key << "key" << (i * 7919) % 500;
+		if (i % 3 == 2)
+		{
+			m1.erase(key.str());
+			m2.erase(key.str());
+		}
+		else
+		{
+			m1[key.str()] = i;
+			m2[key.str()] = i;
+		}
+	}
+	check("m1.size() == m2.size()", m1.size(), m2.size());
+	bool same = true;
+	for (std::map<std::string, int>::iterator it = m2.begin(); it != m2.end(); ++it)
+		same = same && m1.count(it->first) && m1.at(it->first) == it->second;
+	check("m1 holds m2", same);
+	check("bucket_count() did not blow up", m1.bucket_count() <= 2048);
+	try
+	{
+		m1.at("missing");
+		check("at() throws", false);
+	}
+	catch (const std::out_of_range &)
+	{
+		check("at() throws", true);
+	}
+}
+
+static void copy_swap(void)
+{
+	print_header("Copy / Swap");
+	ft::unordered_map<int, int> m1;
+	for (int i = 0; i < 100; i++)
+		m1[i] = i * i;
+	ft::unordered_map<int, int> m2(m1);
+	check("copy == original", m2 == m1);
+	m2.erase(m2.find(5));
+	check("copy != original", m2 != m1);
+	ft::unordered_map<int, int> m3;
+	m3.swap(m2);
+	check("swap()", m2.empty() && m3.size() == 99);
+	m3.clear();
+	check("clear()", m3.empty() && m3.begin() == m3.end());
+	m3.reserve(1000);
+	check("reserve(1000)", m3.bucket_count() * 7 / 8 >= 1000);
+}
+
+/*
+** Value owning a string, whose copies throw once a shared budget is spent.
+*/
+struct fragile_value
+{
+	static int budget;
+	std::string text;
+
+	fragile_value(const std::string &text = "") : text(text) {}
+
+	fragile_value(const fragile_value &other) : text(other.text)
+	{
+		if (budget-- == 0)
+			throw std::runtime_error("fragile_value");
+	}
+};
+
+int fragile_value::budget = -1;
+
+static void throwing_copies(void)
+{
+	print_header("Throwing copies");
+	ft::unordered_map<int, fragile_value> m;
+	fragile_value value(std::string(100, 'v'));
+	bool thrown = false;
+	fragile_value::budget = 0;
+	try
+	{
+		m.insert(ft::make_pair(1, value));
+	}
+	catch (const std::runtime_error &e)
+	{
+		thrown = true;
+	}
+	check("insert() leaves no element", thrown && m.size() == 0 && m.count(1) == 0 && m.begin() == m.end());
+	fragile_value::budget = -1;
+	for (int i = 0; i < 50; i++)
+		m.insert(ft::make_pair(i, value));
+	size_t buckets = m.bucket_count();
+	thrown = false;
+	fragile_value::budget = 20;
+	try
+	{
+		m.reserve(1000);
+	}
+	catch (const std::runtime_error &e)
+	{
+		thrown = true;
+	}
+	fragile_value::budget = -1;
+	bool intact = m.bucket_count() == buckets;
+	for (int i = 0; i < 50; i++)
+		intact = intact && m.find(i) != m.end() && m.find(i)->second.text == value.text;
+	check("growth leaves the table as it was", thrown && intact && m.size() == 50);
+}
+
+void test_unordered_map(void)
+{
+	print_header("unordered_map");
+	insert_find();
+	churn();
+	copy_swap();
+	throwing_copies();
+}